@@ -0,0 +1,113 @@
+#include "common.h"
+
+#include "animations.h"
+
+//a block of animated sprites; unused slots are kept zeroed
+typedef struct {
+	SpriteAnimated sprites[ANIMATION_BLOCK_SIZE];
+	bool used[ANIMATION_BLOCK_SIZE];
+	int usedCount;
+} AnimationBlock;
+
+SpriteAnimated *allocSpriteAnimated(void);
+void updateAnimations(void);
+static void advanceAnimation(SpriteAnimated *sprite);
+void deleteSpriteAnimated(SpriteAnimated *sprite);
+void deleteAnimations(void);
+
+static AnimationBlock *blocks[MAX_ANIMATION_BLOCKS];
+static int blockCount = 0;
+
+//gets a zeroed animated sprite from the pool
+//if the pool is full, the sprite is allocated on its own, and won't animate
+SpriteAnimated *allocSpriteAnimated(void) {
+	//find a block with room in it
+	int b = 0;
+	while (b < blockCount && blocks[b]->usedCount >= ANIMATION_BLOCK_SIZE)
+		++b;
+
+	if (b == blockCount) {
+		if (blockCount >= MAX_ANIMATION_BLOCKS || (blocks[blockCount] = calloc(1, sizeof(AnimationBlock))) == NULL) {
+			printf("WARNING - Out of room for animated sprites. Raise MAX_ANIMATION_BLOCKS.\n");
+			return calloc(1, sizeof(SpriteAnimated));
+		}
+		++blockCount;
+	}
+
+	AnimationBlock *block = blocks[b];
+	for (int i = 0; i < ANIMATION_BLOCK_SIZE; ++i) {
+		if (!block->used[i]) {
+			block->used[i] = true;
+			++block->usedCount;
+			return &block->sprites[i];
+		}
+	}
+
+	return NULL;	//unreachable; the block had room
+}
+
+//advances every animated sprite by one tick
+//call once per logic tick, before anything looks at the animations
+void updateAnimations(void) {
+	for (int b = 0; b < blockCount; ++b) {
+		//unused slots have a speed of 0, so there's no need to check which ones are used
+		for (int i = 0; i < ANIMATION_BLOCK_SIZE; ++i) {
+			if (blocks[b]->sprites[i].spd != 0)
+				advanceAnimation(&blocks[b]->sprites[i]);
+		}
+	}
+}
+
+//progresses an animation by its speed, then applies its loop behavior
+static void advanceAnimation(SpriteAnimated *sprite) {
+	sprite->currentFrame += sprite->spd;
+
+	if (sprite->currentFrame >= sprite->frames || sprite->currentFrame < 0) {
+		switch (sprite->loopBehavior) {
+		case(AL_ONESHOT):
+			//lock animation on the last frame
+			sprite->currentFrame = sprite->frames - 1;
+			break;
+		case(AL_LOOP):
+			//go back to start of animation
+			sprite->currentFrame = 0;
+			break;
+		case(AL_BACK_AND_FORTH):
+			sprite->currentFrame -= sprite->spd;	//make sure currentFrame stays within the bounds of the current animation
+			sprite->spd = -sprite->spd;	//negate speed, inverting animation direction
+			break;
+		}
+	}
+}
+
+//gives an animated sprite back to the pool
+//does nothing if sprite is NULL
+void deleteSpriteAnimated(SpriteAnimated *sprite) {
+	if (sprite == NULL)
+		return;
+
+	for (int b = 0; b < blockCount; ++b) {
+		AnimationBlock *block = blocks[b];
+
+		if (sprite >= block->sprites && sprite < block->sprites + ANIMATION_BLOCK_SIZE) {
+			int i = sprite - block->sprites;
+			memset(sprite, 0, sizeof(SpriteAnimated));
+			block->used[i] = false;
+			--block->usedCount;
+			return;
+		}
+	}
+
+	//allocated on its own because the pool was full
+	free(sprite);
+}
+
+//frees the whole pool; any animated sprites still around are gone after this
+void deleteAnimations(void) {
+	for (int b = 0; b < blockCount; ++b) {
+		free(blocks[b]);
+		blocks[b] = NULL;
+	}
+
+	blockCount = 0;
+}
\ No newline at end of file
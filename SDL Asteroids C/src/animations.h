@@ -0,0 +1,24 @@
+#ifndef ANIMATIONS_H
+#define ANIMATIONS_H
+
+#include "draw.h"
+
+/*
+* Every animated sprite lives in a pool here, in blocks that sit next to each other in memory,
+* so that all animations can be advanced in one pass at the start of each logic tick (see main.c).
+* Drawing an animated sprite never changes it; anything that needs to react to where an animation is (e.g. deleting a particle once its animation ends)
+* should check that in logic.
+* Animated sprites come from initSpriteAnimated and friends in draw.h; free them with deleteSpriteAnimated, not free().
+*/
+
+//animated sprites are allocated in blocks of this many
+#define ANIMATION_BLOCK_SIZE 256
+//max number of blocks (so there can be up to ANIMATION_BLOCK_SIZE * MAX_ANIMATION_BLOCKS animated sprites at once)
+#define MAX_ANIMATION_BLOCKS 64
+
+SpriteAnimated *allocSpriteAnimated(void);
+void updateAnimations(void);
+void deleteSpriteAnimated(SpriteAnimated *sprite);
+void deleteAnimations(void);
+
+#endif
\ No newline at end of file
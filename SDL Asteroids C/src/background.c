@@ -1,6 +1,13 @@
 #include "common.h"
 
+//SSE2 is always there on x64, and on x86 when it's enabled in the compiler settings
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BACKGROUND_USE_SSE2
+#endif
+
 #include "background.h"
+#include "postProcess.h"
 #include "stage.h"
 
 extern App app;
@@ -8,9 +15,27 @@ extern Stage stage;
 extern Background background;
 
 void initBackground(void);
+void setStarLayers(const StarLayerSettings *settings, int numLayers);
+static void updateStarLayer(StarLayer *layer);
+static void addAndWrap(float *values, const float *perValueDeltas, float delta, float range, int count);
+static void drawStarLayer(const StarLayer *layer);
+static void deleteStarLayers(void);
+void updateBackground(void);
 void drawBackground(void);
 void deleteBackground(void);
 
+//star variants are SPR_STAR_1 to SPR_STAR_6 in the sprite table, all with the same number of frames
+static const int STAR_VARIANTS = 6;
+static const int STAR_FRAMES = 4;
+
+//default star layers, from furthest to closest
+//closer ones are brighter, blink faster and scroll faster
+static const StarLayerSettings DEFAULT_STAR_LAYERS[] = {
+	{ 50, 63, 0.005, 0.01, -0.05, 0 },
+	{ 50, 127, 0.01, 0.025, -0.1, 0 },
+	{ 50, 255, 0.025, 0.05, -0.2, 0 }
+};
+
 SDL_Rect screenRect = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };	//a rectangle covering the screen for drawing backgrounds to
 
 void initBackground(void) {
@@ -19,72 +44,199 @@ void initBackground(void) {
 	background.backgroundFlashWhiteTimer = END_OF_FLASH * 3;
 
 	//initalize planet
-	background.planet = initParticle(initSpriteAnimated(app.gameplaySprites, 8, 0, 5, 5, SC_CENTER, 1, 0, 0, AL_ONESHOT), randFloat(SCREEN_WIDTH), randFloat(SCREEN_HEIGHT), 0, 0, 0, 1, NULL, NULL);
+	background.planet = initParticle(initSpriteAnimatedFromTable(SPR_PLANET, 0), randFloat(SCREEN_WIDTH), randFloat(SCREEN_HEIGHT), 0, 0, 0, 1, NULL, NULL);
 
-	//init 3 layers of stars
-	//closer ones blink faster, further ones blink slower
-	for (int i = 0; i < NUM_BACKGROUND_STARS_L1; ++i) {
-		background.starsLayer1[i] = initParticle(initSpriteAnimated(app.gameplaySprites, 26, randInt(6), 1, 1, SC_CENTER, 4, 0, randFloatRange(0.025, 0.05), AL_LOOP), randFloat(SCREEN_WIDTH), randFloat(SCREEN_HEIGHT), 0, 0, 0, 1, NULL, NULL);
+	//init layers of stars
+	setStarLayers(DEFAULT_STAR_LAYERS, sizeof(DEFAULT_STAR_LAYERS) / sizeof(StarLayerSettings));
+}
+
+//replaces the background's stars with new layers (furthest first)
+//can be called at any time, e.g. to change star density
+void setStarLayers(const StarLayerSettings *settings, int numLayers) {
+	deleteStarLayers();
+
+	if (numLayers > MAX_STAR_LAYERS) {
+		printf("WARNING - Too many star layers. Raise MAX_STAR_LAYERS.\n");
+		numLayers = MAX_STAR_LAYERS;
 	}
-	for (int i = 0; i < NUM_BACKGROUND_STARS_L2; ++i) {
-		background.starsLayer2[i] = initParticle(initSpriteAnimated(app.gameplaySprites, 26, randInt(6), 1, 1, SC_CENTER, 4, 0, randFloatRange(0.01, 0.025), AL_LOOP), randFloat(SCREEN_WIDTH), randFloat(SCREEN_HEIGHT), 0, 0, 0, 1, NULL, NULL);
+
+	for (int i = 0; i < numLayers; ++i) {
+		StarLayer *layer = &background.starLayers[i];
+		int count = settings[i].count;
+
+		layer->settings = settings[i];
+		layer->x = malloc(count * sizeof(float));
+		layer->y = malloc(count * sizeof(float));
+		layer->frame = malloc(count * sizeof(float));
+		layer->twinkleSpd = malloc(count * sizeof(float));
+		layer->variant = malloc(count * sizeof(int));
+
+		if (layer->x == NULL || layer->y == NULL || layer->frame == NULL || layer->twinkleSpd == NULL || layer->variant == NULL) {
+			printf("ERROR - Could not allocate %d stars.\n", count);
+			layer->settings.count = 0;
+			continue;
+		}
+
+		for (int j = 0; j < count; ++j) {
+			layer->x[j] = randFloat(SCREEN_WIDTH);
+			layer->y[j] = randFloat(SCREEN_HEIGHT);
+			layer->frame[j] = 0;
+			layer->twinkleSpd[j] = randFloatRange(settings[i].minTwinkleSpd, settings[i].maxTwinkleSpd);
+			layer->variant[j] = randInt(STAR_VARIANTS);
+		}
 	}
-	for (int i = 0; i < NUM_BACKGROUND_STARS_L3; ++i) {
-		background.starsLayer3[i] = initParticle(initSpriteAnimated(app.gameplaySprites, 26, randInt(6), 1, 1, SC_CENTER, 4, 0, randFloatRange(0.005, 0.01), AL_LOOP), randFloat(SCREEN_WIDTH), randFloat(SCREEN_HEIGHT), 0, 0, 0, 1, NULL, NULL);
+
+	background.numStarLayers = numLayers;
+}
+
+//moves and animates every star in a layer
+static void updateStarLayer(StarLayer *layer) {
+	int count = layer->settings.count;
+
+	//twinkle (animation frames loop around)
+	addAndWrap(layer->frame, layer->twinkleSpd, 0, STAR_FRAMES, count);
+
+	//scroll, wrapping around the screen
+	addAndWrap(layer->x, NULL, layer->settings.scrollX, SCREEN_WIDTH, count);
+	addAndWrap(layer->y, NULL, layer->settings.scrollY, SCREEN_HEIGHT, count);
+}
+
+//adds delta (plus perValueDeltas[i], if it isn't NULL) to every value, wrapping the results into [0, range)
+//deltas need to be smaller than range
+//does 4 values at a time with SSE2 when it's available
+static void addAndWrap(float *values, const float *perValueDeltas, float delta, float range, int count) {
+	int i = 0;
+
+#ifdef BACKGROUND_USE_SSE2
+	__m128 delta4 = _mm_set1_ps(delta);
+	__m128 range4 = _mm_set1_ps(range);
+	__m128 zero4 = _mm_setzero_ps();
+
+	for (; i + 4 <= count; i += 4) {
+		__m128 value4 = _mm_add_ps(_mm_loadu_ps(values + i), delta4);
+		if (perValueDeltas != NULL)
+			value4 = _mm_add_ps(value4, _mm_loadu_ps(perValueDeltas + i));
+
+		//the comparisons give all 1 bits where they're true, so ANDing them with range gives either range or 0
+		value4 = _mm_add_ps(value4, _mm_and_ps(_mm_cmplt_ps(value4, zero4), range4));
+		value4 = _mm_sub_ps(value4, _mm_and_ps(_mm_cmpge_ps(value4, range4), range4));
+		_mm_storeu_ps(values + i, value4);
+	}
+#endif
+
+	//whatever's left over (or everything, without SSE2)
+	for (; i < count; ++i) {
+		float value = values[i] + delta;
+		if (perValueDeltas != NULL)
+			value += perValueDeltas[i];
+
+		if (value < 0)
+			value += range;
+		else if (value >= range)
+			value -= range;
+		values[i] = value;
 	}
 }
 
+//draws every star in a layer as one run of quads
+static void drawStarLayer(const StarLayer *layer) {
+	SDL_Vertex *vertices = drawTextureQuads(app.gameplaySprites->texture, layer->settings.count);
+
+	if (vertices == NULL)
+		return;
+
+	SDL_Color color = { 255, 255, 255, layer->settings.alpha };
+	float atlasW = app.gameplaySprites->w;
+	float atlasH = app.gameplaySprites->h;
+
+	for (int i = 0; i < layer->settings.count; ++i) {
+		const SpriteDef *star = &SPRITE_TABLE[SPR_STAR_1 + layer->variant[i]];
+
+		//stars are drawn around their pivot, snapped to whole pixels so they stay crisp
+		float left = (int)layer->x[i] - star->pivotX;
+		float top = (int)layer->y[i] - star->pivotY;
+		float right = left + star->w;
+		float bottom = top + star->h;
+		float u0 = (app.gameplaySprites->offsetX + star->x + (int)layer->frame[i] * star->w) / atlasW, u1 = u0 + star->w / atlasW;
+		float v0 = (app.gameplaySprites->offsetY + star->y) / atlasH, v1 = v0 + star->h / atlasH;
+
+		//corners, starting at the top left and going clockwise
+		vertices[0] = (SDL_Vertex){ { left, top }, color, { u0, v0 } };
+		vertices[1] = (SDL_Vertex){ { right, top }, color, { u1, v0 } };
+		vertices[2] = (SDL_Vertex){ { right, bottom }, color, { u1, v1 } };
+		vertices[3] = (SDL_Vertex){ { left, bottom }, color, { u0, v1 } };
+		vertices += 4;
+	}
+}
+
+//frees every star layer's arrays
+static void deleteStarLayers(void) {
+	for (int i = 0; i < background.numStarLayers; ++i) {
+		StarLayer *layer = &background.starLayers[i];
+
+		free(layer->x);
+		free(layer->y);
+		free(layer->frame);
+		free(layer->twinkleSpd);
+		free(layer->variant);
+		memset(layer, 0, sizeof(StarLayer));
+	}
+
+	background.numStarLayers = 0;
+}
+
+//moves and twinkles the stars, and runs down the flash timers
+//the background is drawn in every state of the game, so this is called every logic tick from main.c rather than by any one state
+void updateBackground(void) {
+	for (int i = 0; i < background.numStarLayers; ++i)
+		updateStarLayer(&background.starLayers[i]);
+
+	//update timers
+	++background.backgroundFlashRedTimer;
+	++background.backgroundFlashWhiteTimer;
+}
+
 //instead of making particle draw functions, the background is drawn with one draw function for greater efficiency and proper layering
 //stars are drawn with less alpha the further back they are
 void drawBackground(void) {
+	setRenderLayer(RL_BACKGROUND);
+
 	//draw black background
 	//draw a semitransparent black rectangle over the screen
-	//stuff like this is why I need a rectangle drawing function
-	SDL_SetRenderDrawBlendMode(app.renderer, SDL_BLENDMODE_BLEND);
-	SDL_SetRenderDrawColor(app.renderer, PALETTE_BLACK.r, PALETTE_BLACK.g, PALETTE_BLACK.b, PALETTE_BLACK.a);
-	SDL_RenderFillRect(app.renderer, &screenRect);
+	drawFilledRect(&screenRect, PALETTE_BLACK);
+
+	//how strong each flash is, from 1 when it starts down to 0 when it's done
+	float flashRed = MAX(0, (float)((END_OF_FLASH * 3) - background.backgroundFlashRedTimer) / (float)(END_OF_FLASH * 3));
+	float flashWhite = MAX(0, (float)((END_OF_FLASH * 3) - background.backgroundFlashWhiteTimer) / (float)(END_OF_FLASH * 3));
+
+	//with post-processing on, the flashes shift the whole frame's palette instead of being drawn here
+	setPostProcessFlash(flashRed, flashWhite);
+	bool drawFlashes = !isPostProcessActive();
 
 	//draw red flash when player is hit
 	//only do this if alpha is greater than 0
-	if (background.backgroundFlashRedTimer < END_OF_FLASH * 3) {
-		SDL_SetRenderDrawBlendMode(app.renderer, SDL_BLENDMODE_BLEND);
-		SDL_SetRenderDrawColor(app.renderer, PALETTE_RED.r, PALETTE_RED.g, PALETTE_RED.b, (int)(255 * (float)((END_OF_FLASH * 3) - background.backgroundFlashRedTimer) / (float)(END_OF_FLASH * 3)));
-		SDL_RenderFillRect(app.renderer, &screenRect);
+	if (drawFlashes && background.backgroundFlashRedTimer < END_OF_FLASH * 3) {
+		SDL_Color flashRed = { PALETTE_RED.r, PALETTE_RED.g, PALETTE_RED.b, (int)(255 * (float)((END_OF_FLASH * 3) - background.backgroundFlashRedTimer) / (float)(END_OF_FLASH * 3)) };
+		drawFilledRect(&screenRect, flashRed);
 	}
 
 	//draw white flash when player collects a powerup
 	//only do this if alpha is greater than 0
-	if (background.backgroundFlashWhiteTimer < END_OF_FLASH * 3) {
-		SDL_SetRenderDrawBlendMode(app.renderer, SDL_BLENDMODE_BLEND);
-		SDL_SetRenderDrawColor(app.renderer, PALETTE_WHITE.r, PALETTE_WHITE.g, PALETTE_WHITE.b, (int)(63 * (float)((END_OF_FLASH * 3) - background.backgroundFlashWhiteTimer) / (float)(END_OF_FLASH * 3)));
-		SDL_RenderFillRect(app.renderer, &screenRect);
+	if (drawFlashes && background.backgroundFlashWhiteTimer < END_OF_FLASH * 3) {
+		SDL_Color flashWhite = { PALETTE_WHITE.r, PALETTE_WHITE.g, PALETTE_WHITE.b, (int)(63 * (float)((END_OF_FLASH * 3) - background.backgroundFlashWhiteTimer) / (float)(END_OF_FLASH * 3)) };
+		drawFilledRect(&screenRect, flashWhite);
 	}
 
-	//draw stars
-	setTextureRGBA(app.gameplaySprites->texture, 255, 255, 255, 63);
-	for (int i = 0; i < NUM_BACKGROUND_STARS_L3; ++i) {
-		blitAndUpdateSpriteAnimated(background.starsLayer3[i]->sprite, background.starsLayer3[i]->x, background.starsLayer3[i]->y);
-	}
-	setTextureRGBA(app.gameplaySprites->texture, 255, 255, 255, 127);
-	for (int i = 0; i < NUM_BACKGROUND_STARS_L2; ++i) {
-		blitAndUpdateSpriteAnimated(background.starsLayer2[i]->sprite, background.starsLayer2[i]->x, background.starsLayer2[i]->y);
-	}
-	setTextureRGBA(app.gameplaySprites->texture, 255, 255, 255, 255);
-	for (int i = 0; i < NUM_BACKGROUND_STARS_L1; ++i) {
-		blitAndUpdateSpriteAnimated(background.starsLayer1[i]->sprite, background.starsLayer1[i]->x, background.starsLayer1[i]->y);
-	}
+	//draw stars, furthest layer first
+	for (int i = 0; i < background.numStarLayers; ++i)
+		drawStarLayer(&background.starLayers[i]);
 
 	//draw planet
-	blitAndUpdateSpriteAnimated(background.planet->sprite, background.planet->x, background.planet->y);
-
-	//update timers
-	++background.backgroundFlashRedTimer;
-	++background.backgroundFlashWhiteTimer;
+	blitSpriteAnimated(background.planet->sprite, background.planet->x, background.planet->y);
 }
 
 void deleteBackground(void) {
-	//sorry nothing
-	//this used to have a reason for existing, but now it doesn't
-	
-	//particles automatically deallocated by particle delete function
+	deleteStarLayers();
+
+	//the planet is automatically deallocated by the particle delete function
 }
\ No newline at end of file
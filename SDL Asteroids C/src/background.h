@@ -3,22 +3,47 @@
 
 /*
 * Header file for the game's background.
-* The background is drawn as a planet on top of three layers of stars.
-* Layer 1 is the closest, layer 3 is the furthest.
+* The background is drawn as a planet on top of layers of stars.
+* Stars are stored as packed arrays per layer (not as particles), updated 4 at a time with SSE2, and each layer is drawn as a single run of quads.
+* Layers go from furthest to closest; further layers are dimmer, twinkle slower and scroll slower.
 */
 
 #include "particles.h"
 
+#define MAX_STAR_LAYERS 8	//most star layers the background can have
+
+//settings for one layer of stars
+typedef struct {
+	int count;				//number of stars in the layer
+	Uint8 alpha;
+	float minTwinkleSpd;	//animation speed range for the stars' twinkling
+	float maxTwinkleSpd;
+	float scrollX;			//how far the layer moves every frame, in pixels
+	float scrollY;
+} StarLayerSettings;
+
+//one layer of stars
+//each array holds one value per star
+typedef struct {
+	StarLayerSettings settings;
+	float *x;
+	float *y;
+	float *frame;		//current animation frame (fractional, like SpriteAnimated's currentFrame)
+	float *twinkleSpd;
+	int *variant;		//which row of star sprites in the atlas this star uses
+} StarLayer;
+
 typedef struct {
 	Particle *planet;
-	Particle *starsLayer1[NUM_BACKGROUND_STARS_L1];
-	Particle *starsLayer2[NUM_BACKGROUND_STARS_L2];
-	Particle *starsLayer3[NUM_BACKGROUND_STARS_L3];
+	StarLayer starLayers[MAX_STAR_LAYERS];
+	int numStarLayers;
 	int backgroundFlashRedTimer;	//timer to make sure the background red flash fades out after the player is hit
 	int backgroundFlashWhiteTimer;	//ditto for green flash
 } Background;
 
 void initBackground(void);
+void setStarLayers(const StarLayerSettings *settings, int numLayers);
+void updateBackground(void);
 void drawBackground(void);
 void deleteBackground(void);
 
@@ -3,8 +3,11 @@
 
 #include "bullets.h"
 
+#include "animations.h"
 #include "background.h"
+#include "composites.h"
 #include "crates.h"
+#include "debugDraw.h"
 #include "enemies.h"
 #include "particles.h"
 #include "player.h"
@@ -25,6 +28,11 @@ static void fireShotgunBullet();
 void fireEnemyBullet(Enemy *enemy);
 static void biUpdate(Particle *particle);
 static void biDraw(Particle *particle);
+static void playerBulletHit(const Contact *contact, int *hp, int *timeSinceDamaged);
+static void playerBulletHitCrate(const Contact *contact);
+static void playerBulletHitEnemy(const Contact *contact);
+static void enemyBulletHitPlayer(const Contact *contact);
+void initBullets(void);
 void updateBullets(void);
 void drawBullets(void);
 static void deleteBullet(Bullet *b);
@@ -85,8 +93,10 @@ static void fireNormalBullet() {
 	bullet->angle = atan2(bullet->dirVector.y, bullet->dirVector.x) * RADIANS_TO_DEGREES;
 	bullet->ttl = FPS * 3;	//3 seconds to live
 	bullet->type = BT_NORMAL;
-	bullet->sprite = initSpriteAnimated(app.gameplaySprites, 16, 0, 2, 1, SC_CENTER, 4, 0, 0.25f, AL_LOOP);
-	bullet->collider = initOBBCollider(bullet->sprite->w * 0.5, bullet->sprite->h * 0.5, (Vector2){bullet->x, bullet->y}, bullet->angle * DEGREES_TO_RADIANS);
+	bullet->sprite = initSpriteAnimatedFromTable(SPR_BULLET_NORMAL, 0);
+	preRotateSpriteAnimated(bullet->sprite);
+	bullet->collider = initOBBCollider(bullet->sprite->w * 0.5, bullet->sprite->h * 0.5, (Vector2){bullet->x, bullet->y}, bullet->angle * DEGREES_TO_RADIANS, CL_PLAYER_BULLET, bullet);
+	setColliderPixelMasks(bullet->collider, getSpritePixelMasks(SPR_BULLET_NORMAL));
 	bullet->next = NULL;	//always inserting on end of list
 
 	player->reload = 10;
@@ -116,8 +126,10 @@ static void fireErraticBullet() {
 	bullet->angle = randFloat(359.9999999999999999);
 	bullet->ttl = FPS * 2;	//2 seconds to live
 	bullet->type = BT_ERRATIC;
-	bullet->sprite = initSpriteAnimated(app.gameplaySprites, 16, 3, 1, 1, SC_CENTER, 4, 0, 0.5f, AL_LOOP);
-	bullet->collider = initOBBCollider(bullet->sprite->w * 0.5, bullet->sprite->h * 0.5, (Vector2) { bullet->x, bullet->y }, bullet->angle * DEGREES_TO_RADIANS);
+	bullet->sprite = initSpriteAnimatedFromTable(SPR_BULLET_ERRATIC, 0);
+	preRotateSpriteAnimated(bullet->sprite);
+	bullet->collider = initOBBCollider(bullet->sprite->w * 0.5, bullet->sprite->h * 0.5, (Vector2) { bullet->x, bullet->y }, bullet->angle * DEGREES_TO_RADIANS, CL_PLAYER_BULLET, bullet);
+	setColliderPixelMasks(bullet->collider, getSpritePixelMasks(SPR_BULLET_ERRATIC));
 	bullet->next = NULL;	//always inserting on end of list
 
 	player->reload = 4;
@@ -145,8 +157,10 @@ static void fireBouncerBullet() {
 	bullet->angle = atan2(bullet->dirVector.y, bullet->dirVector.x) * RADIANS_TO_DEGREES;
 	bullet->ttl = FPS * 4;	//4 seconds to live
 	bullet->type = BT_BOUNCER;
-	bullet->sprite = initSpriteAnimated(app.gameplaySprites, 16, 6, 2, 1, SC_CENTER, 4, 0, 0.25f, AL_LOOP);
-	bullet->collider = initOBBCollider(bullet->sprite->w * 0.5, bullet->sprite->h * 0.5, (Vector2) { bullet->x, bullet->y }, bullet->angle * DEGREES_TO_RADIANS);
+	bullet->sprite = initSpriteAnimatedFromTable(SPR_BULLET_BOUNCER, 0);
+	preRotateSpriteAnimated(bullet->sprite);
+	bullet->collider = initOBBCollider(bullet->sprite->w * 0.5, bullet->sprite->h * 0.5, (Vector2) { bullet->x, bullet->y }, bullet->angle * DEGREES_TO_RADIANS, CL_PLAYER_BULLET, bullet);
+	setColliderPixelMasks(bullet->collider, getSpritePixelMasks(SPR_BULLET_BOUNCER));
 	bullet->next = NULL;	//always inserting on end of list
 
 	player->reload = 30;
@@ -177,8 +191,10 @@ static void fireShotgunBullet() {
 		bullet->angle = atan2(bullet->dirVector.y, bullet->dirVector.x) * RADIANS_TO_DEGREES;
 		bullet->ttl = FPS * 5;	//5 seconds to live
 		bullet->type = BT_SHOTGUN;
-		bullet->sprite = initSpriteAnimated(app.gameplaySprites, 16, 9, 1, 1, SC_CENTER, 4, 0, 0.25f, AL_LOOP);
-		bullet->collider = initOBBCollider(bullet->sprite->w * 0.5, bullet->sprite->h * 0.5, (Vector2) { bullet->x, bullet->y }, bullet->angle * DEGREES_TO_RADIANS);
+		bullet->sprite = initSpriteAnimatedFromTable(SPR_BULLET_SHOTGUN, 0);
+		preRotateSpriteAnimated(bullet->sprite);
+		bullet->collider = initOBBCollider(bullet->sprite->w * 0.5, bullet->sprite->h * 0.5, (Vector2) { bullet->x, bullet->y }, bullet->angle * DEGREES_TO_RADIANS, CL_PLAYER_BULLET, bullet);
+		setColliderPixelMasks(bullet->collider, getSpritePixelMasks(SPR_BULLET_SHOTGUN));
 		bullet->next = NULL;	//always inserting on end of list
 	}
 
@@ -208,8 +224,10 @@ void fireEnemyBullet(Enemy *enemy) {
 	bullet->angle = atan2(bullet->dirVector.y, bullet->dirVector.x) * RADIANS_TO_DEGREES;
 	bullet->ttl = FPS * 4;	//4 seconds to live
 	bullet->type = BT_ENEMY;
-	bullet->sprite = initSpriteAnimated(app.gameplaySprites, 16, 12, 2, 1, SC_CENTER, 4, 0, 0.25f, AL_LOOP);
-	bullet->collider = initOBBCollider(bullet->sprite->w * 0.4, bullet->sprite->h * 0.4, (Vector2) { bullet->x, bullet->y }, bullet->angle *DEGREES_TO_RADIANS);	//slightly undersized collider for enemy bullets to bias things for the player
+	bullet->sprite = initSpriteAnimatedFromTable(SPR_BULLET_ENEMY, 0);
+	preRotateSpriteAnimated(bullet->sprite);
+	bullet->collider = initOBBCollider(bullet->sprite->w * 0.5, bullet->sprite->h * 0.5, (Vector2) { bullet->x, bullet->y }, bullet->angle *DEGREES_TO_RADIANS, CL_ENEMY_BULLET, bullet);
+	setColliderPixelMasks(bullet->collider, getSpritePixelMasks(SPR_BULLET_ENEMY));
 	bullet->next = NULL;	//always inserting on end of list
 
 	enemy->reload = FPS * 3;
@@ -220,259 +238,173 @@ static void biUpdate(Particle *particle) {
 	//move according to delta
 	particle->x += particle->deltaX;
 	particle->y += particle->deltaY;
-}
 
-//bullet impact particle draw function
-static void biDraw(Particle *particle) {
 	//if on the extra frame, set the particle to be deleted
 	if (particle->sprite->currentFrame == particle->sprite->frames - 1)
 		particle->ttl = 0;
+}
 
-	blitAndUpdateSpriteAnimatedEX(particle->sprite, particle->x, particle->y, particle->angle, NULL, SDL_FLIP_NONE);
+//bullet impact particle draw function
+static void biDraw(Particle *particle) {
+	blitSpriteAnimatedEX(particle->sprite, particle->x, particle->y, particle->angle, NULL, SDL_FLIP_NONE);
 }
 
-//moves and deletes bullets
-void updateBullets(void) {
-	Bullet *bullet, *prev;
+//response for a player bullet touching something
+//hp and timeSinceDamaged belong to the thing that was hit
+static void playerBulletHit(const Contact *contact, int *hp, int *timeSinceDamaged) {
+	Bullet *bullet = (Bullet *)contact->a->owner;
+
+	//bullets that die on hit only get to apply their first contact of the tick
+	if (bullet->ttl <= 0)
+		return;
+
+	//apply damage based on bullet type
+	switch (bullet->type) {
+	case(BT_NORMAL):
+		*hp -= BULLET_NORMAL_DMG;
+
+		//destroy bullet
+		bullet->ttl = 0;
+		break;
+	case(BT_ERRATIC):
+		*hp -= BULLET_ERRATIC_DMG;
+
+		//destroy bullet
+		bullet->ttl = 0;
+		break;
+	case(BT_BOUNCER):
+	{
+		*hp -= BULLET_BOUNCER_DMG;
+
+		//make bullet bounce by reflecting its direction vector across the contact normal
+		//only bounce if the bullet's heading into the surface; if it hit two things at once, the second one may already be behind it
+		//this is only approximately realistic;
+		//for instance, hitting a corner just defaults to the axes, and very high bullet speeds will result in inaccuracies
+		float velocityDotNormal = dotProduct(&bullet->dirVector, &contact->normal);
+
+		if (velocityDotNormal < 0) {
+			//impact particle on bounce
+			initParticle(initSpriteAnimatedFromTable(SPR_IMPACT_BOUNCER, 0), bullet->x, bullet->y, 0, 0, bullet->angle - 45, 1, biUpdate, biDraw);
+
+			//r = d - 2(d.n)n, which stays normalized since n is a unit vector
+			bullet->dirVector = addVec2(bullet->dirVector, scalarMultVec2(contact->normal, -2 * velocityDotNormal));
+
+			//change angle to reflect change in direction
+			bullet->angle = atan2(bullet->dirVector.y, bullet->dirVector.x) * RADIANS_TO_DEGREES;
+
+			//cycle it through another change in velocity to prevent bouncing again on the next update (it's still probably within the target on this update)
+			bullet->x += bullet->dirVector.x * bullet->speed;
+			bullet->y += bullet->dirVector.y * bullet->speed;
+		}
 
-	bullet = prev = stage.bulletHead;
+		break;
+	}
+	case(BT_SHOTGUN):
+		*hp -= BULLET_SHOTGUN_DMG;
 
-	//vars for handling screenwrap
-	float horzEdgeDist, vertEdgeDist;
+		//destroy bullet
+		bullet->ttl = 0;
+		break;
 
-	while(bullet != NULL) {
-		//update position of element
-		bullet->x += bullet->dirVector.x * bullet->speed;
-		bullet->y += bullet->dirVector.y * bullet->speed;
-
-		//take care of some bullet-type dependent things
-		switch (bullet->type) {
-			case(BT_ERRATIC):
-				bullet->speed += erraticAccel;
-				break;
-			case(BT_SHOTGUN):
-				bullet->speed -= shotgunDeccel;
-
-				//despawn if speed is too low
-				if (bullet->speed <= shotgunDespawnThreshold)
-					bullet->ttl = 0;
-				break;
-		}
+		//enemy bullets never get here (see the pair filter table in colliders.c)
+	}
 
-		//screenwrap
-		horzEdgeDist = bullet->sprite->w * SCREENWRAP_MARGIN;
-		vertEdgeDist = bullet->sprite->h * SCREENWRAP_MARGIN;
-		if (bullet->x < -horzEdgeDist)
-			bullet->x = SCREEN_WIDTH + horzEdgeDist;
-		if (bullet->x > SCREEN_WIDTH + horzEdgeDist)
-			bullet->x = -horzEdgeDist;
-		if (bullet->y < -vertEdgeDist)
-			bullet->y = SCREEN_HEIGHT + vertEdgeDist;
-		if (bullet->y > SCREEN_HEIGHT + vertEdgeDist)
-			bullet->y = -vertEdgeDist;
-
-		//update collider
-		updateCollider(bullet->collider, bullet->x, bullet->y, bullet->angle * DEGREES_TO_RADIANS, -1, -1);
+	//only one hitsound per target per tick
+	//(timeSinceDamaged is incremented by the target's update, so it can only be 0 here if the target was already hit this tick)
+	if (*timeSinceDamaged != 0)
+		playSoundIsolated(SFX_ENEMY_HIT, SC_HITSOUNDS, false, bullet->x / SCREEN_WIDTH * 255.0);
 
-		if (bullet->type != BT_ENEMY) {
-			//handling a player bullet
-			//check for a collision with a crate
-			Crate *crate = stage.crateHead;
-
-			while (crate != NULL) {
-				if (checkIntersection(bullet->collider, crate->collider)) {
-					//if there's a collision, apply damage based on bullet type
-					switch (bullet->type) {
-					case(BT_NORMAL):
-						crate->hp -= BULLET_NORMAL_DMG;
-						crate->timeSinceDamaged = 0;	//update this var for hitflash to work
-
-						//destroy bullet
-						bullet->ttl = 0;
-						break;
-					case(BT_ERRATIC):
-						crate->hp -= BULLET_ERRATIC_DMG;
-						crate->timeSinceDamaged = 0;	//update this var for hitflash to work
+	*timeSinceDamaged = 0;	//update this var for hitflash to work
+}
 
-						//destroy bullet
-						bullet->ttl = 0;
-						break;
-					case(BT_BOUNCER):
-					{
-						crate->hp -= BULLET_BOUNCER_DMG;
-						crate->timeSinceDamaged = 0;	//update this var for hitflash to work
-
-						//impact particle on bounce
-						initParticle(initSpriteAnimated(app.gameplaySprites, 16, 7, 1, 1, SC_CENTER, 4, 0, 0.25, AL_ONESHOT), bullet->x, bullet->y, 0, 0, bullet->angle - 45, 1, NULL, biDraw);
-						
-						//make bullet bounce
-						//to do this, we use the seperating axes thm to check which crate axis the center of the bullet is further away from
-						//whichever axis the center is further from is the normal
-						//we then reflect the bullet's direction vector across that normal
-						//this is only approximately realistic; 
-						//for instance, hitting a corner just defaults to the axes, and very high bullet speeds will result in inaccuracies
-						Vector2 relativeOrigin, projAxis0, projAxis1, normal, velocity, projectedVelocity;
-						float valAxis0, valAxis1;
-
-						//find normal vector
-
-						//need to use origin relative to the crate's origin, not origin relative to world space
-						relativeOrigin.x = crate->collider->origin.x - bullet->collider->origin.x;
-						relativeOrigin.y = crate->collider->origin.y - bullet->collider->origin.y;
-						projAxis0 = projectVector(&relativeOrigin, &crate->collider->axes[0]);
-						valAxis0 = fabs(dotProduct(&(crate->collider->axes[0]), &projAxis0));
-						projAxis1 = projectVector(&relativeOrigin, &crate->collider->axes[1]);
-						valAxis1 = fabs(dotProduct(&(crate->collider->axes[1]), &projAxis1));
-
-						if (valAxis0 > valAxis1) {
-							normal = projAxis0;
-						} else {
-							normal = projAxis1;
-						}
-
-						velocity = scalarMultVec2(bullet->dirVector, bullet->speed);			//bullet's velocity vector
-						projectedVelocity = projectVector(&velocity, &normal);		//projection of velocity vector onto normal
-						projectedVelocity = scalarMultVec2(projectedVelocity, 2);	//multiplied by 2 for projection trick
-
-						bullet->dirVector.x = velocity.x - projectedVelocity.x;
-						bullet->dirVector.y = velocity.y - projectedVelocity.y;
-						normalize(&bullet->dirVector);	//dirVector should always be normalized
-
-						//change angle to reflect change in direction
-						bullet->angle = atan2(bullet->dirVector.y, bullet->dirVector.x) * RADIANS_TO_DEGREES;
-
-						//cycle it through another change in velocity to prevent bouncing again on the next update (it's still probably within the crate on this update)
-						bullet->x += bullet->dirVector.x * bullet->speed;
-						bullet->y += bullet->dirVector.y * bullet->speed;
-
-						break;
-					}
-					case(BT_SHOTGUN):
-						crate->hp -= BULLET_SHOTGUN_DMG;
-						crate->timeSinceDamaged = 0;	//update this var for hitflash to work
-
-						//destroy bullet
-						bullet->ttl = 0;
-						break;
+//collision handlers (registered in initBullets)
 
-						//do nothing for enemy bullets
-					}
+static void playerBulletHitCrate(const Contact *contact) {
+	Crate *crate = (Crate *)contact->b->owner;
 
-					playSoundIsolated(SFX_ENEMY_HIT, SC_HITSOUNDS, false, bullet->x / SCREEN_WIDTH * 255.0);
-				}
+	playerBulletHit(contact, &crate->hp, &crate->timeSinceDamaged);
+	crate->crateSpriteHitflash->currentFrame = getHitflashLevel(crate->timeSinceDamaged);	//collisions come after updateCrates, so the hitflash has to start here
+}
 
-				crate = crate->next;
-			}
+//entering enemies are on their own layer, so bullets only ever hit enemies that are in the stage proper
+static void playerBulletHitEnemy(const Contact *contact) {
+	Enemy *enemy = (Enemy *)contact->b->owner;
+
+	playerBulletHit(contact, &enemy->hp, &enemy->timeSinceDamaged);
+	enemy->spriteHitflash->currentFrame = getHitflashLevel(enemy->timeSinceDamaged);	//collisions come after updateEnemies, so the hitflash has to start here
+}
 
-			//check for a collision with an enemy
-			Enemy *enemy = stage.enemyHead;
+//a dead player's collider has an empty mask, so this only gets called on a living player
+static void enemyBulletHitPlayer(const Contact *contact) {
+	Bullet *bullet = (Bullet *)contact->a->owner;
 
-			while (enemy != NULL) {
-				//only apply damage if enemy is in the stage proper
-				if (checkIntersection(bullet->collider, enemy->collider) && enemy->state != ES_ENTER_STAGE) {
-					//if there's a collision, apply damage based on bullet type
-					switch (bullet->type) {
-					case(BT_NORMAL):
-						enemy->hp -= BULLET_NORMAL_DMG;
-						enemy->timeSinceDamaged = 0;	//update this var for hitflash to work
+	//apply damage to player
+	if (player->iFrames <= 0) {
+		player->iFrames = PLAYER_I_FRAMES_MAX;	//give i-frames
+		--player->hp;
 
-						//destroy bullet
-						bullet->ttl = 0;
-						break;
-					case(BT_ERRATIC):
-						enemy->hp -= BULLET_ERRATIC_DMG;
-						enemy->timeSinceDamaged = 0;	//update this var for hitflash to work
+		//set background to do hurt flash
+		background.backgroundFlashRedTimer = 0;
 
-						//destroy bullet
-						bullet->ttl = 0;
-						break;
-					case(BT_BOUNCER):
-					{
-						enemy->hp -= BULLET_BOUNCER_DMG;
-						enemy->timeSinceDamaged = 0;	//update this var for hitflash to work
-
-						//add impact particle on bounce
-						initParticle(initSpriteAnimated(app.gameplaySprites, 16, 7, 1, 1, SC_CENTER, 4, 0, 0.25, AL_ONESHOT), bullet->x, bullet->y, 0, 0, bullet->angle - 45, 1, NULL, biDraw);
-
-						//make bullet bounce
-						//to do this, we use the seperating axes thm to check which enemy axis the center of the bullet is further away from
-						//whichever axis the center is further from is the normal
-						//we then reflect the bullet's direction vector across that normal
-						//this is only approximately realistic; 
-						//for instance, hitting a corner just defaults to the axes, and very high bullet speeds will result in inaccuracies
-						Vector2 relativeOrigin, projAxis0, projAxis1, normal, velocity, projectedVelocity;
-						float valAxis0, valAxis1;
-
-						//find normal vector
-
-						//need to use origin relative to the enemy's origin, not origin relative to world space
-						relativeOrigin.x = enemy->collider->origin.x - bullet->collider->origin.x;
-						relativeOrigin.y = enemy->collider->origin.y - bullet->collider->origin.y;
-						projAxis0 = projectVector(&relativeOrigin, &enemy->collider->axes[0]);
-						valAxis0 = fabs(dotProduct(&(enemy->collider->axes[0]), &projAxis0));
-						projAxis1 = projectVector(&relativeOrigin, &enemy->collider->axes[1]);
-						valAxis1 = fabs(dotProduct(&(enemy->collider->axes[1]), &projAxis1));
-
-						if (valAxis0 > valAxis1) {
-							normal = projAxis0;
-						} else {
-							normal = projAxis1;
-						}
-
-						velocity = scalarMultVec2(bullet->dirVector, bullet->speed);			//bullet's velocity vector
-						projectedVelocity = projectVector(&velocity, &normal);		//projection of velocity vector onto normal
-						projectedVelocity = scalarMultVec2(projectedVelocity, 2);	//multiplied by 2 for projection trick
-
-						bullet->dirVector.x = velocity.x - projectedVelocity.x;
-						bullet->dirVector.y = velocity.y - projectedVelocity.y;
-						normalize(&bullet->dirVector);	//dirVector should always be normalized
-
-						//change angle to reflect change in direction
-						bullet->angle = atan2(bullet->dirVector.y, bullet->dirVector.x) * RADIANS_TO_DEGREES;
-
-						//cycle it through another change in velocity to prevent bouncing again on the next update (it's still probably within the enemy on this update)
-						bullet->x += bullet->dirVector.x * bullet->speed;
-						bullet->y += bullet->dirVector.y * bullet->speed;
-
-						break;
-					}
-					case(BT_SHOTGUN):
-						enemy->hp -= BULLET_SHOTGUN_DMG;
-						enemy->timeSinceDamaged = 0;	//update this var for hitflash to work
-
-						//destroy bullet
-						bullet->ttl = 0;
-						break;
+		playSound(SFX_PLAYER_HIT, SC_PLAYER, false, bullet->x / SCREEN_WIDTH * 255.0);
+	}
 
-						//do nothing for enemy bullets
-					}
+	bullet->ttl = 0;	//destroy bullet
+}
 
-					playSoundIsolated(SFX_ENEMY_HIT, SC_HITSOUNDS, false, bullet->x / SCREEN_WIDTH * 255.0);
-				}
+//registers bullet collision handlers
+//bullets themselves don't need any initialization
+void initBullets(void) {
+	setCollisionHandler(CL_PLAYER_BULLET, CL_CRATE, playerBulletHitCrate);
+	setCollisionHandler(CL_PLAYER_BULLET, CL_ENEMY, playerBulletHitEnemy);
+	setCollisionHandler(CL_ENEMY_BULLET, CL_PLAYER, enemyBulletHitPlayer);
+}
 
-				enemy = enemy->next;
-			}
-		}
-		else {
-			//handling an enemy bullet
-			//check for a collision with the player
-			//only collide with the player if the player's not dead
-			if (checkIntersection(bullet->collider, player->collider) && player->state != PS_DESTROYED) {
-				//if there's a collision, apply damage to player
-				if (player->iFrames <= 0) {
-					player->iFrames = PLAYER_I_FRAMES_MAX;	//give i-frames
-					--player->hp;
+//moves and deletes bullets
+void updateBullets(void) {
+	Bullet *bullet, *prev;
 
-					//set background to do hurt flash
-					background.backgroundFlashRedTimer = 0;
+	bullet = prev = stage.bulletHead;
+
+	//vars for handling screenwrap
+	float horzEdgeDist, vertEdgeDist;
 
-					playSound(SFX_PLAYER_HIT, SC_PLAYER, false, bullet->x / SCREEN_WIDTH * 255.0);
-				}
+	while(bullet != NULL) {
+		//bullets that hit something last tick stay put, so their impact particle shows up where they hit
+		if (bullet->ttl > 0) {
+			//update position of element
+			bullet->x += bullet->dirVector.x * bullet->speed;
+			bullet->y += bullet->dirVector.y * bullet->speed;
 
-				//bullet impact particle
+			//take care of some bullet-type dependent things
+			switch (bullet->type) {
+				case(BT_ERRATIC):
+					bullet->speed += erraticAccel;
+					break;
+				case(BT_SHOTGUN):
+					bullet->speed -= shotgunDeccel;
 
-				bullet->ttl = 0;	//destroy bullet
+					//despawn if speed is too low
+					if (bullet->speed <= shotgunDespawnThreshold)
+						bullet->ttl = 0;
+					break;
 			}
+
+			//screenwrap
+			horzEdgeDist = bullet->sprite->w * SCREENWRAP_MARGIN;
+			vertEdgeDist = bullet->sprite->h * SCREENWRAP_MARGIN;
+			if (bullet->x < -horzEdgeDist)
+				bullet->x = SCREEN_WIDTH + horzEdgeDist;
+			if (bullet->x > SCREEN_WIDTH + horzEdgeDist)
+				bullet->x = -horzEdgeDist;
+			if (bullet->y < -vertEdgeDist)
+				bullet->y = SCREEN_HEIGHT + vertEdgeDist;
+			if (bullet->y > SCREEN_HEIGHT + vertEdgeDist)
+				bullet->y = -vertEdgeDist;
+
+			//update collider
+			//hits are checked afterwards by checkCollisions, which calls the handlers registered in initBullets
+			updateCollider(bullet->collider, bullet->x, bullet->y, bullet->angle * DEGREES_TO_RADIANS, -1, -1);
 		}
 
 		//update ttl and destroy bullet if it's hit the end of ttl
@@ -480,19 +412,19 @@ void updateBullets(void) {
 			//create impact particle
 			switch (bullet->type) {
 				case(BT_NORMAL):	
-					initParticle(initSpriteAnimated(app.gameplaySprites, 16, 1, 1, 1, SC_CENTER, 4, 0, 0.25, AL_ONESHOT), bullet->x, bullet->y, 0, 0, bullet->angle + 90, 1, NULL, biDraw);
+					initParticle(initSpriteAnimatedFromTable(SPR_IMPACT_NORMAL, 0), bullet->x, bullet->y, 0, 0, bullet->angle + 90, 1, biUpdate, biDraw);
 					break;
 				case(BT_ERRATIC):	
-					initParticle(initSpriteAnimated(app.gameplaySprites, 16, 4, 1, 1, SC_CENTER, 5, 0, 0.25, AL_ONESHOT), bullet->x, bullet->y, 0, 0, bullet->angle + 45, 1, NULL, biDraw);
+					initParticle(initSpriteAnimatedFromTable(SPR_IMPACT_ERRATIC, 0), bullet->x, bullet->y, 0, 0, bullet->angle + 45, 1, biUpdate, biDraw);
 					break;
 				case(BT_BOUNCER):	
-					initParticle(initSpriteAnimated(app.gameplaySprites, 16, 7, 1, 1, SC_CENTER, 4, 0, 0.25, AL_ONESHOT), bullet->x, bullet->y, 0, 0, bullet->angle - 45, 1, NULL, biDraw);
+					initParticle(initSpriteAnimatedFromTable(SPR_IMPACT_BOUNCER, 0), bullet->x, bullet->y, 0, 0, bullet->angle - 45, 1, biUpdate, biDraw);
 					break;
 				case(BT_SHOTGUN):	
-					initParticle(initSpriteAnimated(app.gameplaySprites, 16, 10, 1, 1, SC_CENTER, 4, 0, 0.25, AL_ONESHOT), bullet->x, bullet->y, 0, 0, bullet->angle, 1, NULL, biDraw);
+					initParticle(initSpriteAnimatedFromTable(SPR_IMPACT_SHOTGUN, 0), bullet->x, bullet->y, 0, 0, bullet->angle, 1, biUpdate, biDraw);
 					break;
 				case(BT_ENEMY):	
-					initParticle(initSpriteAnimated(app.gameplaySprites, 16, 13, 1, 1, SC_CENTER, 4, 0, 0.25, AL_ONESHOT), bullet->x, bullet->y, 0, 0, bullet->angle + 90, 1, NULL, biDraw);
+					initParticle(initSpriteAnimatedFromTable(SPR_IMPACT_ENEMY, 0), bullet->x, bullet->y, 0, 0, bullet->angle + 90, 1, biUpdate, biDraw);
 					break;
 			}
 
@@ -523,27 +455,29 @@ void updateBullets(void) {
 }
 
 void drawBullets(void) {
+	setRenderLayer(RL_BULLETS);
+
 	Bullet *bullet;
 
 	for (bullet = stage.bulletHead; bullet != NULL; bullet = bullet->next) {
 		//make player bullets semitransparent
 		if (bullet->type != BT_ENEMY) {
 			setTextureRGBA(bullet->sprite->atlas->texture, 255, 255, 255, 127);
-			blitAndUpdateSpriteAnimatedEX(bullet->sprite, bullet->x, bullet->y, bullet->angle, NULL, SDL_FLIP_NONE);
+			blitSpriteAnimatedEX(bullet->sprite, bullet->x, bullet->y, bullet->angle, NULL, SDL_FLIP_NONE);
 			setTextureRGBA(bullet->sprite->atlas->texture, 255, 255, 255, 255);
 		}
 		else	//enemy bullet; draw as normal
-			blitAndUpdateSpriteAnimatedEX(bullet->sprite, bullet->x, bullet->y, bullet->angle, NULL, SDL_FLIP_NONE);
+			blitSpriteAnimatedEX(bullet->sprite, bullet->x, bullet->y, bullet->angle, NULL, SDL_FLIP_NONE);
 
-		displayCollider(app.renderer, &COLOR_RED, bullet->collider);
+		displayCollider(&COLOR_RED, bullet->collider);
+		debugDrawVelocity(bullet->x, bullet->y, bullet->dirVector, bullet->speed);
 	}
 }
 
-//no initialization function needed
-
-//for deleting one bullet. frees dynamically allocated texture, then bullet itself.
+//for deleting one bullet. frees dynamically allocated texture and collider, then bullet itself.
 static void deleteBullet(Bullet *bullet) {
-	free(bullet->sprite);
+	deleteSpriteAnimated(bullet->sprite);
+	deleteCollider(bullet->collider);
 	free(bullet);
 	bullet = NULL;	//not really necessary but good practice
 }
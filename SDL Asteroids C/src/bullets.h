@@ -35,6 +35,7 @@ struct Bullet {
 
 void firePlayerBullet(void);
 void fireEnemyBullet(Enemy *enemy);
+void initBullets(void);
 void updateBullets(void);
 void drawBullets(void);
 void deleteBullets(void);
@@ -0,0 +1,271 @@
+#include "common.h"
+
+#include "SDL_image.h"
+
+#include "capture.h"
+
+extern App app;
+
+//number of frames that can be read back and waiting on (or being) saved at once
+#define CAPTURE_BUFFERS 2
+
+//CF stands for capture format
+typedef enum {
+	CF_Y4M,		//one raw 4:2:0 video file
+	CF_PNG		//one PNG per frame
+} CaptureFormat;
+
+//a frame that's been read back
+typedef struct {
+	Uint32 *pixels;	//RGBA32, SCREEN_WIDTH x SCREEN_HEIGHT
+	int frame;		//counted from the first frame captured
+} CaptureBuffer;
+
+bool initCapture(const char *path);
+static bool isFrameNumberPattern(const char *path);
+void captureFrame(void);
+static int captureSaver(void *data);
+static void saveFrame(const CaptureBuffer *buffer);
+static void convertToYUV(const Uint32 *pixels);
+void deleteCapture(void);
+
+static const int YUV_FRAME_SIZE = SCREEN_WIDTH * SCREEN_HEIGHT * 3 / 2;	//a full size luma plane plus 2 quarter size chroma planes
+
+static bool capturing = false;
+static CaptureFormat format = CF_Y4M;
+static const char *outputPath = NULL;	//the video file for Y4M, the file name pattern for PNG
+static FILE *video = NULL;
+static Uint8 *yuv = NULL;				//a frame converted for the video file (only ever touched by whoever's saving)
+static bool saveFailed = false;
+
+static CaptureBuffer buffers[CAPTURE_BUFFERS];
+static int nextToFill = 0;		//only touched by the main thread
+static int nextToSave = 0;		//only touched by the saver
+static int framesCaptured = 0;
+static int saverWaits = 0;		//times the game had to wait for the saver to free up a buffer
+static Uint64 captureStart = 0;
+
+static SDL_Thread *saver = NULL;	//NULL if frames are saved on the main thread
+static SDL_sem *freeBuffers = NULL;	//counts buffers that can be read back into
+static SDL_sem *fullBuffers = NULL;	//counts buffers waiting to be saved
+static bool saverQuit = false;
+
+//starts capturing every frame that's shown to path
+//path ending in .y4m captures to a video, otherwise path has to have a frame number in it, and frames are saved as PNGs
+//returns false if path can't be used, or something couldn't be made
+bool initCapture(const char *path) {
+	size_t length = strlen(path);
+
+	if (length >= 4 && SDL_strcasecmp(path + length - 4, ".y4m") == 0) {
+		format = CF_Y4M;
+		video = fopen(path, "wb");
+		yuv = malloc(YUV_FRAME_SIZE);
+		if (video == NULL || yuv == NULL) {
+			printf("ERROR - %s could not be opened for capturing.\n", path);
+			deleteCapture();
+			return false;
+		}
+
+		//the chroma samples are each centered between the 4 pixels they cover (see convertToYUV)
+		fprintf(video, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", SCREEN_WIDTH, SCREEN_HEIGHT, FPS);
+	}
+	else if (isFrameNumberPattern(path))
+		format = CF_PNG;
+	else {
+		printf("ERROR - Capture path has to end in .y4m, or have a frame number in it for a PNG sequence (e.g. frames/frame%%05d.png).\n");
+		return false;
+	}
+
+	for (int i = 0; i < CAPTURE_BUFFERS; ++i) {
+		buffers[i].pixels = malloc(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(Uint32));
+		if (buffers[i].pixels == NULL) {
+			printf("ERROR - Capture buffers could not be allocated.\n");
+			deleteCapture();
+			return false;
+		}
+	}
+
+	saverQuit = false;
+	freeBuffers = SDL_CreateSemaphore(CAPTURE_BUFFERS);
+	fullBuffers = SDL_CreateSemaphore(0);
+	saver = freeBuffers != NULL && fullBuffers != NULL ? SDL_CreateThread(captureSaver, "capture", NULL) : NULL;
+	if (saver == NULL)
+		printf("WARNING - Captured frames will be saved on the main thread: %s\n", SDL_GetError());
+
+	outputPath = path;
+	capturing = true;
+	captureStart = SDL_GetPerformanceCounter();
+
+	return true;
+}
+
+//true if path has exactly one frame number in it (%d, optionally with a width, e.g. %05d), and nothing else for snprintf to fill in
+static bool isFrameNumberPattern(const char *path) {
+	int numbers = 0;
+
+	for (const char *c = path; *c != '\0'; ++c) {
+		if (*c != '%')
+			continue;
+
+		//%% is just a percent sign
+		if (*++c == '%')
+			continue;
+
+		while (*c >= '0' && *c <= '9')
+			++c;
+		if (*c != 'd')
+			return false;
+
+		++numbers;
+	}
+
+	return numbers == 1;
+}
+
+//reads the frame that was just drawn into a free buffer, and hands it to the saver
+//call once everything's been drawn, while the scene is still the render target
+void captureFrame(void) {
+	if (!capturing)
+		return;
+
+	//both buffers still being saved means the saver's a whole frame behind, so there's nothing for it but to wait
+	if (saver != NULL && SDL_SemTryWait(freeBuffers) != 0) {
+		++saverWaits;
+		SDL_SemWait(freeBuffers);
+	}
+
+	CaptureBuffer *buffer = &buffers[nextToFill];
+
+	if (SDL_RenderReadPixels(app.renderer, NULL, SDL_PIXELFORMAT_RGBA32, buffer->pixels, SCREEN_WIDTH * sizeof(Uint32)) != 0) {
+		printf("ERROR - Frame %d could not be read back, so capturing stopped: %s\n", framesCaptured, SDL_GetError());
+		if (saver != NULL)
+			SDL_SemPost(freeBuffers);
+		capturing = false;
+		return;
+	}
+
+	buffer->frame = framesCaptured++;
+	nextToFill = (nextToFill + 1) % CAPTURE_BUFFERS;
+
+	if (saver != NULL)
+		SDL_SemPost(fullBuffers);
+	else
+		saveFrame(buffer);
+}
+
+//saves frames in the order they were captured, as they come in
+static int captureSaver(void *data) {
+	(void)data;
+
+	while (true) {
+		SDL_SemWait(fullBuffers);
+		if (saverQuit)
+			return 0;
+
+		saveFrame(&buffers[nextToSave]);
+		nextToSave = (nextToSave + 1) % CAPTURE_BUFFERS;
+		SDL_SemPost(freeBuffers);
+	}
+}
+
+//converts a frame and writes it out
+//after the first frame that can't be saved, the rest are skipped
+static void saveFrame(const CaptureBuffer *buffer) {
+	if (saveFailed)
+		return;
+
+	switch (format) {
+	case(CF_Y4M):
+		convertToYUV(buffer->pixels);
+		if (fputs("FRAME\n", video) < 0 || fwrite(yuv, 1, YUV_FRAME_SIZE, video) != (size_t)YUV_FRAME_SIZE) {
+			printf("ERROR - Frame %d could not be written to %s.\n", buffer->frame, outputPath);
+			saveFailed = true;
+		}
+		break;
+	case(CF_PNG): {
+		//the pattern was checked for having exactly one %d in it by initCapture
+		char filename[MAX_STRING_LENGTH * 2];
+		snprintf(filename, sizeof(filename), outputPath, buffer->frame);
+
+		SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom(buffer->pixels, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SCREEN_WIDTH * sizeof(Uint32), SDL_PIXELFORMAT_RGBA32);
+		if (surface == NULL || IMG_SavePNG(surface, filename) != 0) {
+			printf("ERROR - Frame %d could not be saved to %s: %s\n", buffer->frame, filename, SDL_GetError());
+			saveFailed = true;
+		}
+		SDL_FreeSurface(surface);
+		break;
+	}
+	}
+}
+
+//converts an RGBA32 frame to 4:2:0 Y'CbCr in yuv
+//uses BT.601 with limited range, since that's what players assume a Y4M file is; each chroma sample is worked out from the average of the 2x2 block of pixels it covers
+static void convertToYUV(const Uint32 *pixels) {
+	Uint8 *lumaPlane = yuv;
+	Uint8 *blueChromaPlane = yuv + SCREEN_WIDTH * SCREEN_HEIGHT;
+	Uint8 *redChromaPlane = blueChromaPlane + (SCREEN_WIDTH / 2) * (SCREEN_HEIGHT / 2);
+
+	for (int y = 0; y < SCREEN_HEIGHT; y += 2) {
+		for (int x = 0; x < SCREEN_WIDTH; x += 2) {
+			int r = 0, g = 0, b = 0;
+
+			for (int i = 0; i < 4; ++i) {
+				int pixelX = x + (i & 1);
+				int pixelY = y + (i >> 1);
+				const Uint8 *pixel = (const Uint8 *)&pixels[pixelY * SCREEN_WIDTH + pixelX];
+
+				lumaPlane[pixelY * SCREEN_WIDTH + pixelX] = ((66 * pixel[0] + 129 * pixel[1] + 25 * pixel[2] + 128) >> 8) + 16;
+				r += pixel[0];
+				g += pixel[1];
+				b += pixel[2];
+			}
+
+			r = (r + 2) / 4;
+			g = (g + 2) / 4;
+			b = (b + 2) / 4;
+
+			int chroma = (y / 2) * (SCREEN_WIDTH / 2) + x / 2;
+			blueChromaPlane[chroma] = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+			redChromaPlane[chroma] = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+		}
+	}
+}
+
+//waits for every frame that's been captured to be saved, then stops the saver and frees everything
+void deleteCapture(void) {
+	if (saver != NULL) {
+		for (int i = 0; i < CAPTURE_BUFFERS; ++i)
+			SDL_SemWait(freeBuffers);
+
+		saverQuit = true;
+		SDL_SemPost(fullBuffers);
+		SDL_WaitThread(saver, NULL);
+		saver = NULL;
+	}
+
+	if (outputPath != NULL) {
+		double seconds = (double)(SDL_GetPerformanceCounter() - captureStart) / SDL_GetPerformanceFrequency();
+		printf("Captured %d frames to %s at %.1fx real time (waited on saving %d times).\n", framesCaptured, outputPath, seconds > 0 ? framesCaptured / (double)FPS / seconds : 0, saverWaits);
+	}
+
+	for (int i = 0; i < CAPTURE_BUFFERS; ++i) {
+		free(buffers[i].pixels);
+		buffers[i].pixels = NULL;
+	}
+
+	if (freeBuffers != NULL)
+		SDL_DestroySemaphore(freeBuffers);
+	if (fullBuffers != NULL)
+		SDL_DestroySemaphore(fullBuffers);
+	freeBuffers = NULL;
+	fullBuffers = NULL;
+
+	if (video != NULL)
+		fclose(video);
+	video = NULL;
+	free(yuv);
+	yuv = NULL;
+
+	capturing = false;
+	outputPath = NULL;
+}
\ No newline at end of file
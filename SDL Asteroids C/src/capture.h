@@ -0,0 +1,16 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+/*
+* Frame capture, for trailers, bug reports and comparing runs frame by frame.
+* Run with --capture <path> to save every frame that's shown, either as a raw Y4M video (if path ends in .y4m) or as a PNG sequence
+* (path has a frame number in it, e.g. frames/frame%05d.png). Along with --headless, frames are captured as fast as they can be drawn and saved.
+* Frames are read back into one of two buffers while a worker thread converts and saves the other, so the game only ever waits on saving if it gets a whole frame ahead.
+* With a window, frames are captured from the scene texture before post-processing; headless frames are captured as they're shown.
+*/
+
+bool initCapture(const char *path);
+void captureFrame(void);
+void deleteCapture(void);
+
+#endif
\ No newline at end of file
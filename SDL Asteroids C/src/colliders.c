@@ -1,20 +1,94 @@
 #include "common.h"
 #include "colliders.h"
+#include "debugDraw.h"
+#include "profiler.h"
 #include "float.h"
 
-extern App app; //to check if debug is on for drawing hitboxes
+//entry in the separating axis cache, which remembers how the last separating axis test between two colliders went
+//pairs are hashed straight into a slot; whichever pair was tested last owns it
+typedef struct {
+    uint32_t aID;   //ids of the two colliders; 0 means the slot's empty
+    uint32_t bID;
+    int axis;       //axis that seperated them last time (0-1 = a's axes, 2-3 = b's axes), or -1 if they overlapped
+} SATCacheEntry;
 
-OBBCollider* initOBBCollider(const float xHalfwidth, const float yHalfwidth, const Vector2 origin, const float angle);
+
+OBBCollider* initOBBCollider(const float xHalfwidth, const float yHalfwidth, const Vector2 origin, const float angle, CollisionLayer layer, void *owner);
 void updateCollider(OBBCollider* collider, const float x, const float y, const float angle, const float w, const float h);
-void displayCollider(SDL_Renderer* renderer, const SDL_Color* color, const OBBCollider* collider);
+static void updateExtents(OBBCollider *collider);
+static void addToLayer(OBBCollider *collider);
+static void removeFromLayer(OBBCollider *collider);
+void setColliderLayer(OBBCollider *collider, CollisionLayer layer);
+void setColliderPixelMasks(OBBCollider *collider, const PixelMaskSet *pixelMasks);
+void setCollisionHandler(CollisionLayer a, CollisionLayer b, CollisionHandler handler);
+static bool checkPixelMasks(const OBBCollider *a, const OBBCollider *b);
+static void addContact(OBBCollider *a, OBBCollider *b);
+static void addSATCacheUpdate(const SATCacheEntry *update);
+void detectContacts(void);
+void resolveContacts(void);
+void checkCollisions(void);
+static float queryDistanceSquared(const OBBCollider *collider, Vector2 point, bool wrap);
+int queryRadius(uint32_t layers, Vector2 point, float radius, bool wrap, OBBCollider **results, int maxResults);
+int queryNearest(uint32_t layers, Vector2 point, bool wrap, OBBCollider **results, int k);
+void displayCollider(const SDL_Color *color, const OBBCollider *collider);
+void displayContacts(void);
 bool checkIntersection(const OBBCollider* a, const OBBCollider* b);
+static bool testIntersection(const OBBCollider *a, const OBBCollider *b, SATCacheEntry *cacheUpdate);
+static int getSATCacheSlot(uint32_t aID, uint32_t bID);
+static bool separatedOnAxis(const Vector2 aCorners[4], const Vector2 bCorners[4], const Vector2 *axis);
+void deleteCollider(OBBCollider *collider);
+
+//size of the contact buffer; more contacts than this in one tick get dropped
+#define MAX_CONTACTS 256
+
+//most colliders queryNearest can find in one call
+#define MAX_QUERY_NEAREST 16
+
+//size of the separating axis cache; must be a power of 2
+#define SAT_CACHE_SIZE 512
+
+//most changes to the separating axis cache that can be found in one tick; past this, the rest are dropped (those pairs just miss the cache next tick)
+#define MAX_SAT_CACHE_UPDATES 512
 
 //controls how large the + sign is that represents the origin of an OBB during debug drawing
 static const int DEBUG_ORIGIN_DRAW_SIZE = 10;
+//same for contact points, plus how long the line showing their normal is
+static const int DEBUG_CONTACT_DRAW_SIZE = 3;
+static const int DEBUG_CONTACT_NORMAL_LENGTH = 12;
+
+//pair filter table
+//row N is the bitfield of layers that layer N is allowed to touch; keep it symmetric
+//any pair that isn't in here is thrown out by the broad phase before any geometry gets looked at
+static const uint32_t PAIR_FILTER[CL_MAX] = {
+    [CL_PLAYER] = LAYER_BIT(CL_ENEMY_BULLET) | LAYER_BIT(CL_CRATE) | LAYER_BIT(CL_ENEMY),
+    [CL_PLAYER_BULLET] = LAYER_BIT(CL_CRATE) | LAYER_BIT(CL_ENEMY),
+    [CL_ENEMY_BULLET] = LAYER_BIT(CL_PLAYER),
+    [CL_CRATE] = LAYER_BIT(CL_PLAYER) | LAYER_BIT(CL_PLAYER_BULLET),
+    [CL_ENEMY] = LAYER_BIT(CL_PLAYER) | LAYER_BIT(CL_PLAYER_BULLET),
+    [CL_ENEMY_ENTERING] = 0     //can't be touched until they're in the stage proper
+};
+
+//one linked list of colliders per layer
+static OBBCollider *layerHeads[CL_MAX];
+//response functions for each pair of layers, registered by whichever file owns the entities involved
+static CollisionHandler collisionHandlers[CL_MAX][CL_MAX];
+
+//contacts found this tick, waiting to be resolved
+static Contact contacts[MAX_CONTACTS];
+static int contactCount = 0;
+static int droppedContactCount = 0;   //contacts that didn't fit in the buffer this tick
+static int resolvedContactCount = 0;   //contacts from the last resolveContacts, which stay in the buffer for debug drawing until the next detectContacts
+
+static SATCacheEntry satCache[SAT_CACHE_SIZE];
+//detectContacts only reads the cache; what it learns goes in here, and gets written to the cache by resolveContacts
+static SATCacheEntry satCacheUpdates[MAX_SAT_CACHE_UPDATES];
+static int satCacheUpdateCount = 0;
+static uint32_t nextColliderID = 1;    //ids are never reused, so stale cache entries can't be mistaken for a new pair
 
 //initialize collider
-OBBCollider* initOBBCollider(const float xHalfwidth, const float yHalfwidth, const Vector2 origin, const float angle) {
-    OBBCollider* collider = malloc(sizeof(OBBCollider));
+//colliders are added to their layer's list here, so they get checked by checkCollisions right away
+OBBCollider* initOBBCollider(const float xHalfwidth, const float yHalfwidth, const Vector2 origin, const float angle, CollisionLayer layer, void *owner) {
+    OBBCollider* collider = calloc(1, sizeof(OBBCollider));
 
     //setting axes[0] to equal i and axes[1] to equal j
     collider->axes[0].x = 1;
@@ -26,6 +100,13 @@ OBBCollider* initOBBCollider(const float xHalfwidth, const float yHalfwidth, con
     collider->halfwidths[0] = xHalfwidth;
     collider->halfwidths[1] = yHalfwidth;
     collider->origin = origin;
+    updateExtents(collider);
+
+    collider->layer = layer;
+    collider->mask = PAIR_FILTER[layer];
+    collider->owner = owner;
+    collider->id = nextColliderID++;
+    addToLayer(collider);
 
     return collider;
 }
@@ -53,79 +134,314 @@ void updateCollider(OBBCollider* collider, const float x, const float y, const f
         collider->halfwidths[0] = w;
     if (h > 0)
         collider->halfwidths[1] = h;
+
+    updateExtents(collider);
 }
 
-//display a collision box
-void displayCollider(SDL_Renderer* renderer, const SDL_Color *color, const OBBCollider *collider) {
-    //only draw this if debug has been set to true
-    if (!app.debug) {
+//finds the half width and half height of the axis-aligned box that fits around a collider
+//axes must be absolute valued for this to work
+static void updateExtents(OBBCollider *collider) {
+    collider->extents.x = fabs(collider->axes[0].x) * collider->halfwidths[0] + fabs(collider->axes[1].x) * collider->halfwidths[1];
+    collider->extents.y = fabs(collider->axes[0].y) * collider->halfwidths[0] + fabs(collider->axes[1].y) * collider->halfwidths[1];
+}
+
+//pushes a collider onto the front of its layer's list
+static void addToLayer(OBBCollider *collider) {
+    collider->prev = NULL;
+    collider->next = layerHeads[collider->layer];
+    if (collider->next != NULL)
+        collider->next->prev = collider;
+    layerHeads[collider->layer] = collider;
+}
+
+//unlinks a collider from its layer's list
+static void removeFromLayer(OBBCollider *collider) {
+    if (collider->prev != NULL)
+        collider->prev->next = collider->next;
+    else
+        layerHeads[collider->layer] = collider->next;
+    if (collider->next != NULL)
+        collider->next->prev = collider->prev;
+
+    collider->prev = collider->next = NULL;
+}
+
+//moves a collider to a different layer and resets its mask to that layer's defaults
+//don't call this from inside a collision handler
+void setColliderLayer(OBBCollider *collider, CollisionLayer layer) {
+    removeFromLayer(collider);
+    collider->layer = layer;
+    collider->mask = PAIR_FILTER[layer];
+    addToLayer(collider);
+}
+
+//gives a collider pixel-accurate masks (pass in NULL to go back to using just the box)
+//the collider's box should cover the whole sprite, since the masks are only checked once the boxes touch
+void setColliderPixelMasks(OBBCollider *collider, const PixelMaskSet *pixelMasks) {
+    collider->pixelMasks = pixelMasks;
+}
+
+//registers the function to be called when colliders on layers a and b touch
+//only register a pair once (in either order); pass in NULL to stop handling a pair
+void setCollisionHandler(CollisionLayer a, CollisionLayer b, CollisionHandler handler) {
+    collisionHandlers[a][b] = handler;
+}
+
+//pixel-accurate follow-up to checkIntersection for colliders that have masks
+//if only one collider has masks, its solid pixels are checked against the other's box
+static bool checkPixelMasks(const OBBCollider *a, const OBBCollider *b) {
+    if (a->pixelMasks == NULL && b->pixelMasks == NULL)
+        return true;
+
+    if (b->pixelMasks == NULL)
+        return checkPixelMaskOverlapsBox(getRotatedPixelMask(a->pixelMasks, &a->axes[0]), (int)a->origin.x, (int)a->origin.y, b->axes, b->halfwidths, b->origin);
+    if (a->pixelMasks == NULL)
+        return checkPixelMaskOverlapsBox(getRotatedPixelMask(b->pixelMasks, &b->axes[0]), (int)b->origin.x, (int)b->origin.y, a->axes, a->halfwidths, a->origin);
+
+    return checkPixelMasksOverlap(getRotatedPixelMask(a->pixelMasks, &a->axes[0]), (int)a->origin.x, (int)a->origin.y,
+                                  getRotatedPixelMask(b->pixelMasks, &b->axes[0]), (int)b->origin.x, (int)b->origin.y);
+}
+
+//fills out a contact for two intersecting colliders and pushes it onto the contact buffer
+static void addContact(OBBCollider *a, OBBCollider *b) {
+    //detectContacts warns about these once it's done
+    if (contactCount >= MAX_CONTACTS) {
+        ++droppedContactCount;
         return;
     }
 
-    //set render draw color
-    SDL_SetRenderDrawColor(renderer, color->r, color->g, color->b, color->a);
+    Contact *contact = &contacts[contactCount++];
+    contact->a = a;
+    contact->b = b;
 
-    //draw the outline of the collider
+    //a's origin in b's local space
+    Vector2 relativeOrigin = addVec2(a->origin, scalarMultVec2(b->origin, -1));
+    float dist0 = dotProduct(&relativeOrigin, &b->axes[0]);
+    float dist1 = dotProduct(&relativeOrigin, &b->axes[1]);
+
+    //the normal is whichever of b's axes a's origin is further out along (relative to b's size on that axis)
+    if (fabs(dist0) * b->halfwidths[1] >= fabs(dist1) * b->halfwidths[0])
+        contact->normal = scalarMultVec2(b->axes[0], dist0 < 0 ? -1 : 1);
+    else
+        contact->normal = scalarMultVec2(b->axes[1], dist1 < 0 ? -1 : 1);
+
+    //clamp a's origin into b to get the contact point
+    dist0 = MAX(-b->halfwidths[0], MIN(dist0, b->halfwidths[0]));
+    dist1 = MAX(-b->halfwidths[1], MIN(dist1, b->halfwidths[1]));
+    contact->point = addVec2(b->origin, addVec2(scalarMultVec2(b->axes[0], dist0), scalarMultVec2(b->axes[1], dist1)));
+}
+
+//queues up a change to the separating axis cache for resolveContacts to make
+static void addSATCacheUpdate(const SATCacheEntry *update) {
+    if (satCacheUpdateCount < MAX_SAT_CACHE_UPDATES)
+        satCacheUpdates[satCacheUpdateCount++] = *update;
+}
+
+//detection half of checkCollisions: finds every touching pair of colliders and writes them into the contact buffer
+//nothing about the game changes until resolveContacts is called; the only things this writes to are its own output (the contacts, and changes for the separating axis cache)
+//and the profiler counters, so it can run on a worker thread alongside anything that doesn't move colliders around (resolveContacts has to wait for it to finish)
+//layer pairs without a handler or that the pair filter table rules out are never looked at,
+//then per-collider masks and bounding boxes are checked before handing things off to the separating axis test,
+//and colliders with pixel masks get a final per-pixel check
+void detectContacts(void) {
+    OBBCollider *a, *b;
+
+    contactCount = resolvedContactCount = droppedContactCount = 0;
+    satCacheUpdateCount = 0;
+
+    for (int layerA = 0; layerA < CL_MAX; ++layerA) {
+        for (int layerB = 0; layerB < CL_MAX; ++layerB) {
+            if (collisionHandlers[layerA][layerB] == NULL || !(PAIR_FILTER[layerA] & LAYER_BIT(layerB)))
+                continue;
+
+            for (a = layerHeads[layerA]; a != NULL; a = a->next) {
+                for (b = layerHeads[layerB]; b != NULL; b = b->next) {
+                    //per-collider filtering (e.g. a dead player's mask is 0)
+                    if (!(a->mask & LAYER_BIT(b->layer)) || !(b->mask & LAYER_BIT(a->layer)))
+                        continue;
+
+                    //bounding box check
+                    if (fabs(a->origin.x - b->origin.x) > a->extents.x + b->extents.x || fabs(a->origin.y - b->origin.y) > a->extents.y + b->extents.y)
+                        continue;
+
+                    SATCacheEntry cacheUpdate;
+                    bool intersecting = testIntersection(a, b, &cacheUpdate);
+                    if (cacheUpdate.aID != 0)
+                        addSATCacheUpdate(&cacheUpdate);
 
-    //a collection of points representing the rectangle
-    //5 points are given because SDL_RenderDrawLines draws (count - 1) lines (think of it as a graph)
-    //the rectangle's points are treated as vectors and rotated using the standard rotation matrix
-    SDL_Point rectangle[5] = { vec2ToSDL_Point(addVec2(addVec2(scalarMultVec2(collider->axes[0],collider->halfwidths[0]), scalarMultVec2(collider->axes[1], collider->halfwidths[1])), collider->origin)),      //bottom right point
-                                vec2ToSDL_Point(addVec2(addVec2(scalarMultVec2(collider->axes[0], -collider->halfwidths[0]), scalarMultVec2(collider->axes[1], collider->halfwidths[1])), collider->origin)),     //bottom left point
-                                vec2ToSDL_Point(addVec2(addVec2(scalarMultVec2(collider->axes[0], -collider->halfwidths[0]), scalarMultVec2(collider->axes[1], -collider->halfwidths[1])), collider->origin)),    //top left point
-                                vec2ToSDL_Point(addVec2(addVec2(scalarMultVec2(collider->axes[0], collider->halfwidths[0]), scalarMultVec2(collider->axes[1], -collider->halfwidths[1])), collider->origin)),     //top right point
-                                vec2ToSDL_Point(addVec2(addVec2(scalarMultVec2(collider->axes[0], collider->halfwidths[0]), scalarMultVec2(collider->axes[1], collider->halfwidths[1])), collider->origin)), };    //bottom right point
-    SDL_RenderDrawLines(renderer, rectangle, 5);
-    /*SDL_RenderDrawLine(renderer, rectangle[0].x, rectangle[0].y, collider->origin.x, collider->origin.y);
-    SDL_RenderDrawLine(renderer, rectangle[1].x, rectangle[1].y, collider->origin.x, collider->origin.y);
-    SDL_RenderDrawLine(renderer, rectangle[2].x, rectangle[2].y, collider->origin.x, collider->origin.y);
-    SDL_RenderDrawLine(renderer, rectangle[3].x, rectangle[3].y, collider->origin.x, collider->origin.y);*/
-
-    //more debug
-    //printf("(%d, %d), (%d, %d), (%d, %d), (%d, %d)\n", rectangle[0].x, rectangle[0].y, rectangle[1].x, rectangle[1].y, rectangle[2].x, rectangle[2].y, rectangle[3].x, rectangle[3].y);
+                    if (intersecting && checkPixelMasks(a, b))
+                        addContact(a, b);
+                }
+            }
+        }
+    }
+
+    if (droppedContactCount > 0)
+        printf("WARNING - Contact buffer full. Dropped %d contacts. Raise MAX_CONTACTS.\n", droppedContactCount);
+}
+
+//response half of checkCollisions: hands each contact in the buffer to its pair's handler, in the order they were found
+//also writes what detectContacts learned about which axes separate which pairs into the separating axis cache, for next tick
+void resolveContacts(void) {
+    for (int i = 0; i < satCacheUpdateCount; ++i)
+        satCache[getSATCacheSlot(satCacheUpdates[i].aID, satCacheUpdates[i].bID)] = satCacheUpdates[i];
+    satCacheUpdateCount = 0;
+
+    for (int i = 0; i < contactCount; ++i)
+        collisionHandlers[contacts[i].a->layer][contacts[i].b->layer](&contacts[i]);
+
+    resolvedContactCount = contactCount;
+    contactCount = 0;
+}
+
+//finds and responds to every collision in the game
+//call once per tick, after everything has moved
+void checkCollisions(void) {
+    detectContacts();
+    resolveContacts();
+}
+
+//spatial queries
+//these look for colliders on any of the layers in the layers bitfield (use LAYER_BIT), measuring to the colliders' origins
+//colliders with an empty mask (e.g. a dead player) are switched off and never show up in results
+//with wrap on, distances are measured the short way around the screen, since everything screenwraps
+//results are written into an array supplied by the caller; get the owner of each collider to do anything with it
+
+//distance squared from a point to a collider for the spatial queries
+static float queryDistanceSquared(const OBBCollider *collider, Vector2 point, bool wrap) {
+    if (wrap)
+        return wrappedDistanceSquared(point.x, point.y, collider->origin.x, collider->origin.y, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    return distanceSquared(point.x, point.y, collider->origin.x, collider->origin.y);
+}
+
+//finds up to maxResults colliders within radius of a point (in no particular order)
+//returns the number of colliders found
+int queryRadius(uint32_t layers, Vector2 point, float radius, bool wrap, OBBCollider **results, int maxResults) {
+    int found = 0;
+    float radiusSquared = radius * radius;
+
+    for (int layer = 0; layer < CL_MAX; ++layer) {
+        if (!(layers & LAYER_BIT(layer)))
+            continue;
+
+        for (OBBCollider *collider = layerHeads[layer]; collider != NULL; collider = collider->next) {
+            if (found >= maxResults)
+                return found;
+
+            if (collider->mask != 0 && queryDistanceSquared(collider, point, wrap) < radiusSquared)
+                results[found++] = collider;
+        }
+    }
+
+    return found;
+}
+
+//finds the k colliders closest to a point, closest first
+//returns the number of colliders found (less than k if there aren't k colliders on those layers)
+int queryNearest(uint32_t layers, Vector2 point, bool wrap, OBBCollider **results, int k) {
+    int found = 0;
+    float distances[MAX_QUERY_NEAREST];
+
+    if (k > MAX_QUERY_NEAREST) {
+        printf("WARNING - queryNearest can only find up to %d colliders at once.\n", MAX_QUERY_NEAREST);
+        k = MAX_QUERY_NEAREST;
+    }
+
+    for (int layer = 0; layer < CL_MAX; ++layer) {
+        if (!(layers & LAYER_BIT(layer)))
+            continue;
+
+        for (OBBCollider *collider = layerHeads[layer]; collider != NULL; collider = collider->next) {
+            if (collider->mask == 0)
+                continue;
+
+            float distance = queryDistanceSquared(collider, point, wrap);
+
+            //skip anything further than the furthest of a full set of results
+            if (found == k && distance >= distances[k - 1])
+                continue;
+
+            //insertion sort it into the results, dropping the furthest one if they're full
+            int i = (found < k) ? found++ : k - 1;
+            while (i > 0 && distances[i - 1] > distance) {
+                distances[i] = distances[i - 1];
+                results[i] = results[i - 1];
+                --i;
+            }
+            distances[i] = distance;
+            results[i] = collider;
+        }
+    }
+
+    return found;
+}
+
+//display a collision box, along with the box the broad phase sees around it
+//only happens if app.debug = true (see debugDraw.h)
+void displayCollider(const SDL_Color *color, const OBBCollider *collider) {
+    if (isDebugDrawEnabled(DDC_BROAD_PHASE))
+        debugDrawRect(DDC_BROAD_PHASE, collider->origin.x - collider->extents.x, collider->origin.y - collider->extents.y, collider->extents.x * 2, collider->extents.y * 2, COLOR_PURPLE);
+
+    if (!isDebugDrawEnabled(DDC_COLLIDERS))
+        return;
+
+    //draw the outline of the collider
+    //the rectangle's corners are treated as vectors along the collider's axes, going around from the bottom right
+    Vector2 corners[4];
+    for (int i = 0; i < 4; ++i) {
+        float signX = (i == 0 || i == 3) ? 1 : -1;
+        float signY = (i == 0 || i == 1) ? 1 : -1;
+        corners[i] = addVec2(addVec2(scalarMultVec2(collider->axes[0], signX * collider->halfwidths[0]), scalarMultVec2(collider->axes[1], signY * collider->halfwidths[1])), collider->origin);
+    }
+    for (int i = 0; i < 4; ++i)
+        debugDrawLine(DDC_COLLIDERS, corners[i].x, corners[i].y, corners[(i + 1) % 4].x, corners[(i + 1) % 4].y, *color);
 
     //draw the center of rotation as a +
-    SDL_RenderDrawLine(renderer, collider->origin.x - DEBUG_ORIGIN_DRAW_SIZE, collider->origin.y, collider->origin.x + DEBUG_ORIGIN_DRAW_SIZE, collider->origin.y);
-    SDL_RenderDrawLine(renderer, collider->origin.x, collider->origin.y - DEBUG_ORIGIN_DRAW_SIZE, collider->origin.x, collider->origin.y + DEBUG_ORIGIN_DRAW_SIZE);
+    debugDrawCross(DDC_COLLIDERS, collider->origin.x, collider->origin.y, DEBUG_ORIGIN_DRAW_SIZE, *color);
+}
+
+//display where the contacts from the last checkCollisions were, with a line along each one's normal
+//only happens if app.debug = true (see debugDraw.h)
+void displayContacts(void) {
+    if (!isDebugDrawEnabled(DDC_COLLIDERS))
+        return;
 
-    //reset renderer draw color to black
-    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+    for (int i = 0; i < resolvedContactCount; ++i) {
+        Vector2 normalEnd = addVec2(contacts[i].point, scalarMultVec2(contacts[i].normal, DEBUG_CONTACT_NORMAL_LENGTH));
+        debugDrawCross(DDC_COLLIDERS, contacts[i].point.x, contacts[i].point.y, DEBUG_CONTACT_DRAW_SIZE, COLOR_ORANGE);
+        debugDrawLine(DDC_COLLIDERS, contacts[i].point.x, contacts[i].point.y, normalEnd.x, normalEnd.y, COLOR_ORANGE);
+    }
 }
 
 //check intersection between two OBB colliders
 //first, check if the distance between the centers of the two boxes is less than the sum of the "radii" of the rectangles
 // (the radii being the diagonal distance from the center of the box to one of its corners)
 //if the distance is less than that, use seperating axes therorem to detect a collision
+//the axis that seperated the pair last time is tried first (see the separating axis cache)
+//only reads the cache; use this for one-off tests outside of detectContacts
 bool checkIntersection(const OBBCollider* a, const OBBCollider* b) {
+    SATCacheEntry cacheUpdate;
+
+    return testIntersection(a, b, &cacheUpdate);
+}
+
+//does the work for checkIntersection
+//if the pair's cache entry should change, cacheUpdate is filled in with the new entry; otherwise its aID is set to 0
+static bool testIntersection(const OBBCollider *a, const OBBCollider *b, SATCacheEntry *cacheUpdate) {
+    cacheUpdate->aID = 0;
+
     //radius-distance check for optimization
     //the "radius" is the distance from the center of a box to one of its corners
-
-    //variable setup (axes must be passed in as absolute valued vectors for the radii calculations to work properly)
-    Vector2* aR = malloc(sizeof(Vector2));
-    Vector2* bR = malloc(sizeof(Vector2));
-    Vector2* sumARBR = malloc(sizeof(Vector2));
-    aR->x = fabs(a->axes[0].x) * a->halfwidths[0] + fabs(a->axes[1].x) * a->halfwidths[1];
-    aR->y = fabs(a->axes[0].y) * a->halfwidths[0] + fabs(a->axes[1].y) * a->halfwidths[1];
-    bR->x = fabs(b->axes[0].x) * b->halfwidths[0] + fabs(b->axes[1].x) * b->halfwidths[1];
-    bR->y = fabs(b->axes[0].y) * b->halfwidths[0] + fabs(b->axes[1].y) * b->halfwidths[1];
-    sumARBR->x = aR->x + bR->x;
-    sumARBR->y = aR->y + bR->y;
-    float* radiusSumSquared = malloc(sizeof(float));
-    *radiusSumSquared = dotProduct(sumARBR, sumARBR);   //dot product of a vector with itself is its magnitude squared
-    float* centerDistanceSquared = malloc(sizeof(float));
-    *centerDistanceSquared = distanceSquared(a->origin.x, a->origin.y, b->origin.x, b->origin.y);
+    //(the extents are the absolute valued axes scaled by the halfwidths, which is what the radii calculations need)
+    Vector2 sumARBR = addVec2(a->extents, b->extents);
+    float radiusSumSquared = dotProduct(&sumARBR, &sumARBR);   //dot product of a vector with itself is its magnitude squared
+    float centerDistanceSquared = distanceSquared(a->origin.x, a->origin.y, b->origin.x, b->origin.y);
 
     //distance check
-    if (*radiusSumSquared < *centerDistanceSquared)
+    if (radiusSumSquared < centerDistanceSquared)
         return false;
 
-    //clean up now-unneeded variables from radius-distance check
-    free(aR);
-    free(bR);
-    free(sumARBR);
-    free(radiusSumSquared);    
-    free(centerDistanceSquared);
-
     //store the points of each collider as vectors to use in projection
     Vector2 aCorners[4];
     aCorners[0].x = (a->axes[0].x * a->halfwidths[0] + a->axes[1].x * a->halfwidths[1]) + a->origin.x;   //bottom right point
@@ -147,89 +463,73 @@ bool checkIntersection(const OBBCollider* a, const OBBCollider* b) {
     bCorners[3].x = (b->axes[0].x * b->halfwidths[0] + b->axes[1].x * -b->halfwidths[1]) + b->origin.x;   //top right point
     bCorners[3].y = (b->axes[0].y * b->halfwidths[0] + b->axes[1].y * -b->halfwidths[1]) + b->origin.y;
 
-    //values for storing dot products of projection values of both boxes
-    float   aCurrentProjection, aMaxProjection, aMinProjection,
-        bCurrentProjection, bMaxProjection, bMinProjection;
-    //vector that holds projections
-    Vector2 projVec;
-
-    //go through all four axes, checking for overlap
-    //a's axes
-    for (int i = 0; i < 2; i++) {
-        //initialize/reset maximums and minimums
-        aMaxProjection = -FLT_MAX; aMinProjection = FLT_MAX;
-        bMaxProjection = -FLT_MAX; bMinProjection = FLT_MAX;
-        //for each corner of each box, project that corner onto the current axis
-        //then find the dot product of that projected vector with the current axis
-        //the resulting value relates to the corner's position on the line
-        //by comparing the maximums and minimums of those values for each box, we can determine intersection on an axis
-        for (int j = 0; j < 4; j++) {
-            projVec = projectVector(&aCorners[j], &(a->axes[i]));
-            aCurrentProjection = dotProduct(&(a->axes[i]), &projVec);
-            //find max/min
-            if (aCurrentProjection > aMaxProjection)
-                aMaxProjection = aCurrentProjection;
-            if (aCurrentProjection < aMinProjection)
-                aMinProjection = aCurrentProjection;
-        }
-        for (int j = 0; j < 4; j++) {
-            projVec = projectVector(&bCorners[j], &(a->axes[i]));
-            bCurrentProjection = dotProduct(&(a->axes[i]), &projVec);
-            //find max/min
-            if (bCurrentProjection > bMaxProjection)
-                bMaxProjection = bCurrentProjection;
-            if (bCurrentProjection < bMinProjection)
-                bMinProjection = bCurrentProjection;
-        }
+    //the four candidate separating axes, indexed the same way as the separating axis cache
+    const Vector2 *axes[4] = { &a->axes[0], &a->axes[1], &b->axes[0], &b->axes[1] };
 
-        //check for overlap of points on the axis projected to
-        //if there's no overlap on even a single axis, there's no collision
-        if (aMinProjection > bMaxProjection)
-            return false;
-        if (bMinProjection > aMaxProjection)
-            return false;
+    //look up what happened the last time these two were tested
+    //most pairs that got this far and didn't touch last tick are still seperated along the same axis
+    const SATCacheEntry *entry = &satCache[getSATCacheSlot(a->id, b->id)];
+    bool cached = entry->aID == a->id && entry->bID == b->id;
+    int cachedAxis = cached ? entry->axis : -1;
+
+    addToProfilerCounter(PC_SAT_TESTS, 1);
+
+    if (cachedAxis >= 0 && separatedOnAxis(aCorners, bCorners, axes[cachedAxis])) {
+        addToProfilerCounter(PC_SAT_CACHE_HITS, 1);
+        return false;
     }
-    //b's axes
-    for (int i = 0; i < 2; i++) {
-        //reset maximums and minimums
-        aMaxProjection = -FLT_MAX; aMinProjection = FLT_MAX;
-        bMaxProjection = -FLT_MAX; bMinProjection = FLT_MAX;
-        //for each corner of each box, project that corner onto the current axis
-        //then find the dot product of that projected vector with the current axis
-        //the resulting value relates to the corner's position on the line
-        //by comparing the maximums and minimums of those values for each box, we can determine intersection on an axis
-        for (int j = 0; j < 4; j++) {
-            projVec = projectVector(&aCorners[j], &(b->axes[i]));
-            aCurrentProjection = dotProduct(&(b->axes[i]), &projVec);
-            //find max/min
-            if (aCurrentProjection > aMaxProjection)
-                aMaxProjection = aCurrentProjection;
-            if (aCurrentProjection < aMinProjection)
-                aMinProjection = aCurrentProjection;
-        }
-        for (int j = 0; j < 4; j++) {
-            projVec = projectVector(&bCorners[j], &(b->axes[i]));
-            bCurrentProjection = dotProduct(&(b->axes[i]), &projVec);
-            //find max/min
-            if (bCurrentProjection > bMaxProjection)
-                bMaxProjection = bCurrentProjection;
-            if (bCurrentProjection < bMinProjection)
-                bMinProjection = bCurrentProjection;
+
+    //cache miss (or they overlapped last time); go through the rest of the axes, checking for overlap
+    //if there's no overlap on even a single axis, there's no collision
+    int separatingAxis = -1;    //stays -1 if there's overlap on all four axes; collision detected.
+    for (int i = 0; i < 4; i++) {
+        if (i != cachedAxis && separatedOnAxis(aCorners, bCorners, axes[i])) {
+            separatingAxis = i;
+            break;
         }
+    }
+
+    if (!cached || separatingAxis != cachedAxis)
+        *cacheUpdate = (SATCacheEntry){ a->id, b->id, separatingAxis };
+
+    return separatingAxis == -1;
+}
+
+//which slot of the separating axis cache a pair of colliders goes in
+static int getSATCacheSlot(uint32_t aID, uint32_t bID) {
+    return ((aID * 2654435761u) ^ bID) & (SAT_CACHE_SIZE - 1);
+}
+
+//checks whether two boxes' corners can be seperated along a (unit length) axis
+//for each corner of each box, find the dot product of that corner with the axis
+//the resulting value relates to the corner's position on the line
+//by comparing the maximums and minimums of those values for each box, we can determine intersection on an axis
+static bool separatedOnAxis(const Vector2 aCorners[4], const Vector2 bCorners[4], const Vector2 *axis) {
+    float aMaxProjection = -FLT_MAX, aMinProjection = FLT_MAX,
+        bMaxProjection = -FLT_MAX, bMinProjection = FLT_MAX;
+    float currentProjection;
+
+    for (int j = 0; j < 4; j++) {
+        currentProjection = dotProduct(&aCorners[j], axis);
+        //find max/min
+        if (currentProjection > aMaxProjection)
+            aMaxProjection = currentProjection;
+        if (currentProjection < aMinProjection)
+            aMinProjection = currentProjection;
 
-        //check for overlap of points on the axis projected to
-        //if there's no overlap on even a single axis, there's no collision
-        if (aMinProjection > bMaxProjection)
-            return false;
-        if (bMinProjection > aMaxProjection)
-            return false;
+        currentProjection = dotProduct(&bCorners[j], axis);
+        if (currentProjection > bMaxProjection)
+            bMaxProjection = currentProjection;
+        if (currentProjection < bMinProjection)
+            bMinProjection = currentProjection;
     }
 
-    //there's overlap on all four axes; collision detected.
-    return true;
+    //check for overlap of points on the axis projected to
+    return aMinProjection > bMaxProjection || bMinProjection > aMaxProjection;
 }
 
-//deallocate collider
+//take a collider out of its layer and deallocate it
 void deleteCollider(OBBCollider *collider) {
+    removeFromLayer(collider);
     free(collider);
 }
\ No newline at end of file
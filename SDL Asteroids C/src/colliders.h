@@ -2,25 +2,77 @@
 #define COLLIDERS_H
 
 #include "geometry.h"
+#include "pixelMasks.h"
 
 /*
 * Structs and functions related to collisions
-* Don't forget: these colliders are malloced, so make sure to free them
+* Don't forget: these colliders are malloced, so make sure to free them with deleteCollider
 */
 
+//collision layers; every collider sits on exactly one of these
+//CL stands for collision layer
+typedef enum {
+	CL_PLAYER,
+	CL_PLAYER_BULLET,
+	CL_ENEMY_BULLET,
+	CL_CRATE,
+	CL_ENEMY,
+	CL_ENEMY_ENTERING,	//enemies that are still flying in from offscreen and can't be touched yet
+
+	CL_MAX
+} CollisionLayer;
+
+//turns a layer into its bit for use in collider masks
+#define LAYER_BIT(layer) (1u << (layer))
+
 //Oriented bounding box collider
-typedef struct {
+typedef struct OBBCollider OBBCollider;
+struct OBBCollider {
 	//two axes which store orientation
 	Vector2 axes[2];		//local x and y axes (x = axes[0], y = axes[1])
 	//width and height of the bounding box
 	float halfwidths[2];	//Positive halfwidths along x and y axes (x = halfwidths[0], y = halfwidths[1])
 	//center of the collider
 	Vector2 origin;
-} OBBCollider;
+	Vector2 extents;		//half width and half height of the axis-aligned box around this collider (used by the broad phase)
+
+	//filtering
+	CollisionLayer layer;	//the layer this collider is on
+	uint32_t mask;			//bitfield of the layers this collider can touch (starts as its layer's row of the pair filter table)
+	void *owner;			//the bullet, crate, enemy etc. this collider belongs to
+	uint32_t id;			//unique to this collider for the whole run of the game
+	const PixelMaskSet *pixelMasks;	//if not NULL, the box only counts as a hit if these masks' solid pixels touch too
+	OBBCollider *prev;		//colliders are kept in one doubly linked list per layer
+	OBBCollider *next;
+};
+
+//a touch between two colliders
+//written by detectContacts and handed to the pair's handler by resolveContacts
+typedef struct {
+	OBBCollider *a;		//always on the first layer the handler was registered with
+	OBBCollider *b;		//always on the second layer
+	Vector2 normal;		//unit vector along whichever of b's axes a is furthest out on, pointing from b towards a
+	Vector2 point;		//a's origin clamped into b; roughly where the two touched
+} Contact;
+
+//called once for every contact between colliders on a pair of layers
+//contacts are found before any handler runs, so handlers may see contacts for owners that an earlier handler already used up (check hp, ttl, etc.)
+//handlers must not delete either collider; flag the owner for deletion (hp, ttl, etc.) instead
+typedef void (*CollisionHandler)(const Contact *contact);
 
-OBBCollider* initOBBCollider(const float xHalfwidth, const float yHalfwidth, const Vector2 origin, const float angle);
+OBBCollider* initOBBCollider(const float xHalfwidth, const float yHalfwidth, const Vector2 origin, const float angle, CollisionLayer layer, void *owner);
 void updateCollider(OBBCollider* collider, const float x, const float y, const float angle, const float w, const float h);
-void displayCollider(SDL_Renderer* renderer, const SDL_Color* color, const OBBCollider* collider);
+void setColliderLayer(OBBCollider *collider, CollisionLayer layer);
+void setColliderPixelMasks(OBBCollider *collider, const PixelMaskSet *pixelMasks);
+void setCollisionHandler(CollisionLayer a, CollisionLayer b, CollisionHandler handler);
+void detectContacts(void);
+void resolveContacts(void);
+void checkCollisions(void);
+int queryRadius(uint32_t layers, Vector2 point, float radius, bool wrap, OBBCollider **results, int maxResults);
+int queryNearest(uint32_t layers, Vector2 point, bool wrap, OBBCollider **results, int k);
+void displayCollider(const SDL_Color *color, const OBBCollider *collider);
+void displayContacts(void);
 bool checkIntersection(const OBBCollider *a, const OBBCollider *b);
+void deleteCollider(OBBCollider *collider);
 
 #endif
@@ -0,0 +1,164 @@
+#include "common.h"
+
+#include "composites.h"
+
+extern App app;
+
+bool initComposites(void);
+void bakeComposites(void);
+SpriteAnimated *initCompositeSprite(CompositeSprite composite);
+CompositeSprite getCompositeSprite(const SpriteAnimated *sprite);
+int getHitflashLevel(int timeSinceDamaged);
+void deleteComposites(void);
+
+//how a composite is put together from sprites in the sprite table (which the packer trims the same, so they line up)
+//base and top are drawn opaque; the overlay's alpha goes from minAlpha at the first level to maxAlpha at the last
+typedef struct {
+	SpriteId base;
+	SpriteId overlay;
+	SpriteId top;		//SPR_MAX for no top layer
+	int levels;
+	int minAlpha;
+	int maxAlpha;
+	SpriteDef def;		//where the composite's levels are on the page (set by initComposites)
+} CompositeRecipe;
+
+//the weakest hitflash level isn't 0, since no hitflash at all is just the normal sprite
+static CompositeRecipe recipes[CS_MAX] = {
+	[CS_CRATE_LARGE_HITFLASH] = { SPR_CRATE_LARGE, SPR_CRATE_LARGE_HITFLASH, SPR_MAX, HITFLASH_LEVELS, 255 / HITFLASH_LEVELS, 255 },
+	[CS_CRATE_MEDIUM_HITFLASH] = { SPR_CRATE_MEDIUM, SPR_CRATE_MEDIUM_HITFLASH, SPR_MAX, HITFLASH_LEVELS, 255 / HITFLASH_LEVELS, 255 },
+	[CS_CRATE_SMALL_HITFLASH] = { SPR_CRATE_SMALL, SPR_CRATE_SMALL_HITFLASH, SPR_MAX, HITFLASH_LEVELS, 255 / HITFLASH_LEVELS, 255 },
+	[CS_ENEMY_HITFLASH] = { SPR_ENEMY, SPR_ENEMY_HITFLASH, SPR_MAX, HITFLASH_LEVELS, 255 / HITFLASH_LEVELS, 255 },
+	[CS_POWERUP_NORMAL] = { SPR_POWERUP_CELL, SPR_POWERUP_SHINE, SPR_POWERUP_LETTER_N, POWERUP_SHINE_LEVELS, 0, 254 },
+	[CS_POWERUP_ERRATIC] = { SPR_POWERUP_CELL, SPR_POWERUP_SHINE, SPR_POWERUP_LETTER_E, POWERUP_SHINE_LEVELS, 0, 254 },
+	[CS_POWERUP_BOUNCER] = { SPR_POWERUP_CELL, SPR_POWERUP_SHINE, SPR_POWERUP_LETTER_B, POWERUP_SHINE_LEVELS, 0, 254 },
+	[CS_POWERUP_SHOTGUN] = { SPR_POWERUP_CELL, SPR_POWERUP_SHINE, SPR_POWERUP_LETTER_S, POWERUP_SHINE_LEVELS, 0, 254 },
+};
+
+static SpriteAtlas *page = NULL;
+
+//lays out the composite page and bakes it
+//call after the gameplay sprites are loaded
+bool initComposites(void) {
+	int pageW = 0, pageH = 0;
+
+	//each composite gets its own rows, with its levels going left to right like the frames of an animation
+	for (int i = 0; i < CS_MAX; ++i) {
+		const SpriteDef *base = &SPRITE_TABLE[recipes[i].base];
+		recipes[i].def = (SpriteDef){ 0, pageH, base->w, base->h, base->pivotX, base->pivotY, recipes[i].levels, 0, AL_ONESHOT };
+		pageH += base->h;
+		pageW = MAX(pageW, base->w * recipes[i].levels);
+	}
+
+	//blitSpriteAnimatedEX won't draw the last frame of an animation that touches the right edge of its atlas, so leave a spare column
+	++pageW;
+
+	page = calloc(1, sizeof(SpriteAtlas));
+	page->w = pageW;
+	page->h = pageH;
+	page->texture = SDL_CreateTexture(app.renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, page->w, page->h);
+
+	if (page->texture == NULL) {
+		printf("ERROR - Composite sprite page could not be created: %s\n", SDL_GetError());
+		free(page);
+		page = NULL;
+		return false;
+	}
+	SDL_SetTextureBlendMode(page->texture, SDL_BLENDMODE_BLEND);
+
+	bakeComposites();
+
+	return true;
+}
+
+//draws every level of every composite into the page
+//has to be called again if the renderer loses the contents of its target textures
+void bakeComposites(void) {
+	if (page == NULL || app.gameplaySprites == NULL)
+		return;
+
+	SDL_Texture *source = app.gameplaySprites->texture;
+	SDL_BlendMode blendMode;
+	SDL_GetTextureBlendMode(source, &blendMode);
+
+	//draw anything queued so far to wherever it was going, then switch over to the page
+	flushRenderQueue();
+	SDL_Texture *target = SDL_GetRenderTarget(app.renderer);
+	SDL_SetRenderTarget(app.renderer, page->texture);
+	SDL_SetRenderDrawColor(app.renderer, 0x0, 0x0, 0x0, 0x0);
+	SDL_RenderClear(app.renderer);
+
+	for (int i = 0; i < CS_MAX; ++i) {
+		const CompositeRecipe *recipe = &recipes[i];
+		int w = recipe->def.w;
+		int h = recipe->def.h;
+		int offsetX = app.gameplaySprites->offsetX;
+		int offsetY = app.gameplaySprites->offsetY;
+		SDL_Rect base = { offsetX + SPRITE_TABLE[recipe->base].x, offsetY + SPRITE_TABLE[recipe->base].y, w, h };
+		SDL_Rect overlay = { offsetX + SPRITE_TABLE[recipe->overlay].x, offsetY + SPRITE_TABLE[recipe->overlay].y, w, h };
+		SDL_Rect top = { 0, 0, w, h };
+		if (recipe->top != SPR_MAX) {
+			top.x = offsetX + SPRITE_TABLE[recipe->top].x;
+			top.y = offsetY + SPRITE_TABLE[recipe->top].y;
+		}
+
+		for (int level = 0; level < recipe->levels; ++level) {
+			SDL_Rect dest = { level * w, recipe->def.y, w, h };
+			int alpha = recipe->minAlpha;
+			if (recipe->levels > 1)
+				alpha += (recipe->maxAlpha - recipe->minAlpha) * level / (recipe->levels - 1);
+
+			//the base is copied as it is so the page doesn't end up premultiplied; everything else gets blended on top of it
+			SDL_SetTextureBlendMode(source, SDL_BLENDMODE_NONE);
+			SDL_RenderCopy(app.renderer, source, &base, &dest);
+
+			SDL_SetTextureBlendMode(source, SDL_BLENDMODE_BLEND);
+			SDL_SetTextureAlphaMod(source, alpha);
+			SDL_RenderCopy(app.renderer, source, &overlay, &dest);
+			SDL_SetTextureAlphaMod(source, 255);
+
+			if (recipe->top != SPR_MAX)
+				SDL_RenderCopy(app.renderer, source, &top, &dest);
+		}
+	}
+
+	SDL_SetTextureBlendMode(source, blendMode);
+	SDL_SetRenderTarget(app.renderer, target);
+}
+
+//makes a sprite for drawing a composite
+//each level is a frame, so set currentFrame to pick one (the sprite's speed is 0, so the level stays put)
+SpriteAnimated *initCompositeSprite(CompositeSprite composite) {
+	return initSpriteAnimatedFromDef(page, &recipes[composite].def, 0);
+}
+
+//finds which composite a sprite was made for by initCompositeSprite
+//returns CS_MAX if it wasn't made by initCompositeSprite
+CompositeSprite getCompositeSprite(const SpriteAnimated *sprite) {
+	if (page == NULL || sprite->atlas != page)
+		return CS_MAX;
+
+	for (int i = 0; i < CS_MAX; ++i) {
+		if (sprite->srcY == recipes[i].def.y)
+			return i;
+	}
+
+	return CS_MAX;
+}
+
+//picks the baked hitflash level closest to how strong the hitflash should be (it fades out over END_OF_FLASH frames)
+//only meaningful while timeSinceDamaged < END_OF_FLASH
+int getHitflashLevel(int timeSinceDamaged) {
+	const CompositeRecipe *recipe = &recipes[CS_CRATE_LARGE_HITFLASH];
+	float alpha = 255 * (float)(END_OF_FLASH - timeSinceDamaged) / (float)END_OF_FLASH;
+	int level = (int)floor((alpha - recipe->minAlpha) / (recipe->maxAlpha - recipe->minAlpha) * (HITFLASH_LEVELS - 1) + 0.5);
+
+	return MAX(0, MIN(level, HITFLASH_LEVELS - 1));
+}
+
+//frees the page
+void deleteComposites(void) {
+	if (page != NULL)
+		deleteSpriteAtlas(page);
+	page = NULL;
+}
\ No newline at end of file
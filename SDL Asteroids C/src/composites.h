@@ -0,0 +1,35 @@
+#ifndef COMPOSITES_H
+#define COMPOSITES_H
+
+/*
+* Sprites that used to be drawn as a stack of sprites with the alpha changing in between (hitflash over a crate, a powerup's cell, shine and letter)
+* get flattened into a generated atlas page at load time instead.
+* Each composite is baked at a few levels of the in-between layer's alpha, laid out left to right like the frames of an animation,
+* so drawing one is a single blit of a SpriteAnimated with its current frame set to the level.
+*/
+
+#define HITFLASH_LEVELS 5		//number of baked hitflash intensities (not counting no hitflash at all)
+#define POWERUP_SHINE_LEVELS 8	//number of baked powerup shine intensities (including no shine)
+
+//CS stands for composite sprite
+typedef enum {
+	CS_CRATE_LARGE_HITFLASH,
+	CS_CRATE_MEDIUM_HITFLASH,
+	CS_CRATE_SMALL_HITFLASH,
+	CS_ENEMY_HITFLASH,
+	CS_POWERUP_NORMAL,
+	CS_POWERUP_ERRATIC,
+	CS_POWERUP_BOUNCER,
+	CS_POWERUP_SHOTGUN,
+
+	CS_MAX
+} CompositeSprite;
+
+bool initComposites(void);
+void bakeComposites(void);
+SpriteAnimated *initCompositeSprite(CompositeSprite composite);
+CompositeSprite getCompositeSprite(const SpriteAnimated *sprite);
+int getHitflashLevel(int timeSinceDamaged);
+void deleteComposites(void);
+
+#endif
\ No newline at end of file
@@ -3,7 +3,10 @@
 
 #include "crates.h"
 
+#include "animations.h"
 #include "colliders.h"
+#include "composites.h"
+#include "debugDraw.h"
 #include "geometry.h"
 #include "particles.h"
 #include "player.h"
@@ -49,8 +52,10 @@ void updateCrates(void) {
 		if (crate->y > SCREEN_HEIGHT + vertEdgeDist)
 			crate->y = -vertEdgeDist;
 
-		//update hitflash timer
+		//update hitflash timer, and pick the hitflash level to draw the crate with
 		++crate->timeSinceDamaged;
+		if (crate->timeSinceDamaged < END_OF_FLASH)
+			crate->crateSpriteHitflash->currentFrame = getHitflashLevel(crate->timeSinceDamaged);
 
 		//destroy a crate if its hp is 0
 		//notably, this function doesn't ever subtract from a crate's hp; that only happens in update functions for objects that interact with crates
@@ -84,7 +89,7 @@ void updateCrates(void) {
 			}
 
 			//explosion particle
-			initParticle(initSpriteAnimated(app.gameplaySprites, 0, 18, 4, 4, SC_CENTER, 5, 0, 0.3, AL_ONESHOT), crate->x, crate->y, 0, 0, (float)(rand() % 4) * 90, 1, NULL, explosionDraw);
+			initParticle(initSpriteAnimatedFromTable(SPR_EXPLOSION, 0), crate->x, crate->y, 0, 0, (float)(rand() % 4) * 90, 1, explosionUpdate, explosionDraw);
 
 			//edge case: last element
 			if (crate == stage.crateTail) {
@@ -115,22 +120,22 @@ void updateCrates(void) {
 }
 
 void drawCrates(void) {
+	setRenderLayer(RL_CRATES);
+
 	Crate* crate = stage.crateHead;
 
 	while (crate != NULL) {
 		//draw crate
 		if (crate->timeSinceDamaged < END_OF_FLASH) {
-			//draw hitflash over normal sprite, decreasing its transparency the longer it's been since the crate was hit
-			blitSpriteStaticEX(crate->crateSprite, crate->x, crate->y, crate->angle, NULL, SDL_FLIP_NONE);
-			setTextureRGBA(crate->crateSprite->atlas->texture, 255, 255, 255, (int)(255 * (float)(END_OF_FLASH - crate->timeSinceDamaged) / (float)END_OF_FLASH));
-			blitSpriteStaticEX(crate->crateSpriteHitflash, crate->x, crate->y, crate->angle, NULL, SDL_FLIP_NONE);
-			setTextureRGBA(crate->crateSprite->atlas->texture, 255, 255, 255, 255);
+			//draw the sprite with hitflash baked over it, fading out the longer it's been since the crate was hit (the level's picked in updateCrates)
+			blitSpriteAnimatedEX(crate->crateSpriteHitflash, crate->x, crate->y, crate->angle, NULL, SDL_FLIP_NONE);
 		}
 		else
 			blitSpriteStaticEX(crate->crateSprite, crate->x, crate->y, crate->angle, NULL, SDL_FLIP_NONE);
 
 		//only happens if app.debug = true
-		displayCollider(app.renderer, &COLOR_RED, crate->collider);
+		displayCollider(&COLOR_RED, crate->collider);
+		debugDrawVelocity(crate->x, crate->y, crate->dirVector, crate->speed);
 
 		crate = crate->next;
 	}
@@ -151,6 +156,7 @@ void initCrates(int numberOfCrates) {
 			y = randFloatRange(SCREEN_HEIGHT * 0.5 + SPACE_FOR_PLAYER, SCREEN_HEIGHT);
 
 		addCrate(CT_LARGE, x, y);
+		addDebugSpawnPoint(x, y, "CRATE");
 	}
 }
 
@@ -168,33 +174,39 @@ void addCrate(CrateType type, int x, int y) {
 
 	//initialize
 	crate->type = type;
+	SpriteId spriteId = SPR_MAX;	//which sprite the crate's collision masks come from
 	switch (crate->type) {
 	case(CT_LARGE):
-		crate->crateSprite = initSpriteStatic(app.gameplaySprites, 0, 0, 4, 4, SC_CENTER);
-		crate->crateSpriteHitflash = initSpriteStatic(app.gameplaySprites, 4, 0, 4, 4, SC_CENTER);
+		spriteId = SPR_CRATE_LARGE;
+		crate->crateSprite = initSpriteStaticFromTable(spriteId, 0);
+		crate->crateSpriteHitflash = initCompositeSprite(CS_CRATE_LARGE_HITFLASH);
 		crate->hp = 100;
 		crate->speed = randFloatRange(1.0 + (stage.level - 1) * 0.2, 1.5 + (stage.level - 1) * 0.2);
 		break;
 	case(CT_MEDIUM):
-		crate->crateSprite = initSpriteStatic(app.gameplaySprites, 0, 4, 3, 3, SC_CENTER);
-		crate->crateSpriteHitflash = initSpriteStatic(app.gameplaySprites, 3, 4, 3, 3, SC_CENTER);
+		spriteId = SPR_CRATE_MEDIUM;
+		crate->crateSprite = initSpriteStaticFromTable(spriteId, 0);
+		crate->crateSpriteHitflash = initCompositeSprite(CS_CRATE_MEDIUM_HITFLASH);
 		crate->hp = 50;
 		crate->speed = randFloatRange(1.5 + (stage.level - 1) * 0.2, 2.0 + (stage.level - 1) * 0.2);
 		break;
 	case(CT_SMALL):
-		crate->crateSprite = initSpriteStatic(app.gameplaySprites, 0, 7, 2, 2, SC_CENTER);
-		crate->crateSpriteHitflash = initSpriteStatic(app.gameplaySprites, 2, 7, 2, 2, SC_CENTER);
+		spriteId = SPR_CRATE_SMALL;
+		crate->crateSprite = initSpriteStaticFromTable(spriteId, 0);
+		crate->crateSpriteHitflash = initCompositeSprite(CS_CRATE_SMALL_HITFLASH);
 		crate->hp = 25;
 		crate->speed = randFloatRange(2.0 + (stage.level - 1) * 0.2, 2.5 + (stage.level - 1) * 0.2);
 		break;
 	}
+	preRotateSpriteStatic(crate->crateSprite);	//hitflash levels are rotated exactly; baking every level at every angle would take up a lot of memory for a few frames of flashing
 
 	crate->x = x;
 	crate->y = y;
 	crate->angle = randFloat(359.999999999999);	//start at random angle
 	crate->angleSpeed = randFloatRange(-3, 3);
 	crate->timeSinceDamaged = END_OF_FLASH;	//don't want crates to give hitflash when spawned
-	crate->collider = initOBBCollider(crate->crateSprite->w * 0.45, crate->crateSprite->h * 0.45, (Vector2) { crate->x, crate->y }, crate->angle *DEGREES_TO_RADIANS);
+	crate->collider = initOBBCollider(crate->crateSprite->w * 0.5, crate->crateSprite->h * 0.5, (Vector2) { crate->x, crate->y }, crate->angle *DEGREES_TO_RADIANS, CL_CRATE, crate);
+	setColliderPixelMasks(crate->collider, getSpritePixelMasks(spriteId));
 
 	//spawn crate moving in a random direction that is perpendicular or away from the player
 	Vector2 vectToPlayer;
@@ -210,8 +222,8 @@ void addCrate(CrateType type, int x, int y) {
 
 static void deleteCrate(Crate *crate) {
 	free(crate->crateSprite);
-	free(crate->crateSpriteHitflash);
-	free(crate->collider);
+	deleteSpriteAnimated(crate->crateSpriteHitflash);
+	deleteCollider(crate->collider);
 	free(crate);
 	crate = NULL;
 }
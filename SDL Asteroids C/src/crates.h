@@ -27,7 +27,7 @@ struct Crate {
 	CrateType type;
 	Vector2 dirVector;	//stores direction (should always be normalized)
 	SpriteStatic *crateSprite;
-	SpriteStatic *crateSpriteHitflash;
+	SpriteAnimated *crateSpriteHitflash;	//one frame per hitflash level (see composites.h)
 	OBBCollider* collider;
 	Crate* next;	//linked list
 };
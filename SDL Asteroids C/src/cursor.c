@@ -22,6 +22,12 @@ void initCursor(void) {
 }
 
 void drawCursor(void) {
+	//nothing to draw until the UI sprites have loaded
+	if (sprCursorPoint == NULL)
+		return;
+
+	setRenderLayer(RL_CURSOR);
+
 	//only display cursor if user is using mouse and keyboard
 	if (input.lastControllerType == LCT_KEYBOARD_AND_MOUSE) {
 		switch (app.cursorState) {
@@ -0,0 +1,268 @@
+#include "common.h"
+
+#include "debugDraw.h"
+#include "draw.h"
+#include "fonts.h"
+#include "renderQueue.h"
+
+extern App app;
+
+//max number of lines that can be drawn in one frame (rectangles and crosses are made out of lines)
+#define MAX_DEBUG_LINES 4096
+
+//max number of pieces of text that can be drawn in one frame
+#define MAX_DEBUG_TEXTS 64
+
+//max number of recent spawn points that are remembered; the oldest one gets replaced once this fills up
+#define MAX_DEBUG_SPAWN_POINTS 32
+
+typedef struct {
+	float x0;
+	float y0;
+	float x1;
+	float y1;
+	SDL_Color color;
+} DebugLine;
+
+typedef struct {
+	char text[MAX_STRING_LENGTH];
+	int x;
+	int y;
+	SDL_Color color;
+	TextAlignHorz horzAlign;
+} DebugText;
+
+typedef struct {
+	float x;
+	float y;
+	const char *label;	//must be a string literal (or something else that stays around)
+	int ttl;			//ticks until it stops being drawn
+} DebugSpawnPoint;
+
+bool isDebugDrawEnabled(DebugDrawCategory category);
+void toggleDebugDrawCategory(DebugDrawCategory category);
+void debugDrawLine(DebugDrawCategory category, float x0, float y0, float x1, float y1, SDL_Color color);
+void debugDrawRect(DebugDrawCategory category, float x, float y, float w, float h, SDL_Color color);
+void debugDrawCross(DebugDrawCategory category, float x, float y, float size, SDL_Color color);
+void debugDrawText(DebugDrawCategory category, const char *text, int x, int y, SDL_Color color, TextAlignHorz horzAlign);
+void debugDrawVelocity(float x, float y, Vector2 direction, float speed);
+void addDebugSpawnPoint(float x, float y, const char *label);
+void updateDebugDraw(void);
+static void addSpawnPointMarkers(void);
+static void addLegend(void);
+static void buildLineQuad(const DebugLine *line, SDL_Vertex *vertices);
+void drawDebug(void);
+
+//labels for each category in the legend, in the same order as the DebugDrawCategory enum
+static const char *CATEGORY_LABELS[DDC_MAX] = {
+	"COLLIDERS",
+	"BROAD PHASE",
+	"VELOCITY",
+	"SPAWN POINTS",
+	"PROFILER"
+};
+
+static const float LINE_THICKNESS = 1;
+static const int VELOCITY_DRAW_TICKS = 10;	//velocity lines show how far things will go in this many ticks
+static const int SPAWN_POINT_TIME = FPS * 3;	//how long spawn points stay up for, in ticks
+static const int SPAWN_POINT_SIZE = 6;
+static const int SPAWN_POINT_EDGE_MARGIN = 12;	//spawn points that are offscreen get drawn this far in from the edge of the screen instead
+static const int LEGEND_MARGIN = 4;				//distance from the bottom left corner of the screen
+static const int LEGEND_LINE_HEIGHT = 14;
+
+static bool categoriesDisabled[DDC_MAX];	//everything starts out on
+
+//the buffer; emptied by drawDebug every frame
+static DebugLine lines[MAX_DEBUG_LINES];
+static int lineCount = 0;
+static DebugText texts[MAX_DEBUG_TEXTS];
+static int textCount = 0;
+static bool warnedFull = false;	//so a full buffer doesn't print a warning every frame
+
+static DebugSpawnPoint spawnPoints[MAX_DEBUG_SPAWN_POINTS];
+static int nextSpawnPoint = 0;
+
+//checks if something in a category would be drawn right now
+bool isDebugDrawEnabled(DebugDrawCategory category) {
+	return app.debug && !categoriesDisabled[category];
+}
+
+void toggleDebugDrawCategory(DebugDrawCategory category) {
+	categoriesDisabled[category] = !categoriesDisabled[category];
+}
+
+//adds a 1 pixel wide line to the buffer
+//lines that are entirely offscreen are thrown out here
+void debugDrawLine(DebugDrawCategory category, float x0, float y0, float x1, float y1, SDL_Color color) {
+	if (!isDebugDrawEnabled(category) || cullBounds(MIN(x0, x1), MIN(y0, y1), MAX(x0, x1), MAX(y0, y1)))
+		return;
+
+	if (lineCount >= MAX_DEBUG_LINES) {
+		if (!warnedFull)
+			printf("WARNING - Debug draw buffer full. Raise MAX_DEBUG_LINES.\n");
+		warnedFull = true;
+		return;
+	}
+
+	lines[lineCount++] = (DebugLine){ x0, y0, x1, y1, color };
+}
+
+//adds the outline of an axis-aligned rectangle to the buffer
+void debugDrawRect(DebugDrawCategory category, float x, float y, float w, float h, SDL_Color color) {
+	debugDrawLine(category, x, y, x + w, y, color);
+	debugDrawLine(category, x + w, y, x + w, y + h, color);
+	debugDrawLine(category, x + w, y + h, x, y + h, color);
+	debugDrawLine(category, x, y + h, x, y, color);
+}
+
+//adds a + centered on (x, y) to the buffer, reaching size pixels out in each direction
+void debugDrawCross(DebugDrawCategory category, float x, float y, float size, SDL_Color color) {
+	debugDrawLine(category, x - size, y, x + size, y, color);
+	debugDrawLine(category, x, y - size, x, y + size, color);
+}
+
+//adds a line of text to the buffer; it's drawn with a drop shadow, like the rest of the game's text
+//text is copied, so it can be a temporary buffer
+void debugDrawText(DebugDrawCategory category, const char *text, int x, int y, SDL_Color color, TextAlignHorz horzAlign) {
+	if (!isDebugDrawEnabled(category))
+		return;
+
+	if (textCount >= MAX_DEBUG_TEXTS) {
+		if (!warnedFull)
+			printf("WARNING - Debug draw buffer full. Raise MAX_DEBUG_TEXTS.\n");
+		warnedFull = true;
+		return;
+	}
+
+	DebugText *debugText = &texts[textCount++];
+	snprintf(debugText->text, MAX_STRING_LENGTH, "%s", text);
+	debugText->x = x;
+	debugText->y = y;
+	debugText->color = color;
+	debugText->horzAlign = horzAlign;
+}
+
+//adds a line from (x, y) to where something moving at speed in direction will be in VELOCITY_DRAW_TICKS ticks
+void debugDrawVelocity(float x, float y, Vector2 direction, float speed) {
+	float length = speed * VELOCITY_DRAW_TICKS;
+	debugDrawLine(DDC_VELOCITY, x, y, x + direction.x * length, y + direction.y * length, COLOR_GREEN);
+}
+
+//remembers where something spawned, so it can be shown for a few seconds
+//spawns happen in logic, so unlike everything else here, these last longer than a frame
+void addDebugSpawnPoint(float x, float y, const char *label) {
+	if (!isDebugDrawEnabled(DDC_SPAWN_POINTS))
+		return;
+
+	spawnPoints[nextSpawnPoint] = (DebugSpawnPoint){ x, y, label, SPAWN_POINT_TIME };
+	nextSpawnPoint = (nextSpawnPoint + 1) % MAX_DEBUG_SPAWN_POINTS;
+}
+
+//counts down how long spawn points have left
+//call once per logic tick
+void updateDebugDraw(void) {
+	for (int i = 0; i < MAX_DEBUG_SPAWN_POINTS; ++i) {
+		if (spawnPoints[i].ttl > 0)
+			--spawnPoints[i].ttl;
+	}
+}
+
+//adds a fading marker for each recent spawn point
+//most enemies spawn offscreen, so markers are pulled in to the edge of the screen, with a line pointing out towards the actual spot
+static void addSpawnPointMarkers(void) {
+	for (int i = 0; i < MAX_DEBUG_SPAWN_POINTS; ++i) {
+		DebugSpawnPoint *spawnPoint = &spawnPoints[i];
+		if (spawnPoint->ttl <= 0)
+			continue;
+
+		SDL_Color color = COLOR_YELLOW;
+		color.a = 255 * spawnPoint->ttl / SPAWN_POINT_TIME;
+
+		float x = MAX(SPAWN_POINT_EDGE_MARGIN, MIN(spawnPoint->x, SCREEN_WIDTH - SPAWN_POINT_EDGE_MARGIN));
+		float y = MAX(SPAWN_POINT_EDGE_MARGIN, MIN(spawnPoint->y, SCREEN_HEIGHT - SPAWN_POINT_EDGE_MARGIN));
+
+		debugDrawCross(DDC_SPAWN_POINTS, x, y, SPAWN_POINT_SIZE, color);
+		if (x != spawnPoint->x || y != spawnPoint->y)
+			debugDrawLine(DDC_SPAWN_POINTS, x, y, spawnPoint->x, spawnPoint->y, color);
+
+		//keep the label on screen too
+		int labelY = y > SCREEN_HEIGHT * 0.5 ? y - SPAWN_POINT_SIZE - LEGEND_LINE_HEIGHT : y + SPAWN_POINT_SIZE + 2;
+		TextAlignHorz labelAlign = x < SCREEN_WIDTH * 0.25 ? TAH_LEFT : x > SCREEN_WIDTH * 0.75 ? TAH_RIGHT : TAH_CENTER;
+		debugDrawText(DDC_SPAWN_POINTS, spawnPoint->label, x, labelY, color, labelAlign);
+	}
+}
+
+//lists the categories, what key toggles each one, and whether they're on
+static void addLegend(void) {
+	int y = SCREEN_HEIGHT - LEGEND_MARGIN - LEGEND_LINE_HEIGHT * DDC_MAX;
+
+	//the legend has to show up even when categories are off, so it goes straight into the buffer instead of through debugDrawText
+	for (int i = 0; i < DDC_MAX && textCount < MAX_DEBUG_TEXTS; ++i) {
+		DebugText *debugText = &texts[textCount++];
+		snprintf(debugText->text, MAX_STRING_LENGTH, "%s %s: %s", SDL_GetScancodeName(DEBUG_DRAW_FIRST_KEY + i), CATEGORY_LABELS[i], categoriesDisabled[i] ? "OFF" : "ON");
+		debugText->x = LEGEND_MARGIN;
+		debugText->y = y;
+		debugText->color = categoriesDisabled[i] ? COLOR_RED : COLOR_GREEN;
+		debugText->horzAlign = TAH_LEFT;
+
+		y += LEGEND_LINE_HEIGHT;
+	}
+}
+
+//turns a line into a quad, LINE_THICKNESS wide, that covers the same pixels SDL_RenderDrawLine would
+static void buildLineQuad(const DebugLine *line, SDL_Vertex *vertices) {
+	float dx = line->x1 - line->x0;
+	float dy = line->y1 - line->y0;
+	float length = sqrtf(dx * dx + dy * dy);
+
+	//unit vector along the line (points still get a pixel's worth of quad)
+	float alongX = length > 0 ? dx / length : 1;
+	float alongY = length > 0 ? dy / length : 0;
+
+	//half a pixel out along the line and to either side of it, and shifted onto pixel centers
+	float halfThickness = LINE_THICKNESS * 0.5;
+	float startX = line->x0 + 0.5 - alongX * halfThickness;
+	float startY = line->y0 + 0.5 - alongY * halfThickness;
+	float endX = line->x1 + 0.5 + alongX * halfThickness;
+	float endY = line->y1 + 0.5 + alongY * halfThickness;
+	float sideX = -alongY * halfThickness;
+	float sideY = alongX * halfThickness;
+
+	float cornersX[4] = { startX + sideX, endX + sideX, endX - sideX, startX - sideX };
+	float cornersY[4] = { startY + sideY, endY + sideY, endY - sideY, startY - sideY };
+
+	for (int i = 0; i < 4; ++i) {
+		vertices[i].position.x = cornersX[i];
+		vertices[i].position.y = cornersY[i];
+		vertices[i].color = line->color;
+		vertices[i].tex_coord.x = 0;
+		vertices[i].tex_coord.y = 0;
+	}
+}
+
+//sends off everything in the buffer and empties it
+//call once per frame, after everything else that could add to it has been drawn
+//all of the lines go out as one run of untextured quads, so they batch together no matter how many there are
+void drawDebug(void) {
+	if (app.debug) {
+		addSpawnPointMarkers();
+		addLegend();
+
+		SDL_Vertex *vertices = queueVertices(RL_DEBUG, NULL, SDL_BLENDMODE_BLEND, lineCount);
+		if (vertices != NULL) {
+			for (int i = 0; i < lineCount; ++i)
+				buildLineQuad(&lines[i], &vertices[i * 4]);
+		}
+
+		//the fonts aren't there to draw with while the game's still loading
+		if (app.fontsAndUI != NULL) {
+			setRenderLayer(RL_DEBUG);
+
+			for (int i = 0; i < textCount; ++i)
+				drawTextDropShadow(texts[i].text, texts[i].x, texts[i].y, texts[i].color, texts[i].horzAlign, 0, COLOR_BLACK, 1);
+		}
+	}
+
+	lineCount = 0;
+	textCount = 0;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef DEBUG_DRAW_H
+#define DEBUG_DRAW_H
+
+#include "fonts.h"
+#include "geometry.h"
+
+/*
+* Debug visualization buffer.
+* While app.debug is on (toggle with F3), draw code adds lines, rectangles and text here instead of drawing them itself,
+* and the whole buffer is sent off in one go by drawDebug at the end of each frame (so all of the lines end up in a single batch).
+* Everything is filed under a category, and each category can be switched off on its own (F4 and up, in the order of the enum below).
+* Anything that's expensive to work out should check isDebugDrawEnabled first.
+*/
+
+//DDC stands for debug draw category
+typedef enum {
+	DDC_COLLIDERS,		//collider boxes, plus where and which way contacts happened on the last tick
+	DDC_BROAD_PHASE,	//the axis-aligned boxes the broad phase checks colliders with
+	DDC_VELOCITY,		//where things will be in a few ticks if they keep going the way they are
+	DDC_SPAWN_POINTS,	//where things have spawned recently
+	DDC_PROFILER,		//profiler counters
+
+	DDC_MAX
+} DebugDrawCategory;
+
+//categories are toggled by this key and the ones right after it, one per category
+#define DEBUG_DRAW_FIRST_KEY SDL_SCANCODE_F4
+
+bool isDebugDrawEnabled(DebugDrawCategory category);
+void toggleDebugDrawCategory(DebugDrawCategory category);
+void debugDrawLine(DebugDrawCategory category, float x0, float y0, float x1, float y1, SDL_Color color);
+void debugDrawRect(DebugDrawCategory category, float x, float y, float w, float h, SDL_Color color);
+void debugDrawCross(DebugDrawCategory category, float x, float y, float size, SDL_Color color);
+void debugDrawText(DebugDrawCategory category, const char *text, int x, int y, SDL_Color color, TextAlignHorz horzAlign);
+void debugDrawVelocity(float x, float y, Vector2 direction, float speed);
+void addDebugSpawnPoint(float x, float y, const char *label);
+void updateDebugDraw(void);
+void drawDebug(void);
+
+#endif
\ No newline at end of file
@@ -41,9 +41,6 @@
 #define MAX_ENEMIES 10	//largest number of enemies that can be in the game at once
 #define BULLET_OFFSET_PLAYER 20	//offset from the center of the player when a player bullet is created
 #define BULLET_OFFSET_ENEMY 25	//offset from the center of an enemy when an enemy bullet is created
-#define NUM_BACKGROUND_STARS_L1 50
-#define NUM_BACKGROUND_STARS_L2 50
-#define NUM_BACKGROUND_STARS_L3 50
 #define NUM_HIGHSCORES 5	//the number of highscores that will be saved
 
 #define MAX_KEYBOARD_KEYS 150
@@ -2,34 +2,188 @@
 
 #include "SDL_image.h"
 
+#include "animations.h"
+#include "capture.h"
 #include "draw.h"
+#include "geometry.h"
+#include "postProcess.h"
+#include "preRotations.h"
+#include "renderQueue.h"
+#include "softRaster.h"
+#include "textureCache.h"
 
 extern App app;
 
 void prepareScene(void);
 void presentScene(void);
+void updateWindowScale(void);
+void deleteSceneTarget(void);
+void setRenderLayer(RenderLayer layer);
 SDL_Texture *loadTexture(char *filename);
+SDL_Texture *createTextureFromImage(SDL_Surface *image);
 void setTextureRGBA(SDL_Texture *texture, int r, int g, int b, int a);
+SDL_Color getTextureRGBA(SDL_Texture *texture);
+void drawFilledRect(const SDL_Rect *rect, SDL_Color color);
+SDL_Vertex *drawTextureQuads(SDL_Texture *texture, int quads);
 void blitSpriteStatic(const SpriteStatic* sprite, int x, int y);
 void blitSpriteStaticEX(const SpriteStatic* sprite, int x, int y, float angle, const SDL_Point* origin, SDL_RendererFlip flip);
-void blitAndUpdateSpriteAnimated(SpriteAnimated* sprite, int x, int y);
-void blitAndUpdateSpriteAnimatedEX(SpriteAnimated* sprite, int x, int y, float angle, const SDL_Point* origin, SDL_RendererFlip flip);
+void blitSpriteAnimated(const SpriteAnimated *sprite, int x, int y);
+void blitSpriteAnimatedEX(const SpriteAnimated *sprite, int x, int y, float angle, const SDL_Point *origin, SDL_RendererFlip flip);
+static bool blitPreRotated(const PreRotatedSprite *rotations, int frame, const SDL_Rect *dest, float angle, const SDL_Point *origin);
 SpriteAtlas *initSpriteAtlas(char *filename);
+SpriteAtlas *initSpriteAtlasFromImage(SDL_Surface *image);
+bool initSharedSpriteAtlases(SDL_Surface *first, SDL_Surface *second, SpriteAtlas **firstAtlas, SpriteAtlas **secondAtlas);
 SpriteStatic *initSpriteStatic(const SpriteAtlas *atlas, int srcX, int srcY, int w, int h, SpriteCenter center);
 SpriteAnimated *initSpriteAnimated(const SpriteAtlas *atlas, int srcX, int srcY, int w, int h, SpriteCenter center, int frames, float currentFrame, float spd, AnimationLoop loopBehavior);
+static void getCenterPivot(SpriteCenter center, int w, int h, int *pivotX, int *pivotY);
+SpriteStatic *initSpriteStaticFromDef(SpriteAtlas *atlas, const SpriteDef *def, int frame);
+SpriteAnimated *initSpriteAnimatedFromDef(SpriteAtlas *atlas, const SpriteDef *def, float currentFrame);
+SpriteStatic *initSpriteStaticFromTable(SpriteId id, int frame);
+SpriteAnimated *initSpriteAnimatedFromTable(SpriteId id, float currentFrame);
+bool isSpriteFromTable(const SpriteAnimated *sprite, SpriteId id);
+void preRotateSpriteStatic(SpriteStatic *sprite);
+void preRotateSpriteAnimated(SpriteAnimated *sprite);
+void initPreRotatedSprites(void);
 void deleteSpriteAtlas(SpriteAtlas* atlas);
+bool beginRenderCache(RenderCache *cache);
+void endRenderCache(RenderCache *cache);
+void drawRenderCache(const RenderCache *cache);
+void invalidateRenderCache(RenderCache *cache);
+void invalidateAllRenderCaches(void);
+void deleteRenderCache(RenderCache *cache);
+
+//max number of textures that can have a tint set on them at once
+#define MAX_TINTED_TEXTURES 8
+
+//color and alpha modulation for a texture
+//these get applied per-vertex when sprites are batched, instead of being set on the texture itself
+typedef struct {
+	SDL_Texture *texture;
+	SDL_Color tint;
+} TextureTint;
+
+static TextureTint textureTints[MAX_TINTED_TEXTURES];
+static int textureTintCount = 0;
+
+static const int SHARED_ATLAS_PADDING = 1;	//gap between images that share a texture, in pixels
+
+//every sprite in the sprite table that gets drawn from baked rotations (see initPreRotatedSprites)
+static const SpriteId PRE_ROTATED_SPRITES[] = {
+	SPR_CRATE_LARGE,
+	SPR_CRATE_MEDIUM,
+	SPR_CRATE_SMALL,
+	SPR_ENEMY,
+	SPR_FLAME,
+	SPR_BULLET_NORMAL,
+	SPR_BULLET_ERRATIC,
+	SPR_BULLET_BOUNCER,
+	SPR_BULLET_SHOTGUN,
+	SPR_BULLET_ENEMY
+};
+
+static RenderLayer currentLayer = RL_BACKGROUND;	//layer that everything drawn gets queued on
+
+//bumped whenever every render cache needs to be redrawn (e.g. when the renderer loses the contents of its target textures)
+static int renderCacheGeneration = 0;
+static RenderLayer layerBeforeCache = RL_BACKGROUND;	//layer to go back to once a render cache is done being drawn into
+
+//the whole frame gets drawn into this at SCREEN_WIDTH x SCREEN_HEIGHT, then gets copied to the window once, scaled up
+//if it can't be made, the renderer's logical size does the scaling instead (which scales every draw separately)
+static SDL_Texture *sceneTarget = NULL;
+static bool sceneTargetFailed = false;
+static SDL_Rect sceneRect = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };	//where sceneTarget goes in the window, in renderer output pixels
 
 //Gets the scene ready for drawing
+//(when headless, everything is drawn straight into the framebuffer, which is already SCREEN_WIDTH x SCREEN_HEIGHT)
 void prepareScene(void) {
+	if (sceneTarget == NULL && !sceneTargetFailed && !app.headless) {
+		sceneTarget = SDL_CreateTexture(app.renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+		if (sceneTarget == NULL) {
+			printf("WARNING - Scene texture could not be created, falling back to logical size scaling: %s\n", SDL_GetError());
+			sceneTargetFailed = true;
+			SDL_RenderSetLogicalSize(app.renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+			SDL_RenderSetIntegerScale(app.renderer, app.preferences.integerScaling);
+		}
+		else
+			SDL_SetTextureBlendMode(sceneTarget, SDL_BLENDMODE_NONE);
+	}
+
+	//rebake rotations if the quality preference changed or the renderer lost them, before anything gets queued
+	updatePreRotations();
+
+	SDL_SetRenderTarget(app.renderer, sceneTarget);
 	SDL_SetRenderDrawColor(app.renderer, 0x0, 0x0, 0x0, 0xff);
 	SDL_RenderClear(app.renderer);
+	currentLayer = RL_BACKGROUND;
 }
 
 //Presents the drawn scene
 void presentScene(void) {
+	flushRenderQueue();	//everything drawn this frame has only been queued up until now
+
+	//post-processing and capture read the scene back, so they have to happen while the scene is still the render target
+	//(when headless, the framebuffer is post-processed in place, so capture gets it post-processed)
+	SDL_Texture *postProcessed = NULL;
+	if (sceneTarget != NULL || app.headless) {
+		postProcessed = applyPostProcess();
+		captureFrame();
+	}
+
+	//copy the scene to the window, letterboxed with black
+	if (sceneTarget != NULL) {
+		SDL_SetRenderTarget(app.renderer, NULL);
+		SDL_SetRenderDrawColor(app.renderer, 0x0, 0x0, 0x0, 0xff);
+		SDL_RenderClear(app.renderer);
+		SDL_RenderCopy(app.renderer, postProcessed != NULL ? postProcessed : sceneTarget, NULL, &sceneRect);
+	}
+
 	SDL_RenderPresent(app.renderer);
 }
 
+//works out where the scene goes in the window, and how mouse coordinates map onto the scene
+//call whenever the window's size or the scaling preference changes
+void updateWindowScale(void) {
+	int windowW, windowH, outputW, outputH;
+	SDL_GetWindowSize(app.window, &windowW, &windowH);
+	if (SDL_GetRendererOutputSize(app.renderer, &outputW, &outputH) != 0) {
+		outputW = windowW;
+		outputH = windowH;
+	}
+
+	if (windowW <= 0 || windowH <= 0 || outputW <= 0 || outputH <= 0)
+		return;
+
+	//biggest scale that fits, rounded down to a whole number if integer scaling is on and the window's big enough for it
+	float scale = MIN((float)outputW / SCREEN_WIDTH, (float)outputH / SCREEN_HEIGHT);
+	if (app.preferences.integerScaling && scale >= 1)
+		scale = floor(scale);
+
+	sceneRect.w = SCREEN_WIDTH * scale;
+	sceneRect.h = SCREEN_HEIGHT * scale;
+	sceneRect.x = (outputW - sceneRect.w) / 2;
+	sceneRect.y = (outputH - sceneRect.h) / 2;
+
+	if (sceneTargetFailed)
+		SDL_RenderSetIntegerScale(app.renderer, app.preferences.integerScaling);
+
+	//mouse coordinates are in window coordinates, which aren't always the same as renderer output pixels (e.g. on high DPI displays)
+	float sceneW = sceneRect.w * (float)windowW / outputW;
+	float sceneH = sceneRect.h * (float)windowH / outputH;
+
+	app.windowPaddingW = windowW - sceneW;
+	app.windowPaddingH = windowH - sceneH;
+	app.windowPixelRatioW = (double)SCREEN_WIDTH / (double)sceneW;
+	app.windowPixelRatioH = (double)SCREEN_HEIGHT / (double)sceneH;
+}
+
+//frees the scene texture
+void deleteSceneTarget(void) {
+	if (sceneTarget != NULL)
+		SDL_DestroyTexture(sceneTarget);
+	sceneTarget = NULL;
+}
+
 //loads a texture from a file
 SDL_Texture *loadTexture(char* filename) {
 	SDL_Texture *texture;
@@ -37,7 +191,31 @@ SDL_Texture *loadTexture(char* filename) {
 	//Debug message
 	printf("Loading %s\n", filename);
 
-	texture = IMG_LoadTexture(app.renderer, filename);
+	//decoded pixels come from the texture cache when they can, so PNGs usually don't have to be inflated
+	SDL_Surface *image = loadCachedImage(filename);
+	if (image == NULL)
+		return NULL;
+
+	texture = createTextureFromImage(image);
+
+	freeCachedImage(image);
+
+	return texture;
+}
+
+//uploads an already decoded image (e.g. from loadCachedImage) to a new texture
+//the image isn't needed afterwards; the caller still owns it
+SDL_Texture *createTextureFromImage(SDL_Surface *image) {
+	SDL_Texture *texture = SDL_CreateTexture(app.renderer, image->format->format, SDL_TEXTUREACCESS_STATIC, image->w, image->h);
+
+	if (texture != NULL) {
+		SDL_UpdateTexture(texture, NULL, image->pixels, image->pitch);
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+		//the software rasterizer needs its own copy of the pixels
+		if (app.headless)
+			registerSoftRasterTexture(texture, image);
+	}
 
 	return texture;
 }
@@ -45,9 +223,53 @@ SDL_Texture *loadTexture(char* filename) {
 //set color and alpha modulation for a specific texture
 //pass in 255 for the RGBA values to get the original texture
 //wish I could just make a setSpriteRGBA function and overload it for static and animated sprites individually
+//the texture itself isn't touched; sprites blitted afterwards just get this color on their vertices, so this doesn't break up batches
 void setTextureRGBA(SDL_Texture *texture, int r, int g, int b, int a) {
-	SDL_SetTextureColorMod(texture, r, g, b);
-	SDL_SetTextureAlphaMod(texture, a);
+	SDL_Color tint = { r, g, b, a };
+
+	for (int i = 0; i < textureTintCount; ++i) {
+		if (textureTints[i].texture == texture) {
+			textureTints[i].tint = tint;
+			return;
+		}
+	}
+
+	if (textureTintCount >= MAX_TINTED_TEXTURES) {
+		printf("WARNING - Too many tinted textures. Raise MAX_TINTED_TEXTURES.\n");
+		return;
+	}
+
+	textureTints[textureTintCount].texture = texture;
+	textureTints[textureTintCount].tint = tint;
+	++textureTintCount;
+}
+
+//get the color and alpha modulation last set for a texture with setTextureRGBA
+SDL_Color getTextureRGBA(SDL_Texture *texture) {
+	for (int i = 0; i < textureTintCount; ++i) {
+		if (textureTints[i].texture == texture)
+			return textureTints[i].tint;
+	}
+
+	return (SDL_Color){ 255, 255, 255, 255 };
+}
+
+//sets the layer that sprites, text and rectangles drawn after this go on
+//draw functions for each part of the scene should call this first (see renderQueue.h for the layers)
+void setRenderLayer(RenderLayer layer) {
+	currentLayer = layer;
+}
+
+//draw a solid rectangle, blended using color's alpha
+void drawFilledRect(const SDL_Rect *rect, SDL_Color color) {
+	queueFilledRect(currentLayer, SDL_BLENDMODE_BLEND, rect, color);
+}
+
+//Draw a run of quads from a texture that the caller builds itself, for things that aren't sprites (like text).
+//Returns the vertices to fill in (see queueVertices in renderQueue.h), or NULL if they couldn't be queued.
+//The whole run is drawn in order as a single command, and colors come from the vertices rather than the texture's tint.
+SDL_Vertex *drawTextureQuads(SDL_Texture *texture, int quads) {
+	return queueVertices(currentLayer, texture, SDL_BLENDMODE_BLEND, quads);
 }
 
 //Blit a sprite to the screen at the specified coordinates.
@@ -64,47 +286,11 @@ void blitSpriteStatic(const SpriteStatic* sprite, int x, int y) {
 	dest.w = sprite->w;
 	dest.h = sprite->h;
 
-	//blit the sprite with the specified center of orientation
-	switch (sprite->center) {
-		case(SC_TOP_LEFT):
-			dest.x = x;
-			dest.y = y;
-		break;
-		case(SC_TOP_CENTER):
-			dest.x = x - dest.w * 0.5;
-			dest.y = y;
-		break;
-		case(SC_TOP_RIGHT):
-			dest.x = x - dest.w;
-			dest.y = y;
-			break;
-		case(SC_CENTER_LEFT):
-			dest.x = x;
-			dest.y = y - dest.h * 0.5;
-			break;
-		case(SC_CENTER):
-			dest.x = x - dest.w * 0.5;
-			dest.y = y - dest.h * 0.5;
-			break;
-		case(SC_CENTER_RIGHT):
-			dest.x = x - dest.w;
-			dest.y = y - dest.h * 0.5;
-			break;
-		case(SC_BOTTOM_LEFT):
-			dest.x = x;
-			dest.y = y - dest.h;
-			break;
-		case(SC_BOTTOM_CENTER):
-			dest.x = x - dest.w * 0.5;
-			dest.y = y - dest.h;
-			break;
-		case(SC_BOTTOM_RIGHT):
-			dest.x = x - dest.w;
-			dest.y = y - dest.h;
-			break;
-	}
+	//line the sprite's origin up with the coordinates
+	dest.x = x - sprite->pivotX;
+	dest.y = y - sprite->pivotY;
 
-	SDL_RenderCopy(app.renderer, sprite->atlas->texture, &src, &dest);
+	queueQuad(currentLayer, sprite->atlas->texture, SDL_BLENDMODE_BLEND, &src, &dest, 0, NULL, SDL_FLIP_NONE, getTextureRGBA(sprite->atlas->texture));
 }
 
 //Blit a sprite to the screen at the specified coordinates, with rotation around an origin, flipping and alpha modulation.
@@ -122,51 +308,19 @@ void blitSpriteStaticEX(const SpriteStatic* sprite, int x, int y, float angle, c
 	dest.w = sprite->w;
 	dest.h = sprite->h;
 
-	//blit the sprite with the specified center of orientation
-	switch (sprite->center) {
-	case(SC_TOP_LEFT):
-		dest.x = x;
-		dest.y = y;
-		break;
-	case(SC_TOP_CENTER):
-		dest.x = x - dest.w * 0.5;
-		dest.y = y;
-		break;
-	case(SC_TOP_RIGHT):
-		dest.x = x - dest.w;
-		dest.y = y;
-		break;
-	case(SC_CENTER_LEFT):
-		dest.x = x;
-		dest.y = y - dest.h * 0.5;
-		break;
-	case(SC_CENTER):
-		dest.x = x - dest.w * 0.5;
-		dest.y = y - dest.h * 0.5;
-		break;
-	case(SC_CENTER_RIGHT):
-		dest.x = x - dest.w;
-		dest.y = y - dest.h * 0.5;
-		break;
-	case(SC_BOTTOM_LEFT):
-		dest.x = x;
-		dest.y = y - dest.h;
-		break;
-	case(SC_BOTTOM_CENTER):
-		dest.x = x - dest.w * 0.5;
-		dest.y = y - dest.h;
-		break;
-	case(SC_BOTTOM_RIGHT):
-		dest.x = x - dest.w;
-		dest.y = y - dest.h;
-		break;
-	}
+	//line the sprite's origin up with the coordinates
+	dest.x = x - sprite->pivotX;
+	dest.y = y - sprite->pivotY;
+
+	if (angle != 0 && flip == SDL_FLIP_NONE && blitPreRotated(sprite->rotations, 0, &dest, angle, origin))
+		return;
 
-	SDL_RenderCopyEx(app.renderer, sprite->atlas->texture, &src, &dest, angle, origin, flip);
+	queueQuad(currentLayer, sprite->atlas->texture, SDL_BLENDMODE_BLEND, &src, &dest, angle, origin, flip, getTextureRGBA(sprite->atlas->texture));
 }
 
-//Blit a SpriteAnimated to the screen at the specified coordinates and update its animation.
-void blitAndUpdateSpriteAnimated(SpriteAnimated* sprite, int x, int y) {
+//Blit a SpriteAnimated's current frame to the screen at the specified coordinates.
+//The animation itself is advanced in logic (see animations.h), so drawing a sprite any number of times doesn't change it.
+void blitSpriteAnimated(const SpriteAnimated *sprite, int x, int y) {
 	//blitting
 	SDL_Rect src;
 
@@ -179,7 +333,7 @@ void blitAndUpdateSpriteAnimated(SpriteAnimated* sprite, int x, int y) {
 		//The reason this is a possible bug and not a definite bug is because 
 		//using a non-existent frame past the end of the atlas can be useful 
 		//in situations where one is checking for the end of an animation
-		printf("WARNING - 'blitAndUpdateSpriteAnimated' attempted to fetch pixels beyond the edge of its sprite atlas.\n");
+		printf("WARNING - 'blitSpriteAnimated' attempted to fetch pixels beyond the edge of its sprite atlas.\n");
 		src.x = sprite->srcX;
 	}
 	else {
@@ -195,74 +349,17 @@ void blitAndUpdateSpriteAnimated(SpriteAnimated* sprite, int x, int y) {
 	dest.w = sprite->w;
 	dest.h = sprite->h;
 
-	//blit the sprite with the specified center of orientation
-	switch (sprite->center) {
-	case(SC_TOP_LEFT):
-		dest.x = x;
-		dest.y = y;
-		break;
-	case(SC_TOP_CENTER):
-		dest.x = x - dest.w * 0.5;
-		dest.y = y;
-		break;
-	case(SC_TOP_RIGHT):
-		dest.x = x - dest.w;
-		dest.y = y;
-		break;
-	case(SC_CENTER_LEFT):
-		dest.x = x;
-		dest.y = y - dest.h * 0.5;
-		break;
-	case(SC_CENTER):
-		dest.x = x - dest.w * 0.5;
-		dest.y = y - dest.h * 0.5;
-		break;
-	case(SC_CENTER_RIGHT):
-		dest.x = x - dest.w;
-		dest.y = y - dest.h * 0.5;
-		break;
-	case(SC_BOTTOM_LEFT):
-		dest.x = x;
-		dest.y = y - dest.h;
-		break;
-	case(SC_BOTTOM_CENTER):
-		dest.x = x - dest.w * 0.5;
-		dest.y = y - dest.h;
-		break;
-	case(SC_BOTTOM_RIGHT):
-		dest.x = x - dest.w;
-		dest.y = y - dest.h;
-		break;
-	}
+	//line the sprite's origin up with the coordinates
+	dest.x = x - sprite->pivotX;
+	dest.y = y - sprite->pivotY;
+
+	queueQuad(currentLayer, sprite->atlas->texture, SDL_BLENDMODE_BLEND, &src, &dest, 0, NULL, SDL_FLIP_NONE, getTextureRGBA(sprite->atlas->texture));
 
-	SDL_RenderCopy(app.renderer, sprite->atlas->texture, &src, &dest);
-
-	//updating animation
-
-	//progress animation
-	sprite->currentFrame += sprite->spd;
-	//loop behavior
-	if (sprite->currentFrame >= sprite->frames || sprite->currentFrame < 0) {
-		switch (sprite->loopBehavior) {
-		case(AL_ONESHOT):
-			//lock animation on the last frame
-			sprite->currentFrame = sprite->frames - 1;
-			break;
-		case(AL_LOOP):
-			//go back to start of animation
-			sprite->currentFrame = 0;
-			break;
-		case(AL_BACK_AND_FORTH):
-			sprite->currentFrame -= sprite->spd;	//make sure currentFrame stays within the bounds of the current animation
-			sprite->spd = -sprite->spd;	//negate speed, inverting animation direction
-			break;
-		}
-	}
 }
 
-//Blit a SpriteAnimated to the screen at the specified coordinates and update its animation. Supports rotation around an origin, flipping and alpha modulation.
+//Blit a SpriteAnimated's current frame to the screen at the specified coordinates. Supports rotation around an origin, flipping and alpha modulation.
 //Pass NULL into the origin to rotate around the center of the destination rectangle.
-void blitAndUpdateSpriteAnimatedEX(SpriteAnimated* sprite, int x, int y, float angle, const SDL_Point* origin, SDL_RendererFlip flip) {
+void blitSpriteAnimatedEX(const SpriteAnimated *sprite, int x, int y, float angle, const SDL_Point *origin, SDL_RendererFlip flip) {
 	//blitting
 	SDL_Rect src;
 
@@ -272,7 +369,7 @@ void blitAndUpdateSpriteAnimatedEX(SpriteAnimated* sprite, int x, int y, float a
 	//>= may also be the incorrect comparison operator for this if statement; I'm assuming 0-indexed coordinated on the image
 	if (sprite->srcX + sprite->w + ((int)sprite->currentFrame * sprite->w) >= sprite->atlas->w) {
 		//Possible bug: edge of sprite atlas exceeded
-		printf("WARNING - 'blitAndUpdateSpriteAnimatedEX' attempted to fetch pixels beyond the edge of its sprite atlas.\n");
+		printf("WARNING - 'blitSpriteAnimatedEX' attempted to fetch pixels beyond the edge of its sprite atlas.\n");
 		src.x = sprite->srcX;
 	}
 	else {
@@ -288,75 +385,48 @@ void blitAndUpdateSpriteAnimatedEX(SpriteAnimated* sprite, int x, int y, float a
 	dest.w = sprite->w;
 	dest.h = sprite->h;
 
-	//blit the sprite with the specified center of orientation
-	switch (sprite->center) {
-	case(SC_TOP_LEFT):
-		dest.x = x;
-		dest.y = y;
-		break;
-	case(SC_TOP_CENTER):
-		dest.x = x - dest.w * 0.5;
-		dest.y = y;
-		break;
-	case(SC_TOP_RIGHT):
-		dest.x = x - dest.w;
-		dest.y = y;
-		break;
-	case(SC_CENTER_LEFT):
-		dest.x = x;
-		dest.y = y - dest.h * 0.5;
-		break;
-	case(SC_CENTER):
-		dest.x = x - dest.w * 0.5;
-		dest.y = y - dest.h * 0.5;
-		break;
-	case(SC_CENTER_RIGHT):
-		dest.x = x - dest.w;
-		dest.y = y - dest.h * 0.5;
-		break;
-	case(SC_BOTTOM_LEFT):
-		dest.x = x;
-		dest.y = y - dest.h;
-		break;
-	case(SC_BOTTOM_CENTER):
-		dest.x = x - dest.w * 0.5;
-		dest.y = y - dest.h;
-		break;
-	case(SC_BOTTOM_RIGHT):
-		dest.x = x - dest.w;
-		dest.y = y - dest.h;
-		break;
-	}
+	//line the sprite's origin up with the coordinates
+	dest.x = x - sprite->pivotX;
+	dest.y = y - sprite->pivotY;
 
-	SDL_RenderCopyEx(app.renderer, sprite->atlas->texture, &src, &dest, angle, origin, flip);
-
-	//updating animation
-
-	//progress animation
-	sprite->currentFrame += sprite->spd;
-	//loop behavior
-	if (sprite->currentFrame >= sprite->frames || sprite->currentFrame < 0) {
-		switch (sprite->loopBehavior) {
-		case(AL_ONESHOT):
-			//lock animation on the last frame
-			sprite->currentFrame = sprite->frames - 1;
-			break;
-		case(AL_LOOP):
-			//go back to start of animation
-			sprite->currentFrame = 0;
-			break;
-		case(AL_BACK_AND_FORTH):
-			sprite->currentFrame -= sprite->spd;	//make sure currentFrame stays within the bounds of the current animation
-			sprite->spd = -sprite->spd;	//negate speed, inverting animation direction
-			break;
-		}
+	if (angle == 0 || flip != SDL_FLIP_NONE || !blitPreRotated(sprite->rotations, (src.x - sprite->srcX) / sprite->w, &dest, angle, origin))
+		queueQuad(currentLayer, sprite->atlas->texture, SDL_BLENDMODE_BLEND, &src, &dest, angle, origin, flip, getTextureRGBA(sprite->atlas->texture));
+
+}
+
+//queues up the baked rotation of a frame that's closest to angle, if there is one
+//the frame is baked rotated around its own center, so if it's being rotated around some other origin, the copy gets moved to where its center would end up
+//returns false if the frame should be rotated exactly instead
+static bool blitPreRotated(const PreRotatedSprite *rotations, int frame, const SDL_Rect *dest, float angle, const SDL_Point *origin) {
+	SDL_Texture *page;
+	SDL_Rect src;
+
+	if (rotations == NULL || !getPreRotatedFrame(rotations, frame, angle, &page, &src))
+		return false;
+
+	float centerX = dest->x + dest->w * 0.5;
+	float centerY = dest->y + dest->h * 0.5;
+
+	if (origin != NULL) {
+		float offsetX = dest->w * 0.5 - origin->x;
+		float offsetY = dest->h * 0.5 - origin->y;
+		float c = cos(angle * DEGREES_TO_RADIANS);
+		float s = sin(angle * DEGREES_TO_RADIANS);
+
+		centerX = dest->x + origin->x + c * offsetX - s * offsetY;
+		centerY = dest->y + origin->y + s * offsetX + c * offsetY;
 	}
+
+	SDL_Rect rotatedDest = { (int)floor(centerX - src.w * 0.5 + 0.5), (int)floor(centerY - src.h * 0.5 + 0.5), src.w, src.h };
+	queueQuad(currentLayer, page, SDL_BLENDMODE_BLEND, &src, &rotatedDest, 0, NULL, SDL_FLIP_NONE, getTextureRGBA(rotations->source));
+
+	return true;
 }
 
 
 
 //initializers and destructors
-//all use dynamic allocation, make sure to use free() and destructors
+//all use dynamic allocation, make sure to use free() and destructors (deleteSpriteAnimated for animated sprites; see animations.h)
 //srcX, srcY, w and h are all in grid coordinates, not pixels
 
 //loads the atlas's texture and initializes its members
@@ -375,16 +445,87 @@ SpriteAtlas* initSpriteAtlas(char* filename) {
 	return atlas;
 }
 
+//same as initSpriteAtlas, but for an image that's already been decoded (see loading.c); the caller still owns the image
+SpriteAtlas *initSpriteAtlasFromImage(SDL_Surface *image) {
+	SpriteAtlas *atlas = calloc(1, sizeof(SpriteAtlas));
+	atlas->texture = createTextureFromImage(image);
+
+	if (atlas->texture == NULL) {
+		printf("ERROR - Sprite atlas texture could not be created: %s\n", SDL_GetError());
+		free(atlas);
+		return NULL;
+	}
+
+	atlas->w = image->w;
+	atlas->h = image->h;
+
+	return atlas;
+}
+
+//puts two decoded images on one texture page, and makes an atlas for each that draws from its part of the page
+//sprites from both atlases then batch together instead of switching textures back and forth
+//the first image goes in the top left, so its coordinates (e.g. the sprite table's, and the collision masks') don't change
+//if the page would be too big for the renderer, each image just gets its own texture
+//the caller still owns the images; returns false if either atlas couldn't be made
+bool initSharedSpriteAtlases(SDL_Surface *first, SDL_Surface *second, SpriteAtlas **firstAtlas, SpriteAtlas **secondAtlas) {
+	//the second image goes under the first or to the right of it, whichever makes the smaller page
+	int belowW = MAX(first->w, second->w), belowH = first->h + SHARED_ATLAS_PADDING + second->h;
+	int rightW = first->w + SHARED_ATLAS_PADDING + second->w, rightH = MAX(first->h, second->h);
+	bool below = belowW * belowH <= rightW * rightH;
+	int pageW = below ? belowW : rightW;
+	int pageH = below ? belowH : rightH;
+
+	SDL_RendererInfo info;
+	SDL_Surface *page = NULL;
+	if (SDL_GetRendererInfo(app.renderer, &info) == 0 && (info.max_texture_width == 0 || pageW <= info.max_texture_width) && (info.max_texture_height == 0 || pageH <= info.max_texture_height))
+		page = SDL_CreateRGBSurfaceWithFormat(0, pageW, pageH, 32, first->format->format);
+
+	if (page == NULL) {
+		printf("WARNING - Sprite atlases could not share a texture; they'll be drawn from separate ones.\n");
+		*firstAtlas = initSpriteAtlasFromImage(first);
+		*secondAtlas = initSpriteAtlasFromImage(second);
+		return *firstAtlas != NULL && *secondAtlas != NULL;
+	}
+
+	//copy the images as they are rather than blending them onto the (transparent) page, which would darken any translucent pixels
+	SDL_Rect secondRect = { below ? 0 : first->w + SHARED_ATLAS_PADDING, below ? first->h + SHARED_ATLAS_PADDING : 0, second->w, second->h };
+	SDL_BlendMode firstBlendMode, secondBlendMode;
+	SDL_GetSurfaceBlendMode(first, &firstBlendMode);
+	SDL_GetSurfaceBlendMode(second, &secondBlendMode);
+	SDL_SetSurfaceBlendMode(first, SDL_BLENDMODE_NONE);
+	SDL_SetSurfaceBlendMode(second, SDL_BLENDMODE_NONE);
+	SDL_BlitSurface(first, NULL, page, NULL);
+	SDL_BlitSurface(second, NULL, page, &secondRect);
+	SDL_SetSurfaceBlendMode(first, firstBlendMode);
+	SDL_SetSurfaceBlendMode(second, secondBlendMode);
+
+	*firstAtlas = initSpriteAtlasFromImage(page);
+	*secondAtlas = NULL;
+	SDL_FreeSurface(page);
+
+	if (*firstAtlas == NULL)
+		return false;
+
+	//the first atlas owns the texture
+	*secondAtlas = calloc(1, sizeof(SpriteAtlas));
+	**secondAtlas = **firstAtlas;
+	(*secondAtlas)->offsetX = secondRect.x;
+	(*secondAtlas)->offsetY = secondRect.y;
+	(*secondAtlas)->sharedTexture = true;
+
+	return true;
+}
+
 //initializes struct's members
 SpriteStatic* initSpriteStatic(const SpriteAtlas* atlas, int srcX, int srcY, int w, int h, SpriteCenter center) {
 	SpriteStatic* sprite = calloc(1, sizeof(SpriteStatic));
 	sprite->atlas = atlas;
 	//convert these bits into pixels now for quicker calculations later
-	sprite->srcX = srcX * SPRITE_ATLAS_CELL_W;
-	sprite->srcY = srcY * SPRITE_ATLAS_CELL_H;
+	sprite->srcX = atlas->offsetX + srcX * SPRITE_ATLAS_CELL_W;
+	sprite->srcY = atlas->offsetY + srcY * SPRITE_ATLAS_CELL_H;
 	sprite->w = w * SPRITE_ATLAS_CELL_W;
 	sprite->h = h * SPRITE_ATLAS_CELL_H;
-	sprite->center = center;
+	getCenterPivot(center, sprite->w, sprite->h, &sprite->pivotX, &sprite->pivotY);
 
 	return sprite;
 }
@@ -392,14 +533,14 @@ SpriteStatic* initSpriteStatic(const SpriteAtlas* atlas, int srcX, int srcY, int
 //initializes struct's members
 //current frame should be set to 0 unless you want to start the animation after its beginning
 SpriteAnimated* initSpriteAnimated(const SpriteAtlas* atlas, int srcX, int srcY, int w, int h, SpriteCenter center, int frames, float currentFrame, float spd, AnimationLoop loopBehavior) {
-	SpriteAnimated* sprite = calloc(1, sizeof(SpriteAnimated));
+	SpriteAnimated* sprite = allocSpriteAnimated();
 	sprite->atlas = atlas;
 	//convert these bits into pixels now for quicker calculations later
-	sprite->srcX = srcX * SPRITE_ATLAS_CELL_W;
-	sprite->srcY = srcY * SPRITE_ATLAS_CELL_H;
+	sprite->srcX = atlas->offsetX + srcX * SPRITE_ATLAS_CELL_W;
+	sprite->srcY = atlas->offsetY + srcY * SPRITE_ATLAS_CELL_H;
 	sprite->w = w * SPRITE_ATLAS_CELL_W;
 	sprite->h = h * SPRITE_ATLAS_CELL_W;
-	sprite->center = center;
+	getCenterPivot(center, sprite->w, sprite->h, &sprite->pivotX, &sprite->pivotY);
 
 	sprite->frames = frames;
 	sprite->currentFrame = currentFrame;
@@ -409,9 +550,174 @@ SpriteAnimated* initSpriteAnimated(const SpriteAtlas* atlas, int srcX, int srcY,
 	return sprite;
 }
 
+//works out a sprite's pivot (in pixels from its top left) from a SpriteCenter
+static void getCenterPivot(SpriteCenter center, int w, int h, int *pivotX, int *pivotY) {
+	//SpriteCenters go left to right, then top to bottom
+	*pivotX = w * (center % 3) / 2;
+	*pivotY = h * (center / 3) / 2;
+}
+
+//initializes a static sprite from a sprite definition (which is already in pixels)
+//frame picks which frame of an animated definition to use
+SpriteStatic *initSpriteStaticFromDef(SpriteAtlas *atlas, const SpriteDef *def, int frame) {
+	SpriteStatic *sprite = calloc(1, sizeof(SpriteStatic));
+	sprite->atlas = atlas;
+	sprite->srcX = atlas->offsetX + def->x + frame * def->w;
+	sprite->srcY = atlas->offsetY + def->y;
+	sprite->w = def->w;
+	sprite->h = def->h;
+	sprite->pivotX = def->pivotX;
+	sprite->pivotY = def->pivotY;
+
+	return sprite;
+}
+
+//initializes an animated sprite from a sprite definition (which is already in pixels)
+//the animation gets the definition's speed and loop behavior; change them afterwards if needed
+SpriteAnimated *initSpriteAnimatedFromDef(SpriteAtlas *atlas, const SpriteDef *def, float currentFrame) {
+	SpriteAnimated *sprite = allocSpriteAnimated();
+	sprite->atlas = atlas;
+	sprite->srcX = atlas->offsetX + def->x;
+	sprite->srcY = atlas->offsetY + def->y;
+	sprite->w = def->w;
+	sprite->h = def->h;
+	sprite->pivotX = def->pivotX;
+	sprite->pivotY = def->pivotY;
+
+	sprite->frames = def->frames;
+	sprite->currentFrame = currentFrame;
+	sprite->spd = def->spd;
+	sprite->loopBehavior = def->loopBehavior;
+
+	return sprite;
+}
+
+//initializes a static sprite from the gameplay sprite table
+SpriteStatic *initSpriteStaticFromTable(SpriteId id, int frame) {
+	return initSpriteStaticFromDef(app.gameplaySprites, &SPRITE_TABLE[id], frame);
+}
+
+//initializes an animated sprite from the gameplay sprite table
+SpriteAnimated *initSpriteAnimatedFromTable(SpriteId id, float currentFrame) {
+	return initSpriteAnimatedFromDef(app.gameplaySprites, &SPRITE_TABLE[id], currentFrame);
+}
+
+//checks if a sprite was made from a sprite in the gameplay sprite table
+bool isSpriteFromTable(const SpriteAnimated *sprite, SpriteId id) {
+	return sprite->atlas == app.gameplaySprites && sprite->srcX == app.gameplaySprites->offsetX + SPRITE_TABLE[id].x && sprite->srcY == app.gameplaySprites->offsetY + SPRITE_TABLE[id].y;
+}
+
+//makes a sprite draw from baked rotations instead of being rotated exactly (when the quality preference asks for it)
+//call after initSpriteStatic; the sprite should be in PRE_ROTATED_SPRITES, otherwise the page gets rebuilt at the start of the next frame
+void preRotateSpriteStatic(SpriteStatic *sprite) {
+	sprite->rotations = getPreRotatedSprite(sprite->atlas->texture, sprite->srcX, sprite->srcY, sprite->w, sprite->h, 1);
+}
+
+//same as preRotateSpriteStatic, but bakes every frame of the animation
+void preRotateSpriteAnimated(SpriteAnimated *sprite) {
+	sprite->rotations = getPreRotatedSprite(sprite->atlas->texture, sprite->srcX, sprite->srcY, sprite->w, sprite->h, sprite->frames);
+}
+
+//adds every sprite in PRE_ROTATED_SPRITES to the pre-rotation page, and bakes the page
+//call once while loading, after the gameplay atlas is made
+void initPreRotatedSprites(void) {
+	for (size_t i = 0; i < sizeof(PRE_ROTATED_SPRITES) / sizeof(PRE_ROTATED_SPRITES[0]); ++i) {
+		const SpriteDef *def = &SPRITE_TABLE[PRE_ROTATED_SPRITES[i]];
+		getPreRotatedSprite(app.gameplaySprites->texture, app.gameplaySprites->offsetX + def->x, app.gameplaySprites->offsetY + def->y, def->w, def->h, def->frames);
+	}
+
+	updatePreRotations();
+}
+
 //destructor for spriteAtlas (call free() on other structs)
 void deleteSpriteAtlas(SpriteAtlas* atlas) {
-	SDL_DestroyTexture(atlas->texture);
+	//atlases are NULL if they never got loaded
+	if (atlas == NULL)
+		return;
+
+	if (!atlas->sharedTexture) {
+		flushRenderQueue();	//in case the queue is still holding onto this texture
+		unregisterSoftRasterTexture(atlas->texture);
+		SDL_DestroyTexture(atlas->texture);
+	}
 	free(atlas);
 	atlas = NULL;	//clean up dangling pointer
+}
+
+//starts drawing into a render cache
+//returns false if the cache is still good, in which case there's nothing to draw; otherwise, draw its contents and call endRenderCache
+//if the cache's texture can't be made, this returns true without redirecting anything, so the contents just get drawn normally every frame
+bool beginRenderCache(RenderCache *cache) {
+	if (cache->valid && cache->generation == renderCacheGeneration)
+		return false;
+
+	if (cache->texture == NULL) {
+		cache->texture = SDL_CreateTexture(app.renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+		if (cache->texture == NULL) {
+			printf("WARNING - Render cache texture could not be created: %s\n", SDL_GetError());
+			return true;
+		}
+
+		//the cache is drawn into with normal blending on top of transparent black, which leaves its colors premultiplied by alpha
+		//so it has to be drawn to the screen with a premultiplied blend mode, or semitransparent pixels come out too dark
+		cache->blendMode = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+			SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+		if (SDL_SetTextureBlendMode(cache->texture, cache->blendMode) != 0)
+			cache->blendMode = SDL_BLENDMODE_BLEND;	//renderer doesn't support it; close enough
+	}
+
+	//draw anything queued so far to the screen, then switch over to the cache
+	flushRenderQueue();
+	SDL_SetRenderTarget(app.renderer, cache->texture);
+	SDL_SetRenderDrawColor(app.renderer, 0x0, 0x0, 0x0, 0x0);
+	SDL_RenderClear(app.renderer);
+
+	layerBeforeCache = currentLayer;
+
+	return true;
+}
+
+//finishes drawing into a render cache and switches back to drawing to the screen
+void endRenderCache(RenderCache *cache) {
+	if (cache->texture == NULL)
+		return;
+
+	flushRenderQueue();
+	SDL_SetRenderTarget(app.renderer, sceneTarget);
+
+	cache->valid = true;
+	cache->generation = renderCacheGeneration;
+	currentLayer = layerBeforeCache;
+}
+
+//draws a render cache over the whole screen, on the current layer
+void drawRenderCache(const RenderCache *cache) {
+	if (cache->texture == NULL || !cache->valid)
+		return;
+
+	SDL_Rect screen = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+	queueQuad(currentLayer, cache->texture, cache->blendMode, &screen, &screen, 0, NULL, SDL_FLIP_NONE, (SDL_Color){ 255, 255, 255, 255 });
+}
+
+//makes a render cache get redrawn the next time it's used
+void invalidateRenderCache(RenderCache *cache) {
+	cache->valid = false;
+}
+
+//makes every render cache get redrawn the next time it's used
+//call when the renderer throws away the contents of target textures
+void invalidateAllRenderCaches(void) {
+	++renderCacheGeneration;
+}
+
+//frees a render cache's texture (the cache itself can be used again afterwards)
+void deleteRenderCache(RenderCache *cache) {
+	if (cache->texture != NULL) {
+		flushRenderQueue();	//in case the queue is still holding onto this texture
+		SDL_DestroyTexture(cache->texture);
+	}
+
+	cache->texture = NULL;
+	cache->valid = false;
 }
\ No newline at end of file
@@ -1,16 +1,23 @@
 #ifndef DRAW_H
 #define DRAW_H
 
+#include "preRotations.h"
+#include "renderQueue.h"
+
 /*
 * Various structs and functions related to drawing stuff.
 * This section needs some const pointers to avoid a lot of really inefficient copying
 */
 
 //Contains the texture of a sprite atlas, plus relevant information related to it
+//Several atlases can share one texture (see initSharedSpriteAtlases), so that sprites from all of them batch together
 typedef struct {
 	SDL_Texture* texture;
-	int w;	//width in pixels
-	int h;	//height in pixels
+	int w;	//width of the texture in pixels
+	int h;	//height of the texture in pixels
+	int offsetX;	//where this atlas's image is on the texture, in pixels (only non-zero for shared textures)
+	int offsetY;
+	bool sharedTexture;	//if true, another atlas owns the texture, so deleting this one leaves the texture alone
 } SpriteAtlas;
 
 typedef enum {
@@ -32,9 +39,20 @@ typedef struct {
 	int srcY;	//topmost cell coordinate in cells
 	int w;		//width of one frame in cells
 	int h;		//height of one frame in cells
-	SpriteCenter center;	//determines where the center of the sprite is considered to be (a better name would probably be "origin")
+	int pivotX;	//where the sprite's origin is, in pixels from the top left of the sprite (worked out from its SpriteCenter, or from the sprite table)
+	int pivotY;
+	const PreRotatedSprite *rotations;	//baked rotations to draw from when rotated (NULL to always rotate exactly)
 } SpriteStatic;
 
+//A screen-sized texture that a static part of the scene gets drawn into once, then gets drawn from every frame until it's invalidated.
+//Zero-initialize these (e.g. declare them static); the texture is made the first time the cache is drawn into.
+typedef struct {
+	SDL_Texture *texture;
+	SDL_BlendMode blendMode;	//blend mode for drawing the cache to the screen
+	bool valid;					//false if the cache needs to be redrawn
+	int generation;				//see invalidateAllRenderCaches
+} RenderCache;
+
 //Specifies animation loop behavior.
 //AL stands for animation loop.
 typedef enum {
@@ -43,6 +61,22 @@ typedef enum {
 	AL_BACK_AND_FORTH	//reverse animation direction when either end of the animation is reached
 } AnimationLoop;
 
+//Where a sprite is on a packed atlas, plus how it's drawn and animated.
+//The atlas packer (tools/atlasPacker.c) generates a table of these for the gameplay sprites; see spriteTable.h.
+typedef struct {
+	int x;			//left of the first frame in pixels
+	int y;			//top of the first frame in pixels
+	int w;			//width of one frame in pixels
+	int h;			//height of one frame in pixels
+	int pivotX;		//where the sprite's origin is, in pixels from the top left of a frame
+	int pivotY;
+	int frames;		//number of frames, laid out left to right
+	float spd;		//default animation speed
+	AnimationLoop loopBehavior;
+} SpriteDef;
+
+#include "spriteTable.h"
+
 //A structure to keep track of important animation variables.
 typedef struct {
 	//sprite vars
@@ -51,30 +85,59 @@ typedef struct {
 	int srcY;	//topmost cell coordinate in cells
 	int w;		//width of one frame in cells
 	int h;		//height of one frame in cells
-	SpriteCenter center;	//determines where the center of the sprite is considered to be (a better name would probably be "origin")
+	int pivotX;	//where the sprite's origin is, in pixels from the top left of a frame (worked out from its SpriteCenter, or from the sprite table)
+	int pivotY;
+	const PreRotatedSprite *rotations;	//baked rotations to draw from when rotated (NULL to always rotate exactly)
 
 	//anim vars
 	int frames;			//number of frames in the animation
-	float currentFrame;	//keeps track of the frame the animation is currently on. Should be incremented by spd every frame until it exceeds sprite->frames.
+	float currentFrame;	//keeps track of the frame the animation is currently on. Incremented by spd every logic tick (see animations.h) until it exceeds sprite->frames.
 	float spd;			//animation speed
 	AnimationLoop loopBehavior;		//Defines how the animation loops
 } SpriteAnimated;
 
 void prepareScene(void);
 void presentScene(void);
+void updateWindowScale(void);
+void deleteSceneTarget(void);
+void setRenderLayer(RenderLayer layer);
 SDL_Texture* loadTexture(char* filename);
+SDL_Texture *createTextureFromImage(SDL_Surface *image);
 void setTextureRGBA(SDL_Texture *texture, int r, int g, int b, int a);
+SDL_Color getTextureRGBA(SDL_Texture *texture);
+void drawFilledRect(const SDL_Rect *rect, SDL_Color color);
+SDL_Vertex *drawTextureQuads(SDL_Texture *texture, int quads);
 void blitSpriteStatic(const SpriteStatic *sprite, int x, int y);
 void blitSpriteStaticEX(const SpriteStatic *sprite, int x, int y, float angle, const SDL_Point *origin, SDL_RendererFlip flip);
-void blitAndUpdateSpriteAnimated(SpriteAnimated* sprite, int x, int y);
-void blitAndUpdateSpriteAnimatedEX(SpriteAnimated* sprite, int x, int y, float angle, const SDL_Point* origin, SDL_RendererFlip flip);
+void blitSpriteAnimated(const SpriteAnimated *sprite, int x, int y);
+void blitSpriteAnimatedEX(const SpriteAnimated *sprite, int x, int y, float angle, const SDL_Point *origin, SDL_RendererFlip flip);
 
 //initializers (all use dynamic allocation, make sure to free())
 SpriteAtlas* initSpriteAtlas(char* filename);
+SpriteAtlas *initSpriteAtlasFromImage(SDL_Surface *image);
+bool initSharedSpriteAtlases(SDL_Surface *first, SDL_Surface *second, SpriteAtlas **firstAtlas, SpriteAtlas **secondAtlas);
 SpriteStatic *initSpriteStatic(const SpriteAtlas *atlas, int srcX, int srcY, int w, int h, SpriteCenter center);
 SpriteAnimated *initSpriteAnimated(const SpriteAtlas *atlas, int srcX, int srcY, int w, int h, SpriteCenter center, int frames, float currentFrame, float spd, AnimationLoop loopBehavior);
+SpriteStatic *initSpriteStaticFromDef(SpriteAtlas *atlas, const SpriteDef *def, int frame);
+SpriteAnimated *initSpriteAnimatedFromDef(SpriteAtlas *atlas, const SpriteDef *def, float currentFrame);
+SpriteStatic *initSpriteStaticFromTable(SpriteId id, int frame);
+SpriteAnimated *initSpriteAnimatedFromTable(SpriteId id, float currentFrame);
+bool isSpriteFromTable(const SpriteAnimated *sprite, SpriteId id);
+
+//for sprites that get drawn at lots of different angles (see preRotations.h)
+void preRotateSpriteStatic(SpriteStatic *sprite);
+void preRotateSpriteAnimated(SpriteAnimated *sprite);
+void initPreRotatedSprites(void);
 
 //destructor for spriteAtlas (call free() on other structs)
 void deleteSpriteAtlas(SpriteAtlas* atlas);
 
+//render caches
+bool beginRenderCache(RenderCache *cache);
+void endRenderCache(RenderCache *cache);
+void drawRenderCache(const RenderCache *cache);
+void invalidateRenderCache(RenderCache *cache);
+void invalidateAllRenderCaches(void);
+void deleteRenderCache(RenderCache *cache);
+
 #endif
\ No newline at end of file
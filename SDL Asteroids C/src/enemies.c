@@ -2,7 +2,10 @@
 
 #include "enemies.h"
 
+#include "animations.h"
 #include "bullets.h"
+#include "composites.h"
+#include "debugDraw.h"
 #include "draw.h"
 #include "geometry.h"
 #include "particles.h"
@@ -35,7 +38,7 @@ int enemySpawnTimer = 0;	//wait 15 seconds before spawning any enemies
 static void muzzleFlashDraw(Particle *particle) {
 	//only draw if muzzle flash isn't at the end of its animation
 	if (particle->sprite->currentFrame != particle->sprite->frames - 1) {
-		blitAndUpdateSpriteAnimated(particle->sprite, particle->x, particle->y);
+		blitSpriteAnimated(particle->sprite, particle->x, particle->y);
 	}
 }
 
@@ -74,6 +77,8 @@ void initEnemy(void) {
 		break;
 	}
 
+	addDebugSpawnPoint(enemy->x, enemy->y, "ENEMY");
+
 	enemy->speed = randFloatRange(1, 2);
 	enemy->angle = atan2((player->y - enemy->y), (player->x - enemy->x)) * RADIANS_TO_DEGREES;
 	enemy->state = ES_ENTER_STAGE;
@@ -81,11 +86,14 @@ void initEnemy(void) {
 	enemy->dirVector.y = sin(enemy->angle * DEGREES_TO_RADIANS);
 	enemy->reload = FPS * 3;	//enemy shouldn't fire immediately
 	enemy->hp = ENEMY_HEALTH_MAX;
-	enemy->sprite = initSpriteStatic(app.gameplaySprites, 6, 7, 4, 4, SC_CENTER);
-	enemy->spriteHitflash = initSpriteStatic(app.gameplaySprites, 10, 7, 4, 4, SC_CENTER);
-	enemy->spriteFlame = initSpriteAnimated(app.gameplaySprites, 16, 16, 1, 1, SC_CENTER, 4, 0, 0.25, AL_LOOP);
-	enemy->muzzleFlash = initParticle(initSpriteAnimated(app.gameplaySprites, 16, 14, 2, 2, SC_CENTER, 5, 5, 0.2, AL_ONESHOT), enemy->x, enemy->y, 0, 0, 0, 1, NULL, muzzleFlashDraw);
-	enemy->collider = initOBBCollider(enemy->sprite->w * 0.35, enemy->sprite->h * 0.35, (Vector2){enemy->x, enemy->y}, enemy->angle);
+	enemy->sprite = initSpriteStaticFromTable(SPR_ENEMY, 0);
+	enemy->spriteHitflash = initCompositeSprite(CS_ENEMY_HITFLASH);
+	enemy->spriteFlame = initSpriteAnimatedFromTable(SPR_FLAME, 0);
+	preRotateSpriteStatic(enemy->sprite);
+	preRotateSpriteAnimated(enemy->spriteFlame);
+	enemy->muzzleFlash = initParticle(initSpriteAnimatedFromTable(SPR_MUZZLE_FLASH_ENEMY, 5), enemy->x, enemy->y, 0, 0, 0, 1, NULL, muzzleFlashDraw);
+	enemy->collider = initOBBCollider(enemy->sprite->w * 0.5, enemy->sprite->h * 0.5, (Vector2){enemy->x, enemy->y}, enemy->angle * DEGREES_TO_RADIANS, CL_ENEMY_ENTERING, enemy);	//enemies can't be hit until they've entered the stage
+	setColliderPixelMasks(enemy->collider, getSpritePixelMasks(SPR_ENEMY));
 	enemy->next = NULL;
 }
 
@@ -99,13 +107,17 @@ static void esEnterStage(Enemy *enemy) {
 	//check if enemy is inbounds; if they are, switch to normal state
 	float horzEdgeDist = enemy->sprite->w * SCREENWRAP_MARGIN;
 	float vertEdgeDist = enemy->sprite->h * SCREENWRAP_MARGIN;
-	if (enemy->x >= -horzEdgeDist && enemy->x <= SCREEN_WIDTH + horzEdgeDist && enemy->y >= -vertEdgeDist && enemy->y <= SCREEN_HEIGHT + vertEdgeDist)
+	if (enemy->x >= -horzEdgeDist && enemy->x <= SCREEN_WIDTH + horzEdgeDist && enemy->y >= -vertEdgeDist && enemy->y <= SCREEN_HEIGHT + vertEdgeDist) {
 		enemy->state = ES_NORMAL;
+		setColliderLayer(enemy->collider, CL_ENEMY);	//enemy can be hit now
+	}
 }
 
 static void esNormal(Enemy *enemy) {
-	//update enemy's angle
-	enemy->angle = atan2((player->y - enemy->y), (player->x - enemy->x)) * RADIANS_TO_DEGREES;
+	//aim at the nearest (living) player
+	OBBCollider *target;
+	if (queryNearest(LAYER_BIT(CL_PLAYER), (Vector2) { enemy->x, enemy->y }, false, &target, 1) > 0)
+		enemy->angle = atan2((target->origin.y - enemy->y), (target->origin.x - enemy->x)) * RADIANS_TO_DEGREES;
 
 	//update position
 	enemy->x += enemy->dirVector.x * enemy->speed;
@@ -160,13 +172,15 @@ void updateEnemies(void) {
 			enemy->muzzleFlash->y = enemy->y + sin(enemy->angle * DEGREES_TO_RADIANS) * BULLET_OFFSET_ENEMY + 4;
 		}
 
-		//update hitflash timer
+		//update hitflash timer, and pick the hitflash level to draw the enemy with
 		++enemy->timeSinceDamaged;
+		if (enemy->timeSinceDamaged < END_OF_FLASH)
+			enemy->spriteHitflash->currentFrame = getHitflashLevel(enemy->timeSinceDamaged);
 
 		//if an enemy's lost its HP, delete it
 		if (enemy->hp <= 0) {
 			//death explosion
-			initParticle(initSpriteAnimated(app.gameplaySprites, 0, 18, 4, 4, SC_CENTER, 5, 0, 0.3, AL_ONESHOT), enemy->x, enemy->y, 0, 0, (float)(rand() % 4) * 90, 1, NULL, explosionDraw);
+			initParticle(initSpriteAnimatedFromTable(SPR_EXPLOSION, 0), enemy->x, enemy->y, 0, 0, (float)(rand() % 4) * 90, 1, explosionUpdate, explosionDraw);
 			playSound(SFX_ENEMY_KILL, SC_ENEMY, false, enemy->x / SCREEN_WIDTH * 255);
 
 			//add 10 scrap pieces to stage
@@ -215,28 +229,28 @@ void spawnEnemies(void) {
 
 //draws enemies
 void drawEnemies(void) {
+	setRenderLayer(RL_ENEMIES);
+
 	Enemy *enemy = stage.enemyHead;
 
 	while (enemy != NULL) {
 		//draw muzzle flash if there's something to be drawn
 		if (enemy->muzzleFlash->sprite->currentFrame != enemy->muzzleFlash->sprite->frames - 1)
-			blitAndUpdateSpriteAnimatedEX(enemy->muzzleFlash->sprite, enemy->muzzleFlash->x, enemy->muzzleFlash->y, enemy->angle, NULL, SDL_FLIP_NONE);
+			blitSpriteAnimatedEX(enemy->muzzleFlash->sprite, enemy->muzzleFlash->x, enemy->muzzleFlash->y, enemy->angle, NULL, SDL_FLIP_NONE);
 
 		//draw enemy
 		if (enemy->timeSinceDamaged < END_OF_FLASH) {
-			//draw hitflash over normal sprite, decreasing its transparency the longer it's been since the enemy was hit
-			blitSpriteStaticEX(enemy->sprite, enemy->x, enemy->y, enemy->angle, NULL, SDL_FLIP_NONE);
-			setTextureRGBA(enemy->sprite->atlas->texture, 255, 255, 255, (int)(255 * (float)(END_OF_FLASH - enemy->timeSinceDamaged) / (float)END_OF_FLASH));
-			blitSpriteStaticEX(enemy->spriteHitflash, enemy->x, enemy->y, enemy->angle, NULL, SDL_FLIP_NONE);
-			setTextureRGBA(enemy->sprite->atlas->texture, 255, 255, 255, 255);
+			//draw the sprite with hitflash baked over it, fading out the longer it's been since the enemy was hit (the level's picked in updateEnemies)
+			blitSpriteAnimatedEX(enemy->spriteHitflash, enemy->x, enemy->y, enemy->angle, NULL, SDL_FLIP_NONE);
 		} else
 			blitSpriteStaticEX(enemy->sprite, enemy->x, enemy->y, enemy->angle, NULL, SDL_FLIP_NONE);
 
 		//draw flame
-		blitAndUpdateSpriteAnimatedEX(enemy->spriteFlame, enemy->x - 28, enemy->y, enemy->angle, &(SDL_Point) {enemy->spriteFlame->w * 0.5 + 28, enemy->spriteFlame->h * 0.5}, SDL_FLIP_NONE);
+		blitSpriteAnimatedEX(enemy->spriteFlame, enemy->x - 28, enemy->y, enemy->angle, &(SDL_Point) {enemy->spriteFlame->w * 0.5 + 28, enemy->spriteFlame->h * 0.5}, SDL_FLIP_NONE);
 
 		//only happens if app.debug = true
-		displayCollider(app.renderer, &COLOR_RED, enemy->collider);
+		displayCollider(&COLOR_RED, enemy->collider);
+		debugDrawVelocity(enemy->x, enemy->y, enemy->dirVector, enemy->speed);
 
 		enemy = enemy->next;
 	}
@@ -245,8 +259,9 @@ void drawEnemies(void) {
 //deletes an enemy
 void deleteEnemy(Enemy *enemy) {
 	free(enemy->sprite);
-	free(enemy->spriteFlame);
-	free(enemy->collider);
+	deleteSpriteAnimated(enemy->spriteHitflash);
+	deleteSpriteAnimated(enemy->spriteFlame);
+	deleteCollider(enemy->collider);
 	enemy->muzzleFlash->ttl = 0;
 	free(enemy);
 	enemy = NULL;
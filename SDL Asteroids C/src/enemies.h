@@ -29,7 +29,7 @@ struct Enemy {
 	int hp;			//hit points
 	int timeSinceDamaged;	//hitflash management variable
 	SpriteStatic *sprite;
-	SpriteStatic *spriteHitflash;
+	SpriteAnimated *spriteHitflash;	//one frame per hitflash level (see composites.h)
 	SpriteAnimated *spriteFlame;
 	Particle *muzzleFlash;
 	OBBCollider *collider;
@@ -2,115 +2,254 @@
 
 #include "draw.h"
 #include "fonts.h"
+#include "glyphCache.h"
 #include "stage.h"
+#include "utility.h"
 
 extern App app;
 extern Stage stage;
 
 void drawText(char *text, int x, int y, SDL_Color color, TextAlignHorz horzAlign, int maxWidth);
 void drawTextDropShadow(char *text, int x, int y, SDL_Color textColor, TextAlignHorz horzAlign, int maxWidth, SDL_Color shadowColor, int offset);
+static void queueText(char *text, int x, int y, SDL_Color textColor, TextAlignHorz horzAlign, int maxWidth, const SDL_Color *shadowColor, int offset);
+static int countTextRuns(char *text, SDL_Texture **textures, int *glyphs);
+static int alignText(int width, int x, TextAlignHorz horzAlign, int maxWidth);
+static void buildTextQuads(SDL_Vertex *vertices, char *text, int x, int y, SDL_Color color, int maxWidth, SDL_Texture *texture);
 void findTextDimensions(char *text, int *w, int *h);
-
-//fixed widths and heights for each grapheme in this bitmap font
-static const int fontGraphemeWidth = 8;
+TextObject *initTextObject(int x, int y, TextAlignHorz horzAlign, int maxWidth, SDL_Color textColor, SDL_Color shadowColor, int shadowOffset);
+void setTextObjectText(TextObject *textObject, char *text);
+void setTextObjectInt(TextObject *textObject, char *format, int value);
+void setTextObjectColor(TextObject *textObject, SDL_Color textColor);
+void drawTextObject(TextObject *textObject);
+static void buildTextObjectQuads(TextObject *textObject);
+
+//line spacing for this bitmap font (how wide each glyph is comes from the glyph cache)
 static const int fontGraphemeHeight = 12;
-static const int spaceBetweenGraphemes = 2;
 static const int spaceBetweenLines = 4;
-static const int cellWidth = 16;
-static const int cellHeight = 16;
 
 //draw text to the screen. will draw using the only font this game has in its assets.
+//text is UTF-8; characters that aren't in the font are drawn as a box (see glyphCache.h)
 //y describes top of text, x describes left, center, or right of text depending on horzAlign
 //pass in NULL to maxWidth to draw without regards to maxWidth.
+//the whole string is queued up as one run of quads per texture its glyphs are on, with its color on the vertices
 void drawText(char *text, int x, int y, SDL_Color color, TextAlignHorz horzAlign, int maxWidth) {
-	SDL_Rect src, dest;	//source and destination rectangles for each grapheme
-
-	//set text alignment
-	if (horzAlign != TAH_LEFT) {
-		//calculate length of string in pixels to align it to screen properly
-		//it may seem inefficient to go through the whole string like this to find its length, 
-		//but it's necessary, as the length of the string can easily change during runtime depending on what variables might be getting passed into it
-		char *walker = text;
-		int textWidthPixels = 0;
-		while (*walker != '\0') {
-			++textWidthPixels;
-			++walker;
-		}	
-		textWidthPixels = textWidthPixels * (fontGraphemeWidth + spaceBetweenGraphemes);
-
-		if(maxWidth != NULL)
-			textWidthPixels = MIN(textWidthPixels, maxWidth);	//ensure that the text width doesn't exceed the maxWidth of the line
-
-		if (horzAlign == TAH_CENTER) {
-			x -= textWidthPixels * 0.5;
-		}
-		
-		if (horzAlign == TAH_RIGHT){
-			x -= textWidthPixels;
+	queueText(text, x, y, color, horzAlign, maxWidth, NULL, 0);
+}
+
+//nice shortcut function for drawing text with a drop shadow, offset by "offset" pixels
+//the shadow and the text go into the same runs of quads, shadow first so that the text ends up on top
+void drawTextDropShadow(char *text, int x, int y, SDL_Color textColor, TextAlignHorz horzAlign, int maxWidth, SDL_Color shadowColor, int offset) {
+	queueText(text, x, y, textColor, horzAlign, maxWidth, &shadowColor, offset);
+}
+
+//queues up a string's quads; pass in NULL for shadowColor to skip the drop shadow
+static void queueText(char *text, int x, int y, SDL_Color textColor, TextAlignHorz horzAlign, int maxWidth, const SDL_Color *shadowColor, int offset) {
+	SDL_Texture *textures[MAX_TEXT_RUNS];
+	int glyphs[MAX_TEXT_RUNS];
+
+	x = alignText(countTextRuns(text, textures, glyphs), x, horzAlign, maxWidth);
+
+	for (int i = 0; i < MAX_TEXT_RUNS; ++i) {
+		if (glyphs[i] == 0)
+			continue;
+
+		SDL_Vertex *vertices = drawTextureQuads(textures[i], shadowColor != NULL ? glyphs[i] * 2 : glyphs[i]);
+		if (vertices == NULL)
+			continue;
+
+		if (shadowColor != NULL) {
+			buildTextQuads(vertices, text, x + offset, y + offset, *shadowColor, maxWidth, textures[i]);
+			vertices += glyphs[i] * 4;
 		}
+		buildTextQuads(vertices, text, x, y, textColor, maxWidth, textures[i]);
 	}
+}
 
-	//set dest's initial position
-	dest.x = x;
-	dest.y = y;
-	dest.w = fontGraphemeWidth;
-	dest.h = fontGraphemeHeight;
+//sorts a string's glyphs into runs by the texture they're on (run 0 is the fonts and UI atlas, run 1 is the glyph cache page)
+//textures and glyphs need room for MAX_TEXT_RUNS; glyphs gets how many glyphs are in each run
+//returns the string's width in pixels, without wrapping
+static int countTextRuns(char *text, SDL_Texture **textures, int *glyphs) {
+	int width = 0;
 
-	//go through text string, blitting it to the screen
+	for (int i = 0; i < MAX_TEXT_RUNS; ++i) {
+		textures[i] = NULL;
+		glyphs[i] = 0;
+	}
 
-	//set text texture color
-	setTextureRGBA(app.fontsAndUI->texture, color.r, color.g, color.b, color.a);
+	const char *walker = text;
+	while (*walker != '\0') {
+		const Glyph *glyph = getGlyph(decodeUTF8(&walker));
+		int run = glyph->texture == app.fontsAndUI->texture ? 0 : 1;
 
-	while (*text != '\0') {
-		//set src's position according to the character value
-		src.x = (*text % 16) * cellWidth + 4;
-		src.y = (*text / 16) * cellHeight + 2;
-		src.w = fontGraphemeWidth;
-		src.h = fontGraphemeHeight;
+		textures[run] = glyph->texture;
+		++glyphs[run];
+		width += glyph->advance;
+	}
 
-		SDL_RenderCopy(app.renderer, app.fontsAndUI->texture, &src, &dest);
+	return width;
+}
+
+//finds the leftmost x of a string of text that's width pixels wide, according to its alignment
+static int alignText(int width, int x, TextAlignHorz horzAlign, int maxWidth) {
+	if (horzAlign == TAH_LEFT)
+		return x;
+
+	if(maxWidth != NULL)
+		width = MIN(width, maxWidth);	//ensure that the text width doesn't exceed the maxWidth of the line
+
+	if (horzAlign == TAH_CENTER)
+		x -= width * 0.5;
+
+	if (horzAlign == TAH_RIGHT)
+		x -= width;
+
+	return x;
+}
+
+//fills in one quad for each of text's glyphs that's on texture, starting with the string's top left corner at (x, y)
+//glyphs on other textures still take up their space, so every run of the same string lines up
+//vertices needs room for 4 vertices per glyph on texture (see countTextRuns)
+static void buildTextQuads(SDL_Vertex *vertices, char *text, int x, int y, SDL_Color color, int maxWidth, SDL_Texture *texture) {
+	int destX = x, destY = y;
+	const char *walker = text;
+
+	while (*walker != '\0') {
+		//find the glyph according to the character's codepoint
+		const Glyph *glyph = getGlyph(decodeUTF8(&walker));
+
+		if (glyph->texture == texture) {
+			//corners, starting at the top left and going clockwise
+			vertices[0] = (SDL_Vertex){ { destX, destY }, color, { glyph->u0, glyph->v0 } };
+			vertices[1] = (SDL_Vertex){ { destX + glyph->w, destY }, color, { glyph->u1, glyph->v0 } };
+			vertices[2] = (SDL_Vertex){ { destX + glyph->w, destY + glyph->h }, color, { glyph->u1, glyph->v1 } };
+			vertices[3] = (SDL_Vertex){ { destX, destY + glyph->h }, color, { glyph->u0, glyph->v1 } };
+			vertices += 4;
+		}
 
 		//increment dest's position so we don't render every grapheme on the same square
 		if (maxWidth != NULL) {
-			if (dest.x + fontGraphemeWidth + spaceBetweenGraphemes < maxWidth) {
-				dest.x += fontGraphemeWidth + spaceBetweenGraphemes;
+			if (destX + glyph->advance < maxWidth) {
+				destX += glyph->advance;
 			} else {	//maxWidth exceeded; wrap text vertically
-				dest.x = x;
-				dest.y += fontGraphemeHeight + spaceBetweenLines;
+				destX = x;
+				destY += fontGraphemeHeight + spaceBetweenLines;
 			}
 		}
 		else {
 			//no wrapping; just increment x
-			dest.x += fontGraphemeWidth + spaceBetweenGraphemes;
+			destX += glyph->advance;
 		}
-
-		//get next character
-		++text;
 	}
-
-	//reset text texture color
-	setTextureRGBA(app.fontsAndUI->texture, 255, 255, 255, 255);
-}
-
-//nice shortcut function for drawing text with a drop shadow, offset by "offset" pixels
-void drawTextDropShadow(char *text, int x, int y, SDL_Color textColor, TextAlignHorz horzAlign, int maxWidth, SDL_Color shadowColor, int offset) {
-	drawText(text, x + offset, y + offset, shadowColor, horzAlign, maxWidth);
-	drawText(text, x, y, textColor, horzAlign, maxWidth);
 }
 
 //finds the width and height of a string of text, and returns it through w and h
 void findTextDimensions(char *text, int *w, int *h) {
-	//find width by finding the length of the string itself
-	//this works because this game's only font is monospace
-	char *walker = text;
+	//find width by adding up how far each glyph moves along
+	const char *walker = text;
 	int textWidthPixels = 0;
-	while (*walker != '\0') {
-		++textWidthPixels;
-		++walker;
-	}
+	while (*walker != '\0')
+		textWidthPixels += getGlyph(decodeUTF8(&walker))->advance;
+
 	//NULL checks allow the user to only grab width or height
 	if (w != NULL)
-		*w = textWidthPixels * (fontGraphemeWidth + spaceBetweenGraphemes);
+		*w = textWidthPixels;
 	if (h != NULL)
 		*h = fontGraphemeHeight;	//this game's only font has the same height for (almost) every grapheme
+}
+
+//makes a new text object with an empty string
+TextObject *initTextObject(int x, int y, TextAlignHorz horzAlign, int maxWidth, SDL_Color textColor, SDL_Color shadowColor, int shadowOffset) {
+	TextObject *textObject = calloc(1, sizeof(TextObject));
+
+	textObject->x = x;
+	textObject->y = y;
+	textObject->horzAlign = horzAlign;
+	textObject->maxWidth = maxWidth;
+	textObject->textColor = textColor;
+	textObject->shadowColor = shadowColor;
+	textObject->shadowOffset = shadowOffset;
+	textObject->dirty = true;
+
+	return textObject;
+}
+
+//sets a text object's string
+//only marks it for rebuilding if the string is actually different
+void setTextObjectText(TextObject *textObject, char *text) {
+	textObject->boundFormat = NULL;
+
+	if (strcmp(textObject->text, text) == 0)
+		return;
+
+	STRNCPY(textObject->text, text, MAX_TEXT_OBJECT_LENGTH);
+	textObject->dirty = true;
+}
+
+//sets a text object's string to format with value formatted into it (e.g. "Score: %d")
+//call this every frame with the value it should show; formatting only happens when the value or format changes
+void setTextObjectInt(TextObject *textObject, char *format, int value) {
+	if (textObject->boundFormat == format && textObject->boundValue == value)
+		return;
+
+	char text[MAX_TEXT_OBJECT_LENGTH];
+	snprintf(text, MAX_TEXT_OBJECT_LENGTH, format, value);
+	setTextObjectText(textObject, text);
+
+	textObject->boundFormat = format;
+	textObject->boundValue = value;
+}
+
+//sets the color of a text object's text (not its shadow)
+void setTextObjectColor(TextObject *textObject, SDL_Color textColor) {
+	if (textObject->textColor.r == textColor.r && textObject->textColor.g == textColor.g && textObject->textColor.b == textColor.b && textObject->textColor.a == textColor.a)
+		return;
+
+	textObject->textColor = textColor;
+	textObject->dirty = true;
+}
+
+//draws a text object, rebuilding its quads first if anything about it changed
+//text objects with glyphs on the glyph cache page are rebuilt every time, since that's what keeps their glyphs from being replaced while they're on screen
+void drawTextObject(TextObject *textObject) {
+	if (textObject->dirty || textObject->runQuads[1] > 0)
+		buildTextObjectQuads(textObject);
+
+	SDL_Vertex *source = textObject->vertices;
+
+	for (int i = 0; i < MAX_TEXT_RUNS; ++i) {
+		if (textObject->runQuads[i] == 0)
+			continue;
+
+		SDL_Vertex *vertices = drawTextureQuads(textObject->runTextures[i], textObject->runQuads[i]);
+		if (vertices != NULL)
+			memcpy(vertices, source, textObject->runQuads[i] * 4 * sizeof(SDL_Vertex));
+		source += textObject->runQuads[i] * 4;
+	}
+}
+
+//lays out a text object's string and caches the quads for it (one run per texture, each with its shadow first, then its text)
+static void buildTextObjectQuads(TextObject *textObject) {
+	int glyphs[MAX_TEXT_RUNS];
+
+	textObject->w = countTextRuns(textObject->text, textObject->runTextures, glyphs);
+	int x = alignText(textObject->w, textObject->x, textObject->horzAlign, textObject->maxWidth);
+
+	SDL_Vertex *vertices = textObject->vertices;
+
+	for (int i = 0; i < MAX_TEXT_RUNS; ++i) {
+		textObject->runQuads[i] = 0;
+		if (glyphs[i] == 0)
+			continue;
+
+		if (textObject->shadowOffset != 0) {
+			buildTextQuads(vertices, textObject->text, x + textObject->shadowOffset, textObject->y + textObject->shadowOffset, textObject->shadowColor, textObject->maxWidth, textObject->runTextures[i]);
+			vertices += glyphs[i] * 4;
+			textObject->runQuads[i] += glyphs[i];
+		}
+		buildTextQuads(vertices, textObject->text, x, textObject->y, textObject->textColor, textObject->maxWidth, textObject->runTextures[i]);
+		vertices += glyphs[i] * 4;
+		textObject->runQuads[i] += glyphs[i];
+	}
+
+	textObject->dirty = false;
 }
\ No newline at end of file
@@ -3,10 +3,10 @@
 
 /*
 * Header file for bitmap font implementation.
+* Text is UTF-8. Glyphs come from glyphCache.h, so characters past ASCII can be added by dropping in more bitmap font sheets.
 * Future features:
 *	-Base implementation off of TTF rather than a bitmap
 *	-Support for multiple fonts in the same game
-*	-Unicode support (for localization support)
 *	-Read all text from files and none from literals (for localization support)
 *	-Vertical alginment support in addition to horizontal alignment support
 *	-Add support for sprites within strings
@@ -19,8 +19,45 @@ typedef enum {
 	TAH_RIGHT
 } TextAlignHorz;
 
+#define MAX_TEXT_OBJECT_LENGTH 48	//max length of a text object's string in bytes, including the null terminator
+
+//every glyph is either on the fonts and UI atlas or the glyph cache page, so a string is drawn in at most this many runs of quads
+#define MAX_TEXT_RUNS 2
+
+//a piece of text that keeps its glyph quads between frames, for text that's drawn every frame but rarely changes (score counters, tables, etc.)
+//its quads only get rebuilt when its string or color actually changes
+//use the functions below to change it rather than writing to it directly
+typedef struct {
+	char text[MAX_TEXT_OBJECT_LENGTH];
+	int x;	//same meaning as in drawText
+	int y;
+	TextAlignHorz horzAlign;
+	int maxWidth;
+	SDL_Color textColor;
+	SDL_Color shadowColor;
+	int shadowOffset;	//0 for no drop shadow
+	int w;				//width in pixels, measured when the quads are built
+
+	//value that was last formatted into text by setTextObjectInt, so that formatting can be skipped when it hasn't changed
+	char *boundFormat;	//NULL if text wasn't set by setTextObjectInt
+	int boundValue;
+
+	//cached quads, one run per texture (shadow first, then text)
+	bool dirty;
+	SDL_Texture *runTextures[MAX_TEXT_RUNS];
+	int runQuads[MAX_TEXT_RUNS];
+	SDL_Vertex vertices[(MAX_TEXT_OBJECT_LENGTH - 1) * 8];	//4 vertices per glyph, times 2 for the shadow (there are never more glyphs than bytes)
+} TextObject;
+
 void drawText(char *text, int x, int y, SDL_Color color, TextAlignHorz horzAlign, int maxWidth);
 void drawTextDropShadow(char *text, int x, int y, SDL_Color textColor, TextAlignHorz horzAlign, int maxWidth, SDL_Color shadowColor, int offset);
 void findTextDimensions(char *text, int *w, int *h);
 
+//text objects (all use dynamic allocation, make sure to free())
+TextObject *initTextObject(int x, int y, TextAlignHorz horzAlign, int maxWidth, SDL_Color textColor, SDL_Color shadowColor, int shadowOffset);
+void setTextObjectText(TextObject *textObject, char *text);
+void setTextObjectInt(TextObject *textObject, char *format, int value);
+void setTextObjectColor(TextObject *textObject, SDL_Color textColor);
+void drawTextObject(TextObject *textObject);
+
 #endif
\ No newline at end of file
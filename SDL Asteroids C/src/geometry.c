@@ -12,6 +12,7 @@ struct SDL_Point vec2ToSDL_Point(const Vector2 vec);
 void normalize(Vector2* vec);
 float dotProduct(const Vector2* a, const Vector2* b);
 float distanceSquared(float x1, float y1, float x2, float y2);
+float wrappedDistanceSquared(float x1, float y1, float x2, float y2, float wrapW, float wrapH);
 Vector2 projectVector(const Vector2* vProj, const Vector2* vOnto);
 
 //adds vectors and returns a pointer to the sum
@@ -97,6 +98,16 @@ float distanceSquared(float x1, float y1, float x2, float y2) {
 	return (float)((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
 }
 
+//returns distance squared between two points on a space that wraps around every wrapW horizontally and every wrapH vertically
+//(i.e. the shortest distance, whether or not that goes across the edge of the screen)
+float wrappedDistanceSquared(float x1, float y1, float x2, float y2, float wrapW, float wrapH) {
+	float dx = fmod(fabs(x2 - x1), wrapW);
+	float dy = fmod(fabs(y2 - y1), wrapH);
+	dx = MIN(dx, wrapW - dx);
+	dy = MIN(dy, wrapH - dy);
+	return dx * dx + dy * dy;
+}
+
 //returns vProj projected onto vOnto
 Vector2 projectVector(const Vector2 *vProj, const Vector2 *vOnto) {
 	Vector2 vFinal;
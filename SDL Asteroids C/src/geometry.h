@@ -25,6 +25,7 @@ void rotateVector(Vector2 *vec, float *angle, Vector2 origin);
 void normalize(Vector2* vec);
 float dotProduct(const Vector2* a, const Vector2* b);
 float distanceSquared(float x1, float y1, float x2, float y2);
+float wrappedDistanceSquared(float x1, float y1, float x2, float y2, float wrapW, float wrapH);
 Vector2 projectVector(const Vector2* vProj, const Vector2* vOnto);
 
 #endif
\ No newline at end of file
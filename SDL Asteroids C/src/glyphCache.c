@@ -0,0 +1,333 @@
+#include "common.h"
+
+#include "draw.h"
+#include "glyphCache.h"
+#include "renderQueue.h"
+#include "softRaster.h"
+#include "textureCache.h"
+#include "utility.h"
+
+extern App app;
+
+//glyphs the cache page has room for
+//the page is a square grid of GLYPH_CELL_SIZE cells, so this should be a square number
+#define GLYPH_CACHE_SLOTS 256
+
+//size of the hash table that finds a codepoint's slot; must be a power of 2
+#define GLYPH_CACHE_BUCKETS 512
+
+//max number of font sheets that can be loaded (or found to be missing) at once
+#define MAX_FONT_SHEETS 16
+
+//number of codepoints that come from the fonts and UI sheet (ASCII); its cells past that are all the box glyph
+#define BUILT_IN_GLYPHS 128
+
+//a glyph on the cache page
+//slots are kept in a list from most to least recently drawn, so the one to replace is always at the tail
+typedef struct {
+	Glyph glyph;
+	Uint32 codepoint;
+	Uint32 lastDrawnFlush;	//slots drawn since the render queue was last flushed can't be replaced until it's flushed again
+	int prev;				//indices of neighbouring slots in the list, or -1
+	int next;
+	int nextInBucket;		//next slot in the same hash bucket, or -1
+} GlyphSlot;
+
+//a sheet of 256 glyphs, loaded the first time one of its codepoints is drawn
+typedef struct {
+	Uint32 page;			//codepoint >> 8
+	SDL_Surface *image;		//NULL if the sheet doesn't exist
+} FontSheet;
+
+const Glyph *getGlyph(Uint32 codepoint);
+static void initBuiltInGlyphs(void);
+static bool initGlyphCachePage(void);
+static const Glyph *getCachedGlyph(Uint32 codepoint);
+static const FontSheet *getFontSheet(Uint32 page);
+static int takeSlot(void);
+static void unlinkSlot(int slot);
+static void pushSlot(int slot);
+static void removeFromBucket(int slot);
+void flushGlyphCache(void);
+void deleteGlyphCache(void);
+
+static const char *FONT_SHEET_PATH = "gfx/fonts/fontPage%04X.png";	//filled in with the sheet's page (codepoint >> 8)
+
+//layout of a font sheet, and of the fonts and UI sheet's grid: 16 cells to a row, each with a glyph sitting in it
+static const int GLYPH_CELL_SIZE = 16;
+static const int GLYPH_X = 4;			//where the glyph is in its cell
+static const int GLYPH_Y = 2;
+static const int GLYPH_W = 8;
+static const int GLYPH_H = 12;
+static const int GLYPH_ADVANCE = 10;	//the glyph's width, plus the space between glyphs
+
+static const Uint32 MISSING_GLYPH_CODEPOINT = 0x7F;	//the fonts and UI sheet's cell for this has a box in it
+
+//glyphs from the fonts and UI sheet
+static Glyph builtInGlyphs[BUILT_IN_GLYPHS];
+static bool builtInGlyphsReady = false;
+
+//the cache page
+//glyphs are copied into the surface, and only the part that changed gets uploaded to the texture, right before the render queue is flushed (see flushGlyphCache)
+static SDL_Surface *pageImage = NULL;
+static SDL_Texture *pageTexture = NULL;
+static bool pageFailed = false;		//so a page that can't be made isn't tried again every glyph
+static SDL_Rect dirtyRect;			//part of the page that's changed since the last upload
+static bool dirty = false;
+
+static GlyphSlot slots[GLYPH_CACHE_SLOTS];
+static int slotCount = 0;			//slots that have been handed out; slots past this are still empty
+static int buckets[GLYPH_CACHE_BUCKETS];
+static int mostRecent = -1;			//head and tail of the list
+static int leastRecent = -1;
+
+static FontSheet fontSheets[MAX_FONT_SHEETS];
+static int fontSheetCount = 0;
+
+static Uint32 flush = 1;			//counts up every flushGlyphCache
+static bool warnedFull = false;
+
+//looks up the glyph for a codepoint, loading it onto the cache page if it isn't there
+//never returns NULL; glyphs from the cache page are only good until the render queue is next flushed, so look them up again every time they're drawn
+const Glyph *getGlyph(Uint32 codepoint) {
+	if (!builtInGlyphsReady)
+		initBuiltInGlyphs();
+
+	if (codepoint < BUILT_IN_GLYPHS)
+		return &builtInGlyphs[codepoint];
+
+	const Glyph *glyph = getCachedGlyph(codepoint);
+
+	return glyph != NULL ? glyph : &builtInGlyphs[MISSING_GLYPH_CODEPOINT];
+}
+
+//works out where each glyph on the fonts and UI sheet is
+//has to wait until the sheet's on its texture page, since that decides the coordinates
+static void initBuiltInGlyphs(void) {
+	const SpriteAtlas *atlas = app.fontsAndUI;
+
+	for (int i = 0; i < BUILT_IN_GLYPHS; ++i) {
+		int srcX = atlas->offsetX + (i % 16) * GLYPH_CELL_SIZE + GLYPH_X;
+		int srcY = atlas->offsetY + (i / 16) * GLYPH_CELL_SIZE + GLYPH_Y;
+
+		builtInGlyphs[i] = (Glyph){ atlas->texture, (float)srcX / atlas->w, (float)srcY / atlas->h, (float)(srcX + GLYPH_W) / atlas->w, (float)(srcY + GLYPH_H) / atlas->h, GLYPH_W, GLYPH_H, GLYPH_ADVANCE };
+	}
+
+	builtInGlyphsReady = true;
+}
+
+//makes the cache page the first time a glyph needs to go on it
+static bool initGlyphCachePage(void) {
+	if (pageTexture != NULL)
+		return true;
+	if (pageFailed)
+		return false;
+
+	int columns = (int)sqrt(GLYPH_CACHE_SLOTS);
+
+	pageImage = SDL_CreateRGBSurfaceWithFormat(0, columns * GLYPH_CELL_SIZE, columns * GLYPH_CELL_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+	pageTexture = pageImage != NULL ? createTextureFromImage(pageImage) : NULL;
+
+	if (pageTexture == NULL) {
+		printf("WARNING - Glyph cache page could not be created: %s\n", SDL_GetError());
+		if (pageImage != NULL)
+			SDL_FreeSurface(pageImage);
+		pageImage = NULL;
+		pageFailed = true;
+		return false;
+	}
+
+	for (int i = 0; i < GLYPH_CACHE_BUCKETS; ++i)
+		buckets[i] = -1;
+
+	return true;
+}
+
+//finds a glyph on the cache page, or copies it there from its font sheet
+//returns NULL if there's no glyph for the codepoint, or nowhere to put it
+static const Glyph *getCachedGlyph(Uint32 codepoint) {
+	if (!initGlyphCachePage())
+		return NULL;
+
+	int bucket = codepoint & (GLYPH_CACHE_BUCKETS - 1);
+	int slot;
+
+	for (slot = buckets[bucket]; slot != -1; slot = slots[slot].nextInBucket) {
+		if (slots[slot].codepoint == codepoint)
+			break;
+	}
+
+	//not on the page yet
+	if (slot == -1) {
+		const FontSheet *sheet = getFontSheet(codepoint >> 8);
+		if (sheet == NULL || sheet->image == NULL)
+			return NULL;
+
+		slot = takeSlot();
+		if (slot == -1)
+			return NULL;
+
+		//copy the whole cell, so the glyph has its sheet's empty space around it
+		int index = codepoint & 0xFF;
+		int columns = pageImage->w / GLYPH_CELL_SIZE;
+		SDL_Rect src = { (index % 16) * GLYPH_CELL_SIZE, (index / 16) * GLYPH_CELL_SIZE, GLYPH_CELL_SIZE, GLYPH_CELL_SIZE };
+		SDL_Rect dest = { (slot % columns) * GLYPH_CELL_SIZE, (slot / columns) * GLYPH_CELL_SIZE, GLYPH_CELL_SIZE, GLYPH_CELL_SIZE };
+		SDL_BlitSurface(sheet->image, &src, pageImage, &dest);
+
+		if (dirty)
+			SDL_UnionRect(&dirtyRect, &dest, &dirtyRect);
+		else
+			dirtyRect = dest;
+		dirty = true;
+
+		float pageW = pageImage->w, pageH = pageImage->h;
+		int srcX = dest.x + GLYPH_X, srcY = dest.y + GLYPH_Y;
+		slots[slot].glyph = (Glyph){ pageTexture, srcX / pageW, srcY / pageH, (srcX + GLYPH_W) / pageW, (srcY + GLYPH_H) / pageH, GLYPH_W, GLYPH_H, GLYPH_ADVANCE };
+		slots[slot].codepoint = codepoint;
+		slots[slot].nextInBucket = buckets[bucket];
+		buckets[bucket] = slot;
+	} else
+		unlinkSlot(slot);
+
+	//move to the front of the list
+	slots[slot].lastDrawnFlush = flush;
+	pushSlot(slot);
+
+	return &slots[slot].glyph;
+}
+
+//finds the font sheet for a page of codepoints, loading it if it hasn't been looked for yet
+//returns NULL if there's no room to keep track of another sheet
+static const FontSheet *getFontSheet(Uint32 page) {
+	for (int i = 0; i < fontSheetCount; ++i) {
+		if (fontSheets[i].page == page)
+			return &fontSheets[i];
+	}
+
+	if (fontSheetCount >= MAX_FONT_SHEETS) {
+		printf("WARNING - Out of room for font sheets. Raise MAX_FONT_SHEETS.\n");
+		return NULL;
+	}
+
+	FontSheet *sheet = &fontSheets[fontSheetCount++];
+	sheet->page = page;
+	sheet->image = NULL;
+
+	char filename[MAX_STRING_LENGTH];
+	snprintf(filename, MAX_STRING_LENGTH, FONT_SHEET_PATH, page);
+
+	//most pages won't have a sheet, which isn't an error, so check before loadCachedImage complains about it
+	SDL_RWops *file = SDL_RWFromFile(filename, "rb");
+	if (file != NULL) {
+		SDL_RWclose(file);
+		sheet->image = loadCachedImage(filename);
+
+		//copy cells over as they are, rather than blending them onto whatever glyph was there before
+		if (sheet->image != NULL)
+			SDL_SetSurfaceBlendMode(sheet->image, SDL_BLENDMODE_NONE);
+	}
+
+	return sheet;
+}
+
+//gets an empty slot, or empties out the least recently drawn one
+//returns -1 if every slot has been drawn since the render queue was last flushed
+static int takeSlot(void) {
+	if (slotCount < GLYPH_CACHE_SLOTS)
+		return slotCount++;
+
+	int slot = leastRecent;
+
+	if (slots[slot].lastDrawnFlush == flush) {
+		if (!warnedFull)
+			printf("WARNING - Glyph cache page is full. Raise GLYPH_CACHE_SLOTS.\n");
+		warnedFull = true;
+		return -1;
+	}
+
+	unlinkSlot(slot);
+	removeFromBucket(slot);
+
+	return slot;
+}
+
+//takes a slot out of the list
+static void unlinkSlot(int slot) {
+	if (slots[slot].prev != -1)
+		slots[slots[slot].prev].next = slots[slot].next;
+	else
+		mostRecent = slots[slot].next;
+
+	if (slots[slot].next != -1)
+		slots[slots[slot].next].prev = slots[slot].prev;
+	else
+		leastRecent = slots[slot].prev;
+}
+
+//puts a slot at the front of the list
+static void pushSlot(int slot) {
+	slots[slot].prev = -1;
+	slots[slot].next = mostRecent;
+
+	if (mostRecent != -1)
+		slots[mostRecent].prev = slot;
+	else
+		leastRecent = slot;
+
+	mostRecent = slot;
+}
+
+//takes a slot out of its codepoint's hash bucket
+static void removeFromBucket(int slot) {
+	int *link = &buckets[slots[slot].codepoint & (GLYPH_CACHE_BUCKETS - 1)];
+
+	while (*link != slot)
+		link = &slots[*link].nextInBucket;
+
+	*link = slots[slot].nextInBucket;
+}
+
+//uploads whatever's been added to the cache page since last time
+//called by flushRenderQueue before it draws anything; after that, every glyph that's been drawn so far is free to be replaced
+void flushGlyphCache(void) {
+	++flush;
+
+	if (!dirty)
+		return;
+
+	Uint8 *pixels = (Uint8 *)pageImage->pixels + dirtyRect.y * pageImage->pitch + dirtyRect.x * pageImage->format->BytesPerPixel;
+	SDL_UpdateTexture(pageTexture, &dirtyRect, pixels, pageImage->pitch);
+
+	//the software rasterizer draws from its own copy of the pixels, which needs replacing
+	if (app.headless) {
+		unregisterSoftRasterTexture(pageTexture);
+		registerSoftRasterTexture(pageTexture, pageImage);
+	}
+
+	dirty = false;
+}
+
+//frees the cache page and every font sheet
+void deleteGlyphCache(void) {
+	if (pageTexture != NULL) {
+		flushRenderQueue();	//in case the queue is still holding onto the page
+		unregisterSoftRasterTexture(pageTexture);
+		SDL_DestroyTexture(pageTexture);
+	}
+	if (pageImage != NULL)
+		SDL_FreeSurface(pageImage);
+	pageTexture = NULL;
+	pageImage = NULL;
+	pageFailed = false;
+	dirty = false;
+
+	for (int i = 0; i < fontSheetCount; ++i) {
+		if (fontSheets[i].image != NULL)
+			freeCachedImage(fontSheets[i].image);
+	}
+	fontSheetCount = 0;
+
+	slotCount = 0;
+	mostRecent = leastRecent = -1;
+	builtInGlyphsReady = false;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+/*
+* Where to find the glyph for any codepoint, for the text functions in fonts.h.
+* ASCII comes straight off the fonts and UI sheet, which is on the same texture page as the rest of the sprites (see initSharedSpriteAtlases),
+* so ordinary text batches with everything else. The rest of that sheet's cells are all the box glyph, so it's only used for the first 128 codepoints.
+* Glyphs for anything past that (accented letters included) are read from bitmap font sheets (FONT_SHEET_PATH, one per 256 codepoints, so Latin-1 comes from fontPage0000.png, laid out the same way as the fonts and UI sheet's grid)
+* the first time they're drawn, and copied onto a separate glyph cache page. Once the page fills up, the glyphs that were drawn least recently get replaced.
+* Codepoints with no sheet, and glyphs that don't fit because every glyph on the page is waiting to be drawn, come out as the box glyph from the fonts and UI sheet.
+* Since the page only ever holds a fixed number of glyphs, drawing text costs the same however many characters there are sheets for.
+*/
+
+//where a glyph is, and how big it is
+typedef struct {
+	SDL_Texture *texture;	//either the fonts and UI atlas's texture or the glyph cache page
+	float u0;				//normalized texture coordinates
+	float v0;
+	float u1;
+	float v1;
+	int w;					//size in pixels
+	int h;
+	int advance;			//how far to move right before drawing the next glyph
+} Glyph;
+
+const Glyph *getGlyph(Uint32 codepoint);
+void flushGlyphCache(void);
+void deleteGlyphCache(void);
+
+#endif
\ No newline at end of file
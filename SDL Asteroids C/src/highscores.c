@@ -11,7 +11,19 @@ extern Stage stage;
 static Highscore highscores[NUM_HIGHSCORES];	//holds highscores when they've been loaded from the highscores.json file
 static const int HIGHSCORE_TEXT_OFFSET_HORZ = 150;	//aesthetic positional vars
 static const int HIGHSCORE_TEXT_OFFSET_VERT = 60;
-static char highscoreTextBuffer[32];	//if the player gets a score with more than 31 digits I'll eat my socks.
+
+//text for the highscore table
+//these keep their quads between frames, and only get rebuilt when a row's name, score or highlight changes
+static TextObject *headerText = NULL;
+static TextObject *nameTexts[NUM_HIGHSCORES];
+static TextObject *scoreTexts[NUM_HIGHSCORES];
+static TextObject *latestScoreText = NULL;
+
+//the table gets drawn into this, and only redrawn when the highscores or the values below change
+static RenderCache tableCache;
+static bool cachedIncludeLatestScore = false;
+static int cachedLatestHighscoreIndex = -1;
+static int cachedScore = 0;
 
 void initHighscores(void) {
 	//initialize highscores array with negative scores
@@ -19,6 +31,20 @@ void initHighscores(void) {
 	for (int i = 0; i < NUM_HIGHSCORES; ++i) {
 		highscores[i].score = -1;
 	}
+	invalidateRenderCache(&tableCache);
+
+	//make the table's text the first time through (this gets called every time the main menu or a stage starts)
+	if (headerText == NULL) {
+		headerText = initTextObject(SCREEN_WIDTH * 0.5, 30, TAH_CENTER, 0, PALETTE_LIGHT_BLUE, PALETTE_BLACK, 1);
+		setTextObjectText(headerText, "Top 5:");
+
+		for (int i = 0; i < NUM_HIGHSCORES; ++i) {
+			nameTexts[i] = initTextObject(SCREEN_WIDTH * 0.5 - HIGHSCORE_TEXT_OFFSET_HORZ, HIGHSCORE_TEXT_OFFSET_VERT + 30 * i, TAH_LEFT, 0, PALETTE_LIGHT_BLUE, PALETTE_BLACK, 1);
+			scoreTexts[i] = initTextObject(SCREEN_WIDTH * 0.5 + HIGHSCORE_TEXT_OFFSET_HORZ, HIGHSCORE_TEXT_OFFSET_VERT + 30 * i, TAH_RIGHT, 0, PALETTE_LIGHT_BLUE, PALETTE_BLACK, 1);
+		}
+
+		latestScoreText = initTextObject(SCREEN_WIDTH * 0.5, 210, TAH_CENTER, 0, PALETTE_WHITE, PALETTE_BLACK, 1);
+	}
 }
 
 //loads highscores.json into local array "highscores"
@@ -28,6 +54,8 @@ bool loadHighscores(void) {
 	cJSON *root, *node;	//json parsing variables
 	char *text;			//text buffer for JSON
 
+	invalidateRenderCache(&tableCache);	//the table's about to change
+
 	//get JSON as text
 	text = readFile("./data/save/highscores.json");
 
@@ -78,6 +106,8 @@ int saveHighscores(void) {
 	TextInputWidget *textInputWidget = (TextInputWidget *)getWidget("inputName", "highscoreInput")->data;	//get access to the text the user just entered
 	int i;	//index of user's score in the highscores array
 
+	invalidateRenderCache(&tableCache);	//the table's about to change
+
 	//find where the user's score belongs in the array
 	for (i = 0; i < NUM_HIGHSCORES; ++i) {
 		if (stage.score > highscores[i].score)
@@ -129,34 +159,65 @@ int saveHighscores(void) {
 //draws the highscore table (does not include widgets to navigate away from it)
 //pass in true to include the player's latest score in the layout, regardless of if they got on the highscore table or not
 void drawHighscores(bool includeLatestScore) {
-	//draw header text
-	drawTextDropShadow("Top 5:", SCREEN_WIDTH * 0.5, 30, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+	//the table only needs to be redrawn if what it's showing has changed
+	if (includeLatestScore != cachedIncludeLatestScore || app.latestHighscoreIndex != cachedLatestHighscoreIndex || stage.score != cachedScore) {
+		cachedIncludeLatestScore = includeLatestScore;
+		cachedLatestHighscoreIndex = app.latestHighscoreIndex;
+		cachedScore = stage.score;
+		invalidateRenderCache(&tableCache);
+	}
 
-	//draw highscores
-	for (int i = 0; i < NUM_HIGHSCORES; ++i) {
-		//check if the score's real
-		if (highscores[i].score > -1) {
-			if (i == app.latestHighscoreIndex && includeLatestScore) {
-				//display latest highscore highlighted
-				drawTextDropShadow(highscores[i].name, SCREEN_WIDTH * 0.5 - HIGHSCORE_TEXT_OFFSET_HORZ, HIGHSCORE_TEXT_OFFSET_VERT + 30 * i, PALETTE_WHITE, TAH_LEFT, NULL, PALETTE_BLACK, 1);
-				sprintf(highscoreTextBuffer, "%d", highscores[i].score);
-				drawTextDropShadow(highscoreTextBuffer, SCREEN_WIDTH * 0.5 + HIGHSCORE_TEXT_OFFSET_HORZ, HIGHSCORE_TEXT_OFFSET_VERT + 30 * i, PALETTE_WHITE, TAH_RIGHT, NULL, PALETTE_BLACK, 1);
+	if (beginRenderCache(&tableCache)) {
+		//draw header text
+		drawTextObject(headerText);
+
+		//draw highscores
+		for (int i = 0; i < NUM_HIGHSCORES; ++i) {
+			//check if the score's real
+			if (highscores[i].score > -1) {
+				setTextObjectText(nameTexts[i], highscores[i].name);
+				setTextObjectInt(scoreTexts[i], "%d", highscores[i].score);
 			} else {
-				//display normally
-				drawTextDropShadow(highscores[i].name, SCREEN_WIDTH * 0.5 - HIGHSCORE_TEXT_OFFSET_HORZ, HIGHSCORE_TEXT_OFFSET_VERT + 30 * i, PALETTE_LIGHT_BLUE, TAH_LEFT, NULL, PALETTE_BLACK, 1);
-				sprintf(highscoreTextBuffer, "%d", highscores[i].score);
-				drawTextDropShadow(highscoreTextBuffer, SCREEN_WIDTH * 0.5 + HIGHSCORE_TEXT_OFFSET_HORZ, HIGHSCORE_TEXT_OFFSET_VERT + 30 * i, PALETTE_LIGHT_BLUE, TAH_RIGHT, NULL, PALETTE_BLACK, 1);
+				//display dashes
+				setTextObjectText(nameTexts[i], "-");
+				setTextObjectText(scoreTexts[i], "-");
 			}
-		} else {
-			//display dashes
-			drawTextDropShadow("-", SCREEN_WIDTH * 0.5 - HIGHSCORE_TEXT_OFFSET_HORZ, HIGHSCORE_TEXT_OFFSET_VERT + 30 * i, PALETTE_LIGHT_BLUE, TAH_LEFT, NULL, PALETTE_BLACK, 1);
-			drawTextDropShadow("-", SCREEN_WIDTH * 0.5 + HIGHSCORE_TEXT_OFFSET_HORZ, HIGHSCORE_TEXT_OFFSET_VERT + 30 * i, PALETTE_LIGHT_BLUE, TAH_RIGHT, NULL, PALETTE_BLACK, 1);
+
+			//display latest highscore highlighted
+			if (highscores[i].score > -1 && i == app.latestHighscoreIndex && includeLatestScore) {
+				setTextObjectColor(nameTexts[i], PALETTE_WHITE);
+				setTextObjectColor(scoreTexts[i], PALETTE_WHITE);
+			} else {
+				setTextObjectColor(nameTexts[i], PALETTE_LIGHT_BLUE);
+				setTextObjectColor(scoreTexts[i], PALETTE_LIGHT_BLUE);
+			}
+
+			drawTextObject(nameTexts[i]);
+			drawTextObject(scoreTexts[i]);
+		}
+
+		//draw player's score that round if it's desired by the function caller
+		if (includeLatestScore) {
+			setTextObjectInt(latestScoreText, "Your score: %d", stage.score);
+			drawTextObject(latestScoreText);
 		}
+
+		endRenderCache(&tableCache);
 	}
+	drawRenderCache(&tableCache);
+}
+
+//frees the highscore table's text
+void deleteHighscores(void) {
+	free(headerText);
+	free(latestScoreText);
+	headerText = latestScoreText = NULL;
 
-	//draw player's score that round if it's desired by the function caller
-	if (includeLatestScore) {
-		sprintf(highscoreTextBuffer, "Your score: %d", stage.score);
-		drawTextDropShadow(highscoreTextBuffer, SCREEN_WIDTH * 0.5, 210, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+	for (int i = 0; i < NUM_HIGHSCORES; ++i) {
+		free(nameTexts[i]);
+		free(scoreTexts[i]);
+		nameTexts[i] = scoreTexts[i] = NULL;
 	}
+
+	deleteRenderCache(&tableCache);
 }
\ No newline at end of file
@@ -15,5 +15,6 @@ void initHighscores(void);
 bool loadHighscores(void);
 int saveHighscores(void);
 void drawHighscores(bool includeLatestScore);
+void deleteHighscores(void);
 
 #endif
\ No newline at end of file
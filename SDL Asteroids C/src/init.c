@@ -3,9 +3,21 @@
 #include "SDL_image.h"
 #include "SDL_mixer.h"
 
+#include "animations.h"
+#include "capture.h"
+#include "composites.h"
 #include "cursor.h"
+#include "glyphCache.h"
+#include "highscores.h"
 #include "init.h"
 #include "input.h"
+#include "loading.h"
+#include "pixelMasks.h"
+#include "postProcess.h"
+#include "preRotations.h"
+#include "renderBatch.h"
+#include "renderQueue.h"
+#include "softRaster.h"
 #include "sound.h"
 
 extern App app;
@@ -19,6 +31,12 @@ void close(void);
 bool initSDL(void) {
 	bool success = true;
 
+	//when headless, SDL's dummy drivers stand in for the real video and audio devices
+	if (app.headless) {
+		SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+		SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+	}
+
 	//Initialize SDL
 	if (SDL_Init(SDL_INIT_EVERYTHING) < 0) {
 		printf("ERROR - Couldn't initialize SDL: %s\n", SDL_GetError());
@@ -32,7 +50,7 @@ bool initSDL(void) {
 
 	//Create program window wherever the OS wants it (args 1 and 2)
 	//NOTE: Window title declared here
-	app.window = SDL_CreateWindow("Crate Buster", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+	app.window = SDL_CreateWindow("Crate Buster", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, app.headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
 	if (app.window == NULL) {
 		printf("ERROR - Window could not be created: %s\n", SDL_GetError());
 		success = false;
@@ -40,14 +58,22 @@ bool initSDL(void) {
 
 	//Create renderer. Let SDL use whatever graphics acceleration device it wants (arg 2).
 	//Using vsync to cap framerate
-	app.renderer = SDL_CreateRenderer(app.window, -1, SDL_RENDERER_ACCELERATED /*| SDL_RENDERER_PRESENTVSYNC*/);
+	//When headless, SDL's software renderer draws into a surface instead, and the software rasterizer takes over drawing batches
+	if (app.headless) {
+		app.headlessSurface = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_RGBA32);
+		app.renderer = app.headlessSurface != NULL ? SDL_CreateSoftwareRenderer(app.headlessSurface) : NULL;
+
+		if (app.renderer != NULL && initSoftRaster(app.headlessSurface))
+			setRenderBackend(getSoftRasterBackend());
+	}
+	else
+		app.renderer = SDL_CreateRenderer(app.window, -1, SDL_RENDERER_ACCELERATED /*| SDL_RENDERER_PRESENTVSYNC*/);
 	if (app.renderer == NULL) {
 		printf("ERROR - Renderer could not be created: %s\n", SDL_GetError());
 		success = false;
 	}
 	else {
-		//make window scale with screen size changes
-		SDL_RenderSetLogicalSize(app.renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+		//the scene is drawn at SCREEN_WIDTH x SCREEN_HEIGHT and scaled up to the window all at once in presentScene
 		//make sure mouse coordinates correspond to relative screen size
 		if (!SDL_SetHint(SDL_HINT_MOUSE_RELATIVE_SCALING, "1")) {
 			printf("WARNING - relative mouse scaling could not be enabled.\n");
@@ -86,28 +112,12 @@ bool initGame(void) {
 	else
 		SDL_SetWindowFullscreen(app.window, 0);
 
-	//set window size ratios for proper mouse interaction
-	//code adapted from handleWindowResize from input.c
-	int w, h;
-	SDL_GetWindowSize(app.window, &w, &h);
-
-	if (w != 0 && h != 0) {
-		//find letterboxing
-		app.windowPaddingW = 0;
-		app.windowPaddingH = 0;
+	//find letterboxing and mouse scaling for the window's starting size
+	updateWindowScale();
 
-		//horizontal letterboxing
-		if (((float)w / (float)h) > ASPECT_RATIO)
-			app.windowPaddingW = w - ASPECT_RATIO * (double)h;
-
-		//vertical letterboxing
-		if (((float)h / (float)w) > ASPECT_RATIO_INV)
-			app.windowPaddingH = h - ASPECT_RATIO_INV * (double)w;
-
-		//set ratios only according to the non-letterbox parts of the screen	
-		app.windowPixelRatioW = (double)SCREEN_WIDTH / (double)(w - app.windowPaddingW);
-		app.windowPixelRatioH = (double)SCREEN_HEIGHT / (double)(h - app.windowPaddingH);
-	}
+	//start capturing frames if asked to
+	if (app.captureOutput != NULL && !initCapture(app.captureOutput))
+		success = false;
 
 	//initialize input variables
 	input.gamepad = NULL;
@@ -115,31 +125,10 @@ bool initGame(void) {
 	//initialize joypad
 	initGamepad();
 
-	//Load the sprite atlases to be used
-	app.fontsAndUI = initSpriteAtlas("gfx/AsteroidsCloneFontsAndUI.png");
-	app.gameplaySprites = initSpriteAtlas("gfx/AsteroidsCloneSpriteSheet.png");
-
-	//set up cursor
-	initCursor();
+	//sprite atlases, sounds, widgets and everything that depends on them are loaded by the loading screen (see loading.c)
 
-	//initialize menu widgets (has to go after atlas initializations, since initWidgets() initializes some sprites
-	initWidgets();
-	app.activeWidget = NULL;
-
-	if (app.fontsAndUI == NULL) {
-		printf("ERROR - Fonts and UI could not be loaded: %s\n", IMG_GetError());
-		success = false;
-	}
-	if (app.gameplaySprites == NULL) {
-		printf("ERROR - Gameplay sprites could not be loaded: %s\n", IMG_GetError());
-		success = false;
-	}
-
-	//initialize sound and music
-	initSounds();
-
-	//randomize
-	srand(time(NULL));
+	//randomize (except when headless, so runs can be compared frame for frame)
+	srand(app.headless ? 0 : time(NULL));
 
 	return success;
 }
@@ -148,9 +137,24 @@ bool initGame(void) {
 //Then clean up renderer and window
 //Then quit subsystems
 void close(void) {
+	//stop loading first, in case the game was closed before it finished
+	deleteLoading();
+
+	//let every captured frame finish saving
+	deleteCapture();
+
 	//Free resources here (pointers are NULLed within the functions)
+	deleteGlyphCache();
 	deleteSpriteAtlas(app.fontsAndUI);
 	deleteSpriteAtlas(app.gameplaySprites);
+	deleteComposites();
+	deletePixelMasks();
+	deletePreRotations();
+	deleteRenderQueue();
+	deletePostProcess();
+	deleteSceneTarget();
+	deleteRenderBatch();
+	deleteSoftRaster();
 	deleteSounds();
 
 	//close widget system
@@ -159,6 +163,12 @@ void close(void) {
 	//delete cursor sprites
 	deleteCursor();
 
+	//delete highscore table text
+	deleteHighscores();
+
+	//free animated sprites (after everything that might still give one back)
+	deleteAnimations();
+
 	//close joypad
 	SDL_GameControllerClose(input.gamepad);
 	input.gamepad = NULL;
@@ -167,6 +177,10 @@ void close(void) {
 	SDL_DestroyRenderer(app.renderer);
 	app.renderer = NULL;
 
+	if (app.headlessSurface != NULL)
+		SDL_FreeSurface(app.headlessSurface);
+	app.headlessSurface = NULL;
+
 	//Clean up window
 	SDL_DestroyWindow(app.window);
 	app.window = NULL;
@@ -1,12 +1,15 @@
 #include "common.h"
 
+#include "composites.h"
+#include "debugDraw.h"
 #include "input.h"
+#include "utility.h"
 
 extern App app;
 extern InputManager input;
 
 void resetInput(void);
-static void handleWindowResize(const SDL_WindowEvent* event);
+static void handleWindowResize(void);
 static void doKeyUp(const SDL_KeyboardEvent* event);
 static void doKeyDown(const SDL_KeyboardEvent* event);
 void initGamepad(void);
@@ -41,25 +44,9 @@ void resetInput(void) {
 }
 
 //window was resized; update certain constants
-static void handleWindowResize(const SDL_WindowEvent* event) {
-	//data1 and data2 seem to be the window's width and height
-	if (event->data1 != 0 && event->data2 != 0) {
-		//find letterboxing
-		app.windowPaddingW = 0;
-		app.windowPaddingH = 0;
-
-		//horizontal letterboxing
-		if (((float)event->data1 / (float)event->data2) > ASPECT_RATIO)
-			app.windowPaddingW = event->data1 - ASPECT_RATIO * (double)event->data2;
-		
-		//vertical letterboxing
-		if (((float)event->data2 / (float)event->data1) > ASPECT_RATIO_INV)
-			app.windowPaddingH = event->data2 - ASPECT_RATIO_INV * (double)event->data1;
-
-		//set ratios only according to the non-letterbox parts of the screen	
-		app.windowPixelRatioW = (double)SCREEN_WIDTH / (double)(event->data1 - app.windowPaddingW);
-		app.windowPixelRatioH = (double)SCREEN_HEIGHT / (double)(event->data2 - app.windowPaddingH);
-	}
+static void handleWindowResize(void) {
+	//find letterboxing and mouse scaling for the new size
+	updateWindowScale();
 	
 	//input can get "stuck" when resizing window if an input was held down during resize, so reset input
 	resetInput();
@@ -338,7 +325,17 @@ static void doGameplayInput(void) {
 	if ((input.keyboard[SDL_SCANCODE_ESCAPE] & IS_PRESSED) || (input.gamepadButtons[SDL_CONTROLLER_BUTTON_START] & IS_PRESSED))
 		input.pausePressed = INPUT_BUFFER_MAX;
 
+	//F3 to toggle debug view (hitboxes, profiler)
+	if (input.keyboard[SDL_SCANCODE_F3] & IS_PRESSED)
+		app.debug = !app.debug;
 
+	//F4 and up to toggle each kind of thing the debug view shows
+	if (app.debug) {
+		for (int i = 0; i < DDC_MAX; ++i) {
+			if (input.keyboard[DEBUG_DRAW_FIRST_KEY + i] & IS_PRESSED)
+				toggleDebugDrawCategory(i);
+		}
+	}
 
 	//store values of gamepad axes on this frame to allow joystick presses to activate directional pressed variables
 	prevAxisValues[SDL_CONTROLLER_AXIS_LEFTX] = input.gamepadAxes[SDL_CONTROLLER_AXIS_LEFTX];
@@ -383,7 +380,15 @@ void handleInput(void) {
 
 		case SDL_WINDOWEVENT:
 			if (event.window.event == SDL_WINDOWEVENT_RESIZED || event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
-				handleWindowResize(&event.window);
+				handleWindowResize();
+			break;
+
+		//the renderer lost what was drawn into target textures, so cached parts of the scene and baked sprites need to be redrawn
+		case SDL_RENDER_TARGETS_RESET:
+		case SDL_RENDER_DEVICE_RESET:
+			bakeComposites();
+			invalidateAllRenderCaches();
+			invalidatePreRotations();
 			break;
 
 		case SDL_KEYUP:
@@ -396,7 +401,12 @@ void handleInput(void) {
 
 		case SDL_TEXTINPUT:
 			//copy any text input into input.inputText
-			STRNCPY(input.inputText, event.text.text, MAX_INPUT_LENGTH);
+			//if it doesn't all fit, it's cut off between characters rather than partway through one (text is UTF-8)
+			{
+				int length = findUTF8Boundary(event.text.text, MIN(strlen(event.text.text), MAX_INPUT_LENGTH - 1));
+				memcpy(input.inputText, event.text.text, length);
+				input.inputText[length] = '\0';
+			}
 			break;
 
 		case SDL_JOYDEVICEADDED:
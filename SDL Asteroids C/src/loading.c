@@ -0,0 +1,309 @@
+#include "common.h"
+
+#include "./json/cJSON.h"
+#include "background.h"
+#include "composites.h"
+#include "cursor.h"
+#include "draw.h"
+#include "input.h"
+#include "loading.h"
+#include "mainMenu.h"
+#include "pixelMasks.h"
+#include "sound.h"
+#include "textureCache.h"
+#include "widgets.h"
+
+extern App app;
+
+//max number of threads that assets get loaded on
+#define MAX_LOADING_THREADS 4
+
+//max number of things that can be loaded at once
+#define MAX_LOADING_JOBS 32
+
+//the kinds of things that get loaded
+typedef enum {
+	LJT_IMAGE,		//decoded on a worker, put on the sprite page on the main thread once every image is in
+	LJT_SOUND,		//decoded straight into the sound array on a worker
+	LJT_WIDGETS		//parsed on a worker, handed to the widget system on the main thread
+} LoadingJobType;
+
+//images that go on the sprite page
+typedef enum {
+	LI_GAMEPLAY,
+	LI_FONTS_AND_UI,
+
+	LI_MAX
+} LoadingImage;
+
+typedef struct {
+	LoadingJobType type;
+	char *filename;			//for images and widget files
+	Sound sound;			//for sounds
+	LoadingImage image;		//for images
+	void *result;			//what the worker made, for the main thread to finish off (an SDL_Surface from loadCachedImage, or a cJSON tree)
+	SDL_atomic_t done;		//set by the worker once the job is done
+	bool finished;			//set by the main thread once it's dealt with the result
+} LoadingJob;
+
+void initLoading(void);
+static void addJob(LoadingJobType type, char *filename, Sound sound, LoadingImage image);
+static int loadingWorker(void *data);
+static bool runNextJob(void);
+static void finishJob(LoadingJob *job);
+static void finishLoading(void);
+static void waitForWorkers(void);
+static void freeImages(void);
+static void logic(void);
+static void draw(void);
+void deleteLoading(void);
+
+//widget files to parse ahead of time (see loadWidgets)
+static char *WIDGET_FILES[] = {
+	"data/widgets/title.json",
+	"data/widgets/options.json",
+	"data/widgets/paused.json",
+	"data/widgets/quitCheck.json",
+	"data/widgets/gameOver.json",
+	"data/widgets/highscoreInput.json"
+};
+
+static const int PROGRESS_BAR_W = 160;
+static const int PROGRESS_BAR_H = 4;
+
+static LoadingJob jobs[MAX_LOADING_JOBS];
+static SDL_Surface *images[LI_MAX];	//decoded images from jobs that are done, waiting for the rest to be put on the sprite page
+static int jobCount = 0;
+static int finishedJobCount = 0;
+static SDL_atomic_t nextJob;	//index of the next job for a worker to take
+
+static SDL_Thread *threads[MAX_LOADING_THREADS];
+static int threadCount = 0;
+
+static Uint64 startTime;	//when loading started, for reporting how long it took
+
+//queues up everything that gets loaded and starts the workers on it
+//call after initGame
+void initLoading(void) {
+	//set function pointers
+	app.delegate.logic = logic;
+	app.delegate.draw = draw;
+
+	jobCount = finishedJobCount = 0;
+	SDL_AtomicSet(&nextJob, 0);
+	startTime = SDL_GetPerformanceCounter();
+
+	//sprite atlases
+	addJob(LJT_IMAGE, SPRITE_TABLE_ATLAS, 0, LI_GAMEPLAY);
+	addJob(LJT_IMAGE, "gfx/AsteroidsCloneFontsAndUI.png", 0, LI_FONTS_AND_UI);
+
+	//sounds
+	initSounds();
+	for (int i = 0; i < SFX_MAX; ++i)
+		addJob(LJT_SOUND, NULL, i, 0);
+
+	//widget files
+	for (size_t i = 0; i < sizeof(WIDGET_FILES) / sizeof(WIDGET_FILES[0]); ++i)
+		addJob(LJT_WIDGETS, WIDGET_FILES[i], 0, 0);
+
+	//leave a core for the main thread
+	threadCount = 0;
+	int threadsWanted = MAX(MIN(SDL_GetCPUCount() - 1, MAX_LOADING_THREADS), 1);
+
+	for (int i = 0; i < threadsWanted; ++i) {
+		threads[threadCount] = SDL_CreateThread(loadingWorker, "loading", NULL);
+
+		if (threads[threadCount] == NULL)
+			printf("WARNING - Loading thread could not be created: %s\n", SDL_GetError());
+		else
+			++threadCount;
+	}
+}
+
+static void addJob(LoadingJobType type, char *filename, Sound sound, LoadingImage image) {
+	if (jobCount >= MAX_LOADING_JOBS) {
+		printf("ERROR - Out of room for loading jobs. Raise MAX_LOADING_JOBS.\n");
+		return;
+	}
+
+	LoadingJob *job = &jobs[jobCount++];
+	memset(job, 0, sizeof(LoadingJob));
+	job->type = type;
+	job->filename = filename;
+	job->sound = sound;
+	job->image = image;
+}
+
+//takes jobs until there aren't any left
+static int loadingWorker(void *data) {
+	(void)data;
+
+	while (runNextJob());
+
+	return 0;
+}
+
+//does the part of the next job that doesn't need the main thread
+//returns false if there were no jobs left
+static bool runNextJob(void) {
+	int i = SDL_AtomicAdd(&nextJob, 1);
+	if (i >= jobCount)
+		return false;
+
+	LoadingJob *job = &jobs[i];
+
+	switch (job->type) {
+	case(LJT_IMAGE):
+		job->result = loadCachedImage(job->filename);
+		break;
+	case(LJT_SOUND):
+		loadSound(job->sound);
+		break;
+	case(LJT_WIDGETS):
+		job->result = parseWidgetFile(job->filename);
+		break;
+	}
+
+	//make sure the result is visible to the main thread before the job is marked done
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&job->done, 1);
+
+	return true;
+}
+
+//does the part of a done job that has to be on the main thread
+static void finishJob(LoadingJob *job) {
+	switch (job->type) {
+	case(LJT_IMAGE):
+		images[job->image] = job->result;
+		break;
+	case(LJT_SOUND):
+		break;
+	case(LJT_WIDGETS):
+		addParsedWidgetFile(job->filename, job->result);	//the widget system owns it now
+		break;
+	}
+
+	job->result = NULL;
+	job->finished = true;
+	++finishedJobCount;
+}
+
+//initializes everything that needed the loaded assets, then goes to the main menu
+static void finishLoading(void) {
+	waitForWorkers();
+
+	//both atlases go on one texture, so that the UI, text and gameplay sprites can all be drawn in the same batches
+	bool atlasesLoaded = false;
+	if (images[LI_GAMEPLAY] == NULL)
+		printf("ERROR - Gameplay sprites could not be loaded.\n");
+	else if (images[LI_FONTS_AND_UI] == NULL)
+		printf("ERROR - Fonts and UI could not be loaded.\n");
+	else
+		atlasesLoaded = initSharedSpriteAtlases(images[LI_GAMEPLAY], images[LI_FONTS_AND_UI], &app.gameplaySprites, &app.fontsAndUI);
+
+	//bake rotations of everything that's drawn rotated every frame, now rather than the first time each one shows up
+	if (atlasesLoaded)
+		initPreRotatedSprites();
+
+	//collision masks come from the gameplay sprites, and are all built now so nothing has to be built mid-game
+	//not fatal if this fails; colliders just fall back to their boxes
+	if (images[LI_GAMEPLAY] != NULL && initPixelMasksFromImage(images[LI_GAMEPLAY]))
+		buildSpritePixelMasks();
+	freeImages();
+
+	//bake sprites that are made up of other gameplay sprites (hitflash, powerups)
+	if (!atlasesLoaded || !initComposites()) {
+		printf("ERROR: Game failed to initialize.\n");
+		app.quit = true;
+		return;
+	}
+
+	double milliseconds = (double)(SDL_GetPerformanceCounter() - startTime) * 1000 / SDL_GetPerformanceFrequency();
+	printf("Loaded in %.1f ms (texture cache %s).\n", milliseconds, app.noTextureCache ? "off" : "on");
+
+	//set volume of sounds according to user preferences
+	setSoundVolume(app.preferences.soundVolume);
+
+	//set up cursor
+	initCursor();
+
+	//initialize menu widgets (has to go after atlas initializations, since initWidgets() initializes some sprites
+	initWidgets();
+	app.activeWidget = NULL;
+
+	//prevent something instantly happening because the user pressed something while the game was loading
+	resetInput();
+
+	//since main menu and gameplay use the same background, init it here
+	initBackground();
+
+	//start game on main menu
+	initMainMenu();
+}
+
+//blocks until all the workers have stopped
+static void waitForWorkers(void) {
+	for (int i = 0; i < threadCount; ++i)
+		SDL_WaitThread(threads[i], NULL);
+	threadCount = 0;
+}
+
+//frees decoded images once they're on the sprite page (or if the game closes before they get there)
+static void freeImages(void) {
+	for (int i = 0; i < LI_MAX; ++i) {
+		if (images[i] != NULL)
+			freeCachedImage(images[i]);
+		images[i] = NULL;
+	}
+}
+
+static void logic(void) {
+	if (threadCount == 0) {
+		//no workers, so jobs get done here instead; one a frame keeps the window responsive (headless runs don't need to be)
+		while (runNextJob() && app.headless);
+	} else if (app.headless) {
+		//headless runs wait for everything, so they come out the same every time
+		waitForWorkers();
+	}
+
+	for (int i = 0; i < jobCount; ++i) {
+		if (!jobs[i].finished && SDL_AtomicGet(&jobs[i].done)) {
+			SDL_MemoryBarrierAcquire();
+			finishJob(&jobs[i]);
+		}
+	}
+
+	if (finishedJobCount == jobCount)
+		finishLoading();
+}
+
+//there's nothing to draw text with until the fonts are in, so the progress bar is just rectangles
+static void draw(void) {
+	setRenderLayer(RL_UI);
+
+	SDL_Rect bar = { (SCREEN_WIDTH - PROGRESS_BAR_W) / 2, (SCREEN_HEIGHT - PROGRESS_BAR_H) / 2, PROGRESS_BAR_W, PROGRESS_BAR_H };
+	drawFilledRect(&bar, PALETTE_BLUE);
+
+	bar.w = jobCount > 0 ? PROGRESS_BAR_W * finishedJobCount / jobCount : PROGRESS_BAR_W;
+	drawFilledRect(&bar, PALETTE_WHITE);
+}
+
+//in case the game is closed while it's still loading
+void deleteLoading(void) {
+	waitForWorkers();
+
+	for (int i = 0; i < jobCount; ++i) {
+		if (jobs[i].finished || jobs[i].result == NULL)
+			continue;
+
+		if (jobs[i].type == LJT_IMAGE)
+			freeCachedImage(jobs[i].result);
+		else if (jobs[i].type == LJT_WIDGETS)
+			cJSON_Delete(jobs[i].result);
+		jobs[i].result = NULL;
+	}
+
+	freeImages();
+	jobCount = finishedJobCount = 0;
+}
\ No newline at end of file
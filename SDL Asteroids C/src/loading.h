@@ -0,0 +1,15 @@
+#ifndef LOADING_H
+#define LOADING_H
+
+/*
+* The loading screen the game starts on.
+* Decoding images and sounds and parsing widget files all happen on worker threads,
+* while the main thread keeps handling window events, hands results off as they come in, and draws a progress bar.
+* Once everything's in, the sprite images are uploaded together as one texture page (see initSharedSpriteAtlases),
+* the things that depend on them are initialized, and the game moves on to the main menu.
+*/
+
+void initLoading(void);
+void deleteLoading(void);
+
+#endif
\ No newline at end of file
@@ -1,16 +1,23 @@
 /*
 * The project main.
+* Run with --headless <frames> [output.bmp] to run without a visible window or sound for that many frames, as fast as possible,
+* drawing on the CPU (see softRaster.h). The last frame gets saved to output.bmp if it's given.
+* Run with --no-texture-cache to decode every image from its PNG (see textureCache.h), e.g. to compare how long loading takes (see the "Loaded in" message in loading.c).
+* Run with --capture <video.y4m | frames%05d.png> to save every frame (see capture.h); along with --headless, this goes as fast as frames can be drawn and saved.
 */
 
 #include "common.h"
 
+#include "animations.h"
 #include "background.h"
 #include "cursor.h"
+#include "debugDraw.h"
 #include "draw.h"
 #include "init.h"
 #include "input.h"
-#include "mainMenu.h"
+#include "loading.h"
 #include "player.h"
+#include "profiler.h"
 #include "stage.h"
 #include "widgets.h"
 
@@ -27,6 +34,21 @@ int main(int argc, char* argv[]) {
 	app.debug = false;
 	memset(&input, 0, sizeof(InputManager));
 
+	//check command line options
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--headless") == 0 && i + 1 < argc) {
+			app.headless = true;
+			app.headlessFrames = atoi(argv[++i]);
+			//the output file is optional
+			if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0)
+				app.headlessOutput = argv[++i];
+		} else if (strcmp(argv[i], "--no-texture-cache") == 0) {
+			app.noTextureCache = true;
+		} else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+			app.captureOutput = argv[++i];
+		}
+	}
+
 	//initialize SDL
 	if (!initSDL()) {
 		printf("ERROR: SDL failed to initialize.\n");
@@ -41,33 +63,56 @@ int main(int argc, char* argv[]) {
 		return 1;	//return with error code
 	}
 
-	//prevent something instantly happening because the user pressed something while the game was first loading
-	resetInput();
-
-	//since main menu and gameplay use the same background, init it here
-	initBackground();
+	//start game on the loading screen, which goes to the main menu once everything's loaded
+	initLoading();
 
-	//start game on main menu
-	initMainMenu();
+	int frame = 0;
+	Uint64 startTime = SDL_GetPerformanceCounter();
 
 	while (!app.quit) {
 		handleInput();
 
+		//animations and the background run the same no matter what state the game is in
+		updateAnimations();
+		updateBackground();
+
 		app.delegate.logic();
 
+		updateProfiler();
+		updateDebugDraw();
+
 		prepareScene();
 
 		app.delegate.draw();
 
+		drawProfiler();	//debug overlay; only shows up if app.debug is on
+
+		drawDebug();	//sends off everything debug drawing has added this frame
+
 		drawCursor();	//cursor will always be drawn over everything else in the scene
 
 		presentScene();
 
+		//headless runs go as fast as they can, and stop after the number of frames asked for
+		if (app.headless) {
+			if (++frame >= app.headlessFrames)
+				app.quit = true;
+			continue;
+		}
+
 		//hack to get a somewhat consistent ~60 fps without delta time
 		//calculations assumed to take around 1.6 ms per frame
 		SDL_Delay(15);
 	}
 
+	if (app.headless) {
+		double seconds = (double)(SDL_GetPerformanceCounter() - startTime) / SDL_GetPerformanceFrequency();
+		printf("Ran %d frames headless, %.3f ms per frame on average.\n", frame, frame > 0 ? seconds * 1000 / frame : 0);
+
+		if (app.headlessOutput != NULL && SDL_SaveBMP(app.headlessSurface, app.headlessOutput) != 0)
+			printf("ERROR - Last frame could not be saved: %s\n", SDL_GetError());
+	}
+
 	//clean up
 	deleteBackground();
 
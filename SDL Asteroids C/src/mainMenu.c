@@ -205,6 +205,14 @@ static void initMainMenuWidgets(void) {
 	selectWidget->y = widget->y;
 	selectWidget->value = (int)app.preferences.fullscreen;	//check the app struct for the current fullscreen state
 
+	widget = getWidget("scaling", "options");
+	widget->action = waScalingSelect;
+	widget->x = SCREEN_WIDTH * 0.5;
+	selectWidget = (SelectWidget *)widget->data;
+	selectWidget->x = SCREEN_WIDTH * 0.5;
+	selectWidget->y = widget->y;
+	selectWidget->value = (int)app.preferences.integerScaling;
+
 	widget = getWidget("sfxSlider", "options");
 	widget->action = waSFXSlider;
 	widget->x = SCREEN_WIDTH * 0.5;
@@ -221,6 +229,22 @@ static void initMainMenuWidgets(void) {
 	sliderWidget->y = widget->y;
 	sliderWidget->value = app.preferences.musicVolume;
 
+	widget = getWidget("quality", "options");
+	widget->action = waQualitySelect;
+	widget->x = SCREEN_WIDTH * 0.5;
+	selectWidget = (SelectWidget *)widget->data;
+	selectWidget->x = SCREEN_WIDTH * 0.5;
+	selectWidget->y = widget->y;
+	selectWidget->value = (int)app.preferences.quality;
+
+	widget = getWidget("postProcess", "options");
+	widget->action = waPostProcessSelect;
+	widget->x = SCREEN_WIDTH * 0.5;
+	selectWidget = (SelectWidget *)widget->data;
+	selectWidget->x = SCREEN_WIDTH * 0.5;
+	selectWidget->y = widget->y;
+	selectWidget->value = (int)app.preferences.postProcess;
+
 	widget = getWidget("back", "options");
 	widget->action = waBack;
 	widget->x = SCREEN_WIDTH * 0.5;
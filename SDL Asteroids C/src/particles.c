@@ -1,5 +1,6 @@
 #include "common.h"
 
+#include "animations.h"
 #include "particles.h"
 #include "stage.h"
 
@@ -10,6 +11,7 @@ void updateParticles(void);
 void drawParticles(void);
 static void deleteParticle(Particle *particle);
 void deleteParticles(void);
+void explosionUpdate(Particle *particle);
 void explosionDraw(Particle *particle);
 
 //create a particle and add it to the stage's particle list
@@ -80,6 +82,8 @@ void updateParticles(void) {
 
 //draw particles according to their draw functions
 void drawParticles(void) {
+	setRenderLayer(RL_PARTICLES);
+
 	Particle *particle = stage.particleHead;
 
 	while (particle != NULL) {
@@ -93,7 +97,7 @@ void drawParticles(void) {
 //deletes a single particle
 //this is static void b/c a user should definitely not have access to this; it'd really mess up linked lists
 static void deleteParticle(Particle *particle) {
-	free(particle->sprite);
+	deleteSpriteAnimated(particle->sprite);
 	free(particle);
 	particle = NULL;
 }
@@ -116,10 +120,14 @@ void deleteParticles(void) {
 //specific particle draw functions shared between classes
 
 //explosion particle for crates, player, and enemies
+void explosionUpdate(Particle *particle) {
+	//delete particle when animation is over (using extra frame trick to tell when animation is done)
+	if (particle->sprite->currentFrame >= particle->sprite->frames - 1)
+		particle->ttl = 0;
+}
+
 void explosionDraw(Particle *particle) {
-	//draw if the animation isn't over yet (using extra frame trick to tell when animation is done)
+	//draw if the animation isn't over yet
 	if (particle->sprite->currentFrame < particle->sprite->frames - 1)
-		blitAndUpdateSpriteAnimatedEX(particle->sprite, particle->x, particle->y, particle->angle, NULL, SDL_FLIP_NONE);
-	else
-		particle->ttl = 0; 	//delete particle when animation is over
+		blitSpriteAnimatedEX(particle->sprite, particle->x, particle->y, particle->angle, NULL, SDL_FLIP_NONE);
 }
\ No newline at end of file
@@ -33,6 +33,7 @@ Particle *initParticle(SpriteAnimated *sprite, float x, float y, float deltaX, f
 void updateParticles(void);
 void drawParticles(void);
 void deleteParticles(void);
+void explosionUpdate(Particle *particle);
 void explosionDraw(Particle *particle);
 
 #endif
\ No newline at end of file
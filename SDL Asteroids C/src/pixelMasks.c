@@ -0,0 +1,253 @@
+#include "common.h"
+
+#include "pixelMasks.h"
+#include "profiler.h"
+#include "textureCache.h"
+
+bool initPixelMasks(char *filename);
+bool initPixelMasksFromImage(SDL_Surface *image);
+void buildSpritePixelMasks(void);
+static const PixelMaskSet *buildPixelMaskSet(int srcX, int srcY, int w, int h);
+const PixelMaskSet *getSpritePixelMasks(SpriteId id);
+static void buildPixelMask(PixelMask *mask, int srcX, int srcY, int w, int h, float angle);
+const PixelMask *getRotatedPixelMask(const PixelMaskSet *set, const Vector2 *xAxis);
+static uint64_t getRowBits(const PixelMask *mask, int row, int x);
+bool checkPixelMasksOverlap(const PixelMask *a, int ax, int ay, const PixelMask *b, int bx, int by);
+bool checkPixelMaskOverlapsBox(const PixelMask *mask, int x, int y, const Vector2 axes[2], const float halfwidths[2], Vector2 origin);
+void deletePixelMasks(void);
+
+//max number of different sprite frames that can have masks
+#define MAX_PIXEL_MASK_SETS 16
+
+static const Uint8 ALPHA_THRESHOLD = 128;	//pixels at least this opaque count as solid
+
+//copy of the sprite sheet in system memory, so that masks can be built from it
+//(textures live on the GPU and can't be read back cheaply)
+static SDL_Surface *sheet = NULL;
+
+//every sprite in the sprite table that collides per-pixel
+//masks are built from each sprite's first frame
+static const SpriteId MASKED_SPRITES[] = {
+	SPR_CRATE_LARGE,
+	SPR_CRATE_MEDIUM,
+	SPR_CRATE_SMALL,
+	SPR_ENEMY,
+	SPR_BULLET_NORMAL,
+	SPR_BULLET_ERRATIC,
+	SPR_BULLET_BOUNCER,
+	SPR_BULLET_SHOTGUN,
+	SPR_BULLET_ENEMY
+};
+
+static PixelMaskSet maskSets[MAX_PIXEL_MASK_SETS];
+static int maskSetCount = 0;
+
+static const PixelMaskSet *spriteMaskSets[SPR_MAX];	//NULL for sprites without masks
+
+//loads the sprite sheet that masks are built from
+//call after IMG_Init
+bool initPixelMasks(char *filename) {
+	//the same image the atlas texture is made from, so it usually comes out of the texture cache
+	SDL_Surface *loaded = loadCachedImage(filename);
+
+	if (loaded == NULL) {
+		printf("ERROR - File '%s' could not be loaded for collision masks.\n", filename);
+		return false;
+	}
+
+	bool success = initPixelMasksFromImage(loaded);
+	freeCachedImage(loaded);
+
+	return success;
+}
+
+//same as initPixelMasks, but for an image that's already been decoded (see loading.c); the caller still owns the image
+bool initPixelMasksFromImage(SDL_Surface *image) {
+	//convert to a known format so alpha is always the 4th byte of a pixel
+	sheet = SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_RGBA32, 0);
+
+	if (sheet == NULL) {
+		printf("ERROR - Sprite sheet could not be converted for collision masks: %s\n", SDL_GetError());
+		return false;
+	}
+
+	return true;
+}
+
+//builds the masks for every sprite in MASKED_SPRITES, then lets go of the sprite sheet copy (nothing else needs it)
+//call once, after initPixelMasks or initPixelMasksFromImage
+void buildSpritePixelMasks(void) {
+	if (sheet == NULL)
+		return;
+
+	for (size_t i = 0; i < sizeof(MASKED_SPRITES) / sizeof(MASKED_SPRITES[0]); ++i) {
+		const SpriteDef *def = &SPRITE_TABLE[MASKED_SPRITES[i]];
+		spriteMaskSets[MASKED_SPRITES[i]] = buildPixelMaskSet(def->x, def->y, def->w, def->h);
+	}
+
+	SDL_FreeSurface(sheet);
+	sheet = NULL;
+}
+
+//builds every rotated copy of the mask for a sprite frame (srcX, srcY, w and h are in pixels on the sprite sheet)
+//returns NULL if there's no room for another set
+static const PixelMaskSet *buildPixelMaskSet(int srcX, int srcY, int w, int h) {
+	if (maskSetCount >= MAX_PIXEL_MASK_SETS) {
+		printf("WARNING - Out of room for collision masks. Raise MAX_PIXEL_MASK_SETS.\n");
+		return NULL;
+	}
+
+	//build a new set
+	PixelMaskSet *set = &maskSets[maskSetCount++];
+	set->srcX = srcX;
+	set->srcY = srcY;
+	set->w = w;
+	set->h = h;
+
+	if (SDL_MUSTLOCK(sheet))
+		SDL_LockSurface(sheet);
+
+	for (int i = 0; i < PIXEL_MASK_ANGLES; ++i)
+		buildPixelMask(&set->rotations[i], srcX, srcY, w, h, i * 2 * M_PI / PIXEL_MASK_ANGLES);
+
+	if (SDL_MUSTLOCK(sheet))
+		SDL_UnlockSurface(sheet);
+
+	return set;
+}
+
+//builds one rotated copy of a frame's mask
+//angle is in radians, and rotates the same way SDL_RenderCopyEx does
+static void buildPixelMask(PixelMask *mask, int srcX, int srcY, int w, int h, float angle) {
+	float c = cos(angle);
+	float s = sin(angle);
+
+	//size of the box the rotated frame fits in, rounded up to an even number so the center lands on a pixel boundary
+	mask->w = (int)ceil(fabs(c) * w + fabs(s) * h);
+	mask->h = (int)ceil(fabs(s) * w + fabs(c) * h);
+	mask->w += mask->w & 1;
+	mask->h += mask->h & 1;
+	mask->wordsPerRow = (mask->w + 63) / 64;
+	mask->bits = calloc(mask->wordsPerRow * mask->h, sizeof(uint64_t));
+
+	//for each pixel in the mask, rotate its center back into the frame and sample the alpha there
+	for (int y = 0; y < mask->h; ++y) {
+		for (int x = 0; x < mask->w; ++x) {
+			float px = x + 0.5 - mask->w * 0.5;
+			float py = y + 0.5 - mask->h * 0.5;
+			int sx = (int)floor(c * px + s * py + w * 0.5);
+			int sy = (int)floor(-s * px + c * py + h * 0.5);
+
+			if (sx < 0 || sx >= w || sy < 0 || sy >= h)
+				continue;
+
+			Uint8 *pixel = (Uint8 *)sheet->pixels + (srcY + sy) * sheet->pitch + (srcX + sx) * 4;
+			if (pixel[3] >= ALPHA_THRESHOLD)
+				mask->bits[y * mask->wordsPerRow + x / 64] |= (uint64_t)1 << (x % 64);
+		}
+	}
+}
+
+//gets the masks built for a sprite by buildSpritePixelMasks
+//returns NULL if the sprite doesn't have any (or they couldn't be built); colliders without masks just use their box
+const PixelMaskSet *getSpritePixelMasks(SpriteId id) {
+	return id < SPR_MAX ? spriteMaskSets[id] : NULL;
+}
+
+//picks the pre-rotated mask closest to the angle of a collider's x axis
+const PixelMask *getRotatedPixelMask(const PixelMaskSet *set, const Vector2 *xAxis) {
+	int index = (int)floor(atan2(xAxis->y, xAxis->x) / (2 * M_PI) * PIXEL_MASK_ANGLES + 0.5);
+	index = ((index % PIXEL_MASK_ANGLES) + PIXEL_MASK_ANGLES) % PIXEL_MASK_ANGLES;
+
+	return &set->rotations[index];
+}
+
+//gets the 64 pixels of a mask row starting at x
+//pixels off the edges of the mask are 0, so x can be negative or past the right edge
+static uint64_t getRowBits(const PixelMask *mask, int row, int x) {
+	if (x <= -64 || x >= mask->w)
+		return 0;
+	if (x < 0)
+		return getRowBits(mask, row, 0) << -x;
+
+	const uint64_t *words = mask->bits + row * mask->wordsPerRow;
+	int word = x / 64;
+	int shift = x % 64;
+	uint64_t bits = words[word] >> shift;
+
+	//grab the rest from the next word over
+	if (shift != 0 && word + 1 < mask->wordsPerRow)
+		bits |= words[word + 1] << (64 - shift);
+
+	return bits;
+}
+
+//checks if two masks centered at (ax, ay) and (bx, by) have any solid pixels in common
+//only the rows where both masks overlap get looked at, 64 pixels at a time
+bool checkPixelMasksOverlap(const PixelMask *a, int ax, int ay, const PixelMask *b, int bx, int by) {
+	int aLeft = ax - a->w / 2, aTop = ay - a->h / 2;
+	int bLeft = bx - b->w / 2, bTop = by - b->h / 2;
+
+	//overlapping area in world space
+	int left = MAX(aLeft, bLeft);
+	int right = MIN(aLeft + a->w, bLeft + b->w);
+	int top = MAX(aTop, bTop);
+	int bottom = MIN(aTop + a->h, bTop + b->h);
+
+	addToProfilerCounter(PC_PIXEL_MASK_TESTS, 1);
+
+	for (int y = top; y < bottom; ++y) {
+		for (int x = left; x < right; x += 64) {
+			if (getRowBits(a, y - aTop, x - aLeft) & getRowBits(b, y - bTop, x - bLeft))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+//checks if a mask centered at (x, y) has any solid pixels inside of an oriented box
+//used when only one of two colliders has a mask
+bool checkPixelMaskOverlapsBox(const PixelMask *mask, int x, int y, const Vector2 axes[2], const float halfwidths[2], Vector2 origin) {
+	int maskLeft = x - mask->w / 2, maskTop = y - mask->h / 2;
+
+	//only check pixels within the box's bounding box
+	float extentX = fabs(axes[0].x) * halfwidths[0] + fabs(axes[1].x) * halfwidths[1];
+	float extentY = fabs(axes[0].y) * halfwidths[0] + fabs(axes[1].y) * halfwidths[1];
+	int left = MAX(maskLeft, (int)floor(origin.x - extentX));
+	int right = MIN(maskLeft + mask->w, (int)ceil(origin.x + extentX));
+	int top = MAX(maskTop, (int)floor(origin.y - extentY));
+	int bottom = MIN(maskTop + mask->h, (int)ceil(origin.y + extentY));
+
+	addToProfilerCounter(PC_PIXEL_MASK_TESTS, 1);
+
+	for (int py = top; py < bottom; ++py) {
+		const uint64_t *row = mask->bits + (py - maskTop) * mask->wordsPerRow;
+
+		for (int px = left; px < right; ++px) {
+			int col = px - maskLeft;
+			if (!(row[col / 64] & ((uint64_t)1 << (col % 64))))
+				continue;
+
+			//solid pixel; check if its center is inside the box
+			Vector2 relative = { px + 0.5 - origin.x, py + 0.5 - origin.y };
+			if (fabs(dotProduct(&relative, &axes[0])) <= halfwidths[0] && fabs(dotProduct(&relative, &axes[1])) <= halfwidths[1])
+				return true;
+		}
+	}
+
+	return false;
+}
+
+//frees every mask (and the sprite sheet copy, if the masks were never built)
+void deletePixelMasks(void) {
+	for (int i = 0; i < maskSetCount; ++i) {
+		for (int j = 0; j < PIXEL_MASK_ANGLES; ++j)
+			free(maskSets[i].rotations[j].bits);
+	}
+	maskSetCount = 0;
+	memset(spriteMaskSets, 0, sizeof(spriteMaskSets));
+
+	SDL_FreeSurface(sheet);
+	sheet = NULL;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef PIXEL_MASKS_H
+#define PIXEL_MASKS_H
+
+#include "draw.h"
+#include "geometry.h"
+
+/*
+* 1-bit collision masks built from the alpha channel of the gameplay sprite sheet.
+* Colliders that have one of these only count as hitting something if their opaque pixels actually touch.
+* Masks are pre-rotated at PIXEL_MASK_ANGLES angles so that the per-pixel test is just ANDing rows of 64-bit words.
+* Masks for every sprite that has one are built once, while loading (see buildSpritePixelMasks), and looked up by sprite after that.
+* Masks are owned by this file; don't free them.
+*/
+
+#define PIXEL_MASK_ANGLES 32	//number of pre-rotated copies of each mask (32 = one every 11.25 degrees)
+
+//one rotated copy of a mask
+//the sprite's center is always at (w / 2, h / 2)
+typedef struct {
+	int w;				//width in pixels
+	int h;				//height in pixels
+	int wordsPerRow;	//number of 64-bit words each row takes up
+	uint64_t *bits;		//row-major; bit 0 of a row's first word is its leftmost pixel
+} PixelMask;
+
+//every rotated copy of the mask for one sprite frame
+typedef struct {
+	int srcX;	//the sprite frame this was built from, in pixels
+	int srcY;
+	int w;
+	int h;
+	PixelMask rotations[PIXEL_MASK_ANGLES];
+} PixelMaskSet;
+
+bool initPixelMasks(char *filename);
+bool initPixelMasksFromImage(SDL_Surface *image);
+void buildSpritePixelMasks(void);
+const PixelMaskSet *getSpritePixelMasks(SpriteId id);
+const PixelMask *getRotatedPixelMask(const PixelMaskSet *set, const Vector2 *xAxis);
+bool checkPixelMasksOverlap(const PixelMask *a, int ax, int ay, const PixelMask *b, int bx, int by);
+bool checkPixelMaskOverlapsBox(const PixelMask *mask, int x, int y, const Vector2 axes[2], const float halfwidths[2], Vector2 origin);
+void deletePixelMasks(void);
+
+#endif
\ No newline at end of file
@@ -2,10 +2,12 @@
 
 #include "player.h"
 
+#include "animations.h"
 #include "background.h"
 #include "bullets.h"
 #include "colliders.h"
 #include "crates.h"
+#include "debugDraw.h"
 #include "draw.h"
 #include "fonts.h"
 #include "geometry.h"
@@ -23,8 +25,8 @@ extern Background background;
 static void psNormal();
 static void psDashing();
 void updatePlayer();
-static void checkHitCrates(void);
-static void checkHitEnemies(void);
+static void playerHitCrate(const Contact *contact);
+static void playerHitEnemy(const Contact *contact);
 void drawPlayer();
 static void mfUpdate(Particle *particle);
 static void mfDraw(Particle *particle);
@@ -124,12 +126,6 @@ static void psNormal() {
 	//update collider
 	updateCollider(player->collider, player->x, player->y, player->angle * DEGREES_TO_RADIANS, -1, -1);
 
-	//check if the player's hitbox intersected with any crates; if so, decrement player and box hp
-	checkHitCrates();
-
-	//check if player touches an enemy
-	checkHitEnemies();
-
 	//decrement invincibility frames
 	--player->iFrames;
 
@@ -180,9 +176,10 @@ static void psNormal() {
 	//kill player when HP is 0
 	if (player->hp <= 0) {
 		//death explosion
-		initParticle(initSpriteAnimated(app.gameplaySprites, 0, 18, 4, 4, SC_CENTER, 5, 0, 0.3, AL_ONESHOT), player->x, player->y, 0, 0, (float)(rand() % 4) * 90, 1, NULL, explosionDraw);
+		initParticle(initSpriteAnimatedFromTable(SPR_EXPLOSION, 0), player->x, player->y, 0, 0, (float)(rand() % 4) * 90, 1, explosionUpdate, explosionDraw);
 		playSound(SFX_PLAYER_KILL, SC_PLAYER, false, player->x / SCREEN_WIDTH * 255.0);
 
+		player->collider->mask = 0;	//dead players don't collide with anything
 		player->state = PS_DESTROYED;
 	}
 }
@@ -222,12 +219,6 @@ static void psDashing() {
 	//update collider
 	updateCollider(player->collider, player->x, player->y, player->angle, -1, -1);
 
-	//check if the player's hitbox intersected with any crates; if so, decrement player and box hp
-	checkHitCrates();
-
-	//check if player touches an enemy
-	checkHitEnemies();
-
 	//decrement invincibility frames
 	--player->iFrames;
 
@@ -241,6 +232,7 @@ static void psDashing() {
 	//kill player when HP is 0
 	if (player->hp <= 0) {
 		deathTimer = DEATH_TIMER_MAX;
+		player->collider->mask = 0;	//dead players don't collide with anything
 		player->state = PS_DESTROYED;
 	}
 }
@@ -270,54 +262,44 @@ void updatePlayer() {
 	++timeSincePowerupCollected;
 }
 
-//check if the player's hit a crate; hurt player and destroy crate if so.
-static void checkHitCrates(void) {
-	Crate *crate = stage.crateHead;
-
-	while (crate != NULL) {
-		if (checkIntersection(player->collider, crate->collider)) {
-			//decrement player HP, but only for the first crate they touch
-			if (player->iFrames <= 0) {
-				player->iFrames = PLAYER_I_FRAMES_MAX;	//give i-frames
-				--player->hp;
+//collision handler for when the player's hit a crate; hurt player and destroy crate.
+static void playerHitCrate(const Contact *contact) {
+	Crate *crate = (Crate *)contact->b->owner;
 
-				//set background to do hurt flash
-				background.backgroundFlashRedTimer = 0;
+	//decrement player HP, but only for the first crate they touch
+	if (player->iFrames <= 0) {
+		player->iFrames = PLAYER_I_FRAMES_MAX;	//give i-frames
+		--player->hp;
 
-				playSound(SFX_PLAYER_HIT, SC_PLAYER, false, player->x / SCREEN_WIDTH * 255.0);
-			}
-			crate->hp = 0;	//destroy crate
-		}
+		//set background to do hurt flash
+		background.backgroundFlashRedTimer = 0;
 
-		crate = crate->next;
+		playSound(SFX_PLAYER_HIT, SC_PLAYER, false, player->x / SCREEN_WIDTH * 255.0);
 	}
+	crate->hp = 0;	//destroy crate
 }
 
-//check if the player's hit an enemy; hurt player and destroy enemy if so.
-static void checkHitEnemies(void) {
-	Enemy *enemy = stage.enemyHead;
-
-	while (enemy != NULL) {
-		if (checkIntersection(player->collider, enemy->collider)) {
-			//decrement player HP, but only for the first enemy they touch
-			if (player->iFrames <= 0) {
-				player->iFrames = PLAYER_I_FRAMES_MAX;	//give i-frames
-				--player->hp;
+//collision handler for when the player's hit an enemy; hurt player and destroy enemy.
+static void playerHitEnemy(const Contact *contact) {
+	Enemy *enemy = (Enemy *)contact->b->owner;
 
-				//set background to do hurt flash
-				background.backgroundFlashRedTimer = 0;
+	//decrement player HP, but only for the first enemy they touch
+	if (player->iFrames <= 0) {
+		player->iFrames = PLAYER_I_FRAMES_MAX;	//give i-frames
+		--player->hp;
 
-				playSound(SFX_PLAYER_HIT, SC_PLAYER, false, player->x / SCREEN_HEIGHT * 255);
-			}
-			enemy->hp = 0;	//destroy enemy
-		}
+		//set background to do hurt flash
+		background.backgroundFlashRedTimer = 0;
 
-		enemy = enemy->next;
+		playSound(SFX_PLAYER_HIT, SC_PLAYER, false, player->x / SCREEN_HEIGHT * 255);
 	}
+	enemy->hp = 0;	//destroy enemy
 }
 
 //draw player
 void drawPlayer() {
+	setRenderLayer(RL_PLAYER);
+
 	//only draw if player's not dead
 	if (player != NULL && player->state != PS_DESTROYED) {
 		if (player->iFrames <= 0 || player->iFrames % 10 > 5) {
@@ -327,7 +309,7 @@ void drawPlayer() {
 			//flame's just magic-numbered into place
 			//flame's rotation origin is the center of the ship
 			if (showShipFlame)
-				blitAndUpdateSpriteAnimatedEX(player->shipFlame, player->x - 30, player->y, player->angle, &(SDL_Point){(player->shipFlame->w) * 0.5 + 30, player->shipFlame->h * 0.5}, SDL_FLIP_NONE, 255);
+				blitSpriteAnimatedEX(player->shipFlame, player->x - 30, player->y, player->angle, &(SDL_Point){(player->shipFlame->w) * 0.5 + 30, player->shipFlame->h * 0.5}, SDL_FLIP_NONE, 255);
 		}
 		else {
 			//blinking when i-frames are active
@@ -335,7 +317,7 @@ void drawPlayer() {
 			setTextureRGBA(player->shipSprite->atlas->texture, 255, 255, 255, 127);		//since both of the player's sprite share the same atlas, i'm only calling this once
 			blitSpriteStaticEX(player->shipSprite, player->x, player->y, player->angle, NULL, SDL_FLIP_NONE, 255);
 			if (showShipFlame)
-				blitAndUpdateSpriteAnimatedEX(player->shipFlame, player->x - 30, player->y, player->angle, &(SDL_Point){(player->shipFlame->w) * 0.5 + 30, player->shipFlame->h * 0.5}, SDL_FLIP_NONE, 255);
+				blitSpriteAnimatedEX(player->shipFlame, player->x - 30, player->y, player->angle, &(SDL_Point){(player->shipFlame->w) * 0.5 + 30, player->shipFlame->h * 0.5}, SDL_FLIP_NONE, 255);
 			setTextureRGBA(player->shipSprite->atlas->texture, 255, 255, 255, 255);	
 		}
 
@@ -345,7 +327,12 @@ void drawPlayer() {
 		setTextureRGBA(app.gameplaySprites->texture, 255, 255, 255, 255);
 	
 		//only happens if app.debug = true
-		displayCollider(app.renderer, &COLOR_RED, player->collider);
+		displayCollider(&COLOR_RED, player->collider);
+		//dashes move along dirVector; otherwise the player drifts along momentumVector
+		if (player->state == PS_DASHING)
+			debugDrawVelocity(player->x, player->y, player->dirVector, player->speed);
+		else
+			debugDrawVelocity(player->x, player->y, player->momentumVector, PLAYER_SPEED_MAX);
 	}
 }
 
@@ -362,7 +349,7 @@ static void mfUpdate(Particle *particle) {
 static void mfDraw(Particle *particle) {
 	//don't call if particle not visible
 	if (particle->sprite->currentFrame != particle->sprite->frames - 1) {
-		blitAndUpdateSpriteAnimatedEX(particle->sprite, particle->x, particle->y, player->angle, NULL, SDL_FLIP_NONE);
+		blitSpriteAnimatedEX(particle->sprite, particle->x, particle->y, player->angle, NULL, SDL_FLIP_NONE);
 	}
 }
 
@@ -381,19 +368,21 @@ void initPlayer(int x, int y) {
 	player->hp = PLAYER_HP_MAX;	//3 hits before dying
 	player->iFrames = 0;
 	player->weaponType = BT_NORMAL;
-	player->shipSprite = initSpriteStatic(app.gameplaySprites, 0, 11, 3, 3, SC_CENTER);
-	player->shipFlame = initSpriteAnimated(app.gameplaySprites, 16, 16, 1, 1, SC_CENTER, 4, 0, 0.25, AL_LOOP);
-	player->collider = initOBBCollider(player->shipSprite->w * 0.2, player->shipSprite->h * 0.2, (Vector2){ player->x, player->y }, player->angle);
+	player->shipSprite = initSpriteStaticFromTable(SPR_PLAYER_SHIP, 0);
+	player->shipFlame = initSpriteAnimatedFromTable(SPR_FLAME, 0);
+	player->collider = initOBBCollider(player->shipSprite->w * 0.2, player->shipSprite->h * 0.2, (Vector2){ player->x, player->y }, player->angle, CL_PLAYER, player);
+	setCollisionHandler(CL_PLAYER, CL_CRATE, playerHitCrate);
+	setCollisionHandler(CL_PLAYER, CL_ENEMY, playerHitEnemy);
 
 	//initialize muzzle flash particles
 	//particles initialized with an extra frame of animation to allow user to check when they've ended
-	mfNormal = initParticle(initSpriteAnimated(app.gameplaySprites, 16, 2, 1, 1, SC_CENTER, 5, 5, 0.5, AL_ONESHOT), 0, 0, 0, 0, 0, 1, mfUpdate, mfDraw);
-	mfErratic = initParticle(initSpriteAnimated(app.gameplaySprites, 16, 5, 1, 1, SC_CENTER, 5, 5, 0.5, AL_ONESHOT), 0, 0, 0, 0, 0, 1, mfUpdate, mfDraw);
-	mfBouncer = initParticle(initSpriteAnimated(app.gameplaySprites, 16, 8, 1, 1, SC_CENTER, 5, 5, 0.5, AL_ONESHOT), 0, 0, 0, 0, 0, 1, mfUpdate, mfDraw);
-	mfShotgun = initParticle(initSpriteAnimated(app.gameplaySprites, 16, 11, 1, 1, SC_CENTER, 5, 5, 0.5, AL_ONESHOT), 0, 0, 0, 0, 0, 1, mfUpdate, mfDraw);
+	mfNormal = initParticle(initSpriteAnimatedFromTable(SPR_MUZZLE_FLASH_NORMAL, 5), 0, 0, 0, 0, 0, 1, mfUpdate, mfDraw);
+	mfErratic = initParticle(initSpriteAnimatedFromTable(SPR_MUZZLE_FLASH_ERRATIC, 5), 0, 0, 0, 0, 0, 1, mfUpdate, mfDraw);
+	mfBouncer = initParticle(initSpriteAnimatedFromTable(SPR_MUZZLE_FLASH_BOUNCER, 5), 0, 0, 0, 0, 0, 1, mfUpdate, mfDraw);
+	mfShotgun = initParticle(initSpriteAnimatedFromTable(SPR_MUZZLE_FLASH_SHOTGUN, 5), 0, 0, 0, 0, 0, 1, mfUpdate, mfDraw);
 
 	//initialize powerup flash
-	powerupFlash = initSpriteStatic(app.gameplaySprites, 3, 11, 3, 3, SC_CENTER);
+	powerupFlash = initSpriteStaticFromTable(SPR_POWERUP_FLASH, 0);
 }
 
 //resets certain player variables when the player respawns
@@ -411,6 +400,9 @@ void resetPlayer(int x, int y) {
 	player->iFrames = 0;	//give the player respawn invulnerability in case they spawn on top of some crates
 	player->weaponType = BT_NORMAL;
 
+	//let the player collide with things again
+	setColliderLayer(player->collider, CL_PLAYER);
+
 	player->state = PS_NORMAL;
 }
 
@@ -418,8 +410,8 @@ void resetPlayer(int x, int y) {
 void deletePlayer() {
 	//free player struct stuff
 	free(player->shipSprite);
-	free(player->shipFlame);
-	free(player->collider);
+	deleteSpriteAnimated(player->shipFlame);
+	deleteCollider(player->collider);
 	free(player);
 	player = NULL;
 
@@ -0,0 +1,662 @@
+#include "common.h"
+
+//SSE2 is always there on x64, and on x86 when it's enabled in the compiler settings
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define POST_PROCESS_USE_SSE2
+#endif
+
+#include "postProcess.h"
+#include "profiler.h"
+
+extern App app;
+
+//max number of threads working through tiles at once, the main thread included
+#define MAX_POST_PROCESS_THREADS 8
+//rows in one tile
+#define POST_PROCESS_TILE_ROWS 8
+
+//bloom is worked out at half resolution, with a border of black pixels all the way around so the blur never has to check for edges
+#define BLOOM_W (SCREEN_WIDTH / 2)
+#define BLOOM_H (SCREEN_HEIGHT / 2)
+#define BLOOM_STRIDE (BLOOM_W + 2)
+
+//one step of post-processing; works on rows top to bottom (not included) of whatever it's writing to
+typedef void (*PostProcessPass)(int top, int bottom);
+
+//a thread that takes tiles of whatever pass is running until there aren't any left
+typedef struct {
+	SDL_Thread *thread;
+	SDL_sem *start;		//posted when there's a pass to run
+} PostProcessWorker;
+
+bool isPostProcessActive(void);
+void setPostProcessFlash(float red, float white);
+SDL_Texture *applyPostProcess(void);
+static bool initPostProcess(void);
+static void startPostProcessWorkers(void);
+static void buildCurveTaps(void);
+static bool processSceneTarget(PostProcessLevel frameLevel);
+static bool processFramebuffer(PostProcessLevel frameLevel);
+static void runEffects(PostProcessLevel frameLevel, void *pixels, int pitch);
+static void setUpFlash(void);
+static void updateBudget(double ms);
+static void setLevel(PostProcessLevel newLevel);
+static void runPass(PostProcessPass pass, int rows);
+static void runTiles(void);
+static int postProcessWorker(void *data);
+static void bloomRows(int top, int bottom);
+static void verticalBlurRows(int top, int bottom);
+static void compositeRows(int top, int bottom);
+static void downsampleRow(Uint32 *dst, const Uint32 *row0, const Uint32 *row1);
+static void blurRun(Uint32 *dst, const Uint32 *prev, const Uint32 *center, const Uint32 *next, int count);
+static Uint32 compositePixel(int x, int y);
+#ifdef POST_PROCESS_USE_SSE2
+static int downsampleRowSSE2(Uint32 *dst, const Uint32 *row0, const Uint32 *row1);
+static int blurRunSSE2(Uint32 *dst, const Uint32 *prev, const Uint32 *center, const Uint32 *next, int count);
+static int compositeRowSSE2(Uint32 *dst, int y);
+static __m128i div255SSE2(__m128i x);
+#endif
+static Uint32 sampleTap(Uint32 tap, Uint32 *bloom);
+static int getRowShade(int y);
+static Uint32 averagePixels(Uint32 a, Uint32 b);
+static int div255(int x);
+void deletePostProcess(void);
+
+static const double POST_PROCESS_BUDGET_MS = 3;				//how long post-processing can take per frame, on average, before an effect is dropped
+static const double POST_PROCESS_RECOVER_FRACTION = 0.5;	//how far under budget the average has to be before a dropped effect is tried again
+static const double POST_PROCESS_AVERAGE_WEIGHT = 0.05;		//how much each frame counts toward the running average
+static const int POST_PROCESS_SETTLE_FRAMES = FPS;			//frames to wait after changing level before judging the new one
+static const int POST_PROCESS_RECOVER_FRAMES = FPS * 10;	//frames a level has to stay well under budget before trying the next one up
+static const int MAX_POST_PROCESS_RETRIES = 3;				//times a level can be dropped before it isn't tried again
+
+static const float CRT_CURVATURE = 0.04f;	//how far the corners of the screen get pushed out, as a fraction of the screen
+static const float VIGNETTE_WIDTH = 40;		//distance from the edge of the curved screen where it starts getting darker, in pixels
+static const float VIGNETTE_MIN = 0.4f;		//brightness right at the edge
+static const int SCANLINE_SHADE = 204;		//brightness of every other row, out of 255
+static const Uint8 BLOOM_THRESHOLD = 160;	//channels brighter than this bloom
+static const int BLOOM_BLUR_PASSES = 4;		//number of times the bloom is blurred each way (has to be even)
+static const float RED_FLASH_STRENGTH = 0.5f;	//how far the palette shifts toward red at the start of the hit flash
+static const float WHITE_FLASH_STRENGTH = 0.25f;	//same for white and the powerup flash
+
+static const char *LEVEL_NAMES[PPL_MAX] = {
+	"off",
+	"scanlines only",
+	"no bloom",
+	"every effect"
+};
+
+static bool initialized = false;
+static bool failed = false;		//set if something couldn't be made, in which case post-processing stays off
+static bool active = false;		//whether the last frame was post-processed
+
+static Uint32 *input = NULL;	//copy of the frame being post-processed (RGBA32)
+static Uint32 *bloomA = NULL;	//bloom buffers, BLOOM_STRIDE x (BLOOM_H + 2), blurred back and forth between each other
+static Uint32 *bloomB = NULL;
+static Uint32 *curveTaps = NULL;	//for each pixel, where on the frame it comes from and how dark it is (see buildCurveTaps)
+static SDL_Texture *output = NULL;	//streaming texture the frame goes to when there's a window
+
+//what the current pass is working on
+static PostProcessLevel effectLevel = PPL_FULL;
+static Uint8 *outputPixels = NULL;
+static int outputPitch = 0;
+static const Uint32 *blurSource = NULL;
+static Uint32 *blurDest = NULL;
+
+//the flashes, worked out as one color for the palette to shift toward and how far to shift it (0 to 128)
+static float flashRed = 0;
+static float flashWhite = 0;
+static Uint8 flashColor[3];
+static int flashAmount = 0;
+
+//time budget
+static PostProcessLevel level = PPL_FULL;
+static int dropCounts[PPL_MAX];
+static double averageMs = 0;
+static int framesAtLevel = 0;
+
+static PostProcessWorker workers[MAX_POST_PROCESS_THREADS - 1];
+static int workerCount = 0;		//0 if everything is done on the main thread
+static SDL_sem *passDone = NULL;	//posted by each worker when there are no tiles left
+static PostProcessPass currentPass = NULL;
+static int currentPassRows = 0;
+static SDL_atomic_t nextTile;
+static bool workersQuit = false;
+
+//true if the last frame was post-processed (so the flashes were done by the palette)
+bool isPostProcessActive(void) {
+	return active;
+}
+
+//sets how strong the hit (red) and powerup (white) flashes are, from 0 to 1
+//call every frame; only has an effect while post-processing is active
+void setPostProcessFlash(float red, float white) {
+	flashRed = red;
+	flashWhite = white;
+}
+
+//post-processes the frame that was just drawn
+//call once everything's been flushed, while the scene texture is still the render target
+//returns the texture to draw to the window in place of the scene texture, or NULL if there isn't one (post-processing is off, or the framebuffer was done in place)
+SDL_Texture *applyPostProcess(void) {
+	active = false;
+
+	if (!app.preferences.postProcess || failed)
+		return NULL;
+
+	if (!initialized && !initPostProcess())
+		return NULL;
+
+	//headless runs always get every effect, so they come out the same however fast the machine is
+	PostProcessLevel frameLevel = app.headless ? PPL_FULL : level;
+	if (frameLevel == PPL_OFF) {
+		updateBudget(0);
+		return NULL;
+	}
+
+	Uint64 start = SDL_GetPerformanceCounter();
+
+	if (!(app.headless ? processFramebuffer(frameLevel) : processSceneTarget(frameLevel)))
+		return NULL;
+
+	double ms = (double)(SDL_GetPerformanceCounter() - start) * 1000 / SDL_GetPerformanceFrequency();
+	addToProfilerCounter(PC_POST_PROCESS_MICROSECONDS, (int)(ms * 1000));
+	if (!app.headless)
+		updateBudget(ms);
+
+	active = true;
+	return app.headless ? NULL : output;
+}
+
+//makes the buffers and threads the first time post-processing is used
+static bool initPostProcess(void) {
+	initialized = true;
+
+	input = malloc(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(Uint32));
+	curveTaps = malloc(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(Uint32));
+	bloomA = calloc(BLOOM_STRIDE * (BLOOM_H + 2), sizeof(Uint32));
+	bloomB = calloc(BLOOM_STRIDE * (BLOOM_H + 2), sizeof(Uint32));
+	if (input == NULL || curveTaps == NULL || bloomA == NULL || bloomB == NULL) {
+		printf("ERROR - Post-processing buffers could not be allocated.\n");
+		failed = true;
+		return false;
+	}
+
+	if (!app.headless) {
+		output = SDL_CreateTexture(app.renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, SCREEN_WIDTH, SCREEN_HEIGHT);
+		if (output == NULL) {
+			printf("WARNING - Post-processing turned off, its texture could not be created: %s\n", SDL_GetError());
+			failed = true;
+			return false;
+		}
+		SDL_SetTextureBlendMode(output, SDL_BLENDMODE_NONE);
+	}
+
+	buildCurveTaps();
+	startPostProcessWorkers();
+
+	return true;
+}
+
+//the main thread works through tiles too, so there's one worker for every other core
+static void startPostProcessWorkers(void) {
+	workersQuit = false;
+
+	int threads = MIN(SDL_GetCPUCount(), MAX_POST_PROCESS_THREADS) - 1;
+	if (threads <= 0)
+		return;
+
+	passDone = SDL_CreateSemaphore(0);
+	if (passDone == NULL) {
+		printf("WARNING - Post-processing will only use one thread: %s\n", SDL_GetError());
+		return;
+	}
+
+	for (int i = 0; i < threads; ++i) {
+		PostProcessWorker *worker = &workers[workerCount];
+		worker->start = SDL_CreateSemaphore(0);
+		worker->thread = worker->start != NULL ? SDL_CreateThread(postProcessWorker, "postProcess", worker) : NULL;
+
+		if (worker->thread == NULL) {
+			printf("WARNING - Post-processing thread could not be created: %s\n", SDL_GetError());
+			if (worker->start != NULL)
+				SDL_DestroySemaphore(worker->start);
+			break;
+		}
+
+		++workerCount;
+	}
+}
+
+//works out, for every pixel, which pixel of the frame it shows on a curved screen, and how dark it is (scanlines and the darker edges of the tube)
+//each tap is packed into a Uint32: x in the bottom 10 bits, y in the next 9, and brightness out of 255 in the top 8
+static void buildCurveTaps(void) {
+	for (int y = 0; y < SCREEN_HEIGHT; ++y) {
+		for (int x = 0; x < SCREEN_WIDTH; ++x) {
+			//-1 to 1 across the screen
+			float u = (x + 0.5f) / SCREEN_WIDTH * 2 - 1;
+			float v = (y + 0.5f) / SCREEN_HEIGHT * 2 - 1;
+
+			//pushing each axis out more the further along the other axis it is bends straight lines the way a tube does
+			float curvedU = u * (1 + v * v * CRT_CURVATURE);
+			float curvedV = v * (1 + u * u * CRT_CURVATURE);
+			int srcX = (int)floor((curvedU + 1) * 0.5f * SCREEN_WIDTH);
+			int srcY = (int)floor((curvedV + 1) * 0.5f * SCREEN_HEIGHT);
+
+			//off the edge of the curved screen is black
+			if (srcX < 0 || srcX >= SCREEN_WIDTH || srcY < 0 || srcY >= SCREEN_HEIGHT) {
+				curveTaps[y * SCREEN_WIDTH + x] = 0;
+				continue;
+			}
+
+			//darker toward the edges, easing out
+			float edgeX = MIN(1, MIN(srcX, SCREEN_WIDTH - 1 - srcX) / VIGNETTE_WIDTH);
+			float edgeY = MIN(1, MIN(srcY, SCREEN_HEIGHT - 1 - srcY) / VIGNETTE_WIDTH);
+			float edge = edgeX * (2 - edgeX) * edgeY * (2 - edgeY);
+			float shade = getRowShade(y) * (VIGNETTE_MIN + (1 - VIGNETTE_MIN) * edge);
+
+			curveTaps[y * SCREEN_WIDTH + x] = (Uint32)srcX | (Uint32)srcY << 10 | (Uint32)(shade + 0.5f) << 24;
+		}
+	}
+}
+
+//reads the scene texture back and post-processes it into the streaming texture
+static bool processSceneTarget(PostProcessLevel frameLevel) {
+	if (SDL_RenderReadPixels(app.renderer, NULL, SDL_PIXELFORMAT_RGBA32, input, SCREEN_WIDTH * sizeof(Uint32)) != 0) {
+		printf("WARNING - Post-processing turned off, the scene could not be read back: %s\n", SDL_GetError());
+		failed = true;
+		return false;
+	}
+
+	void *pixels;
+	int pitch;
+	if (SDL_LockTexture(output, NULL, &pixels, &pitch) != 0) {
+		printf("WARNING - Post-processing turned off, its texture could not be locked: %s\n", SDL_GetError());
+		failed = true;
+		return false;
+	}
+
+	runEffects(frameLevel, pixels, pitch);
+	SDL_UnlockTexture(output);
+
+	return true;
+}
+
+//post-processes the headless framebuffer in place
+static bool processFramebuffer(PostProcessLevel frameLevel) {
+	SDL_Surface *framebuffer = app.headlessSurface;
+
+	//SDL might still be holding onto things it was asked to draw
+	SDL_RenderFlush(app.renderer);
+
+	if (SDL_MUSTLOCK(framebuffer))
+		SDL_LockSurface(framebuffer);
+
+	for (int y = 0; y < SCREEN_HEIGHT; ++y)
+		memcpy(input + y * SCREEN_WIDTH, (Uint8 *)framebuffer->pixels + y * framebuffer->pitch, SCREEN_WIDTH * sizeof(Uint32));
+
+	runEffects(frameLevel, framebuffer->pixels, framebuffer->pitch);
+
+	if (SDL_MUSTLOCK(framebuffer))
+		SDL_UnlockSurface(framebuffer);
+
+	return true;
+}
+
+//runs every pass the level calls for, from input to pixels (which has to be SCREEN_WIDTH x SCREEN_HEIGHT, RGBA32)
+static void runEffects(PostProcessLevel frameLevel, void *pixels, int pitch) {
+	effectLevel = frameLevel;
+	outputPixels = pixels;
+	outputPitch = pitch;
+	setUpFlash();
+
+	if (effectLevel >= PPL_FULL) {
+		runPass(bloomRows, BLOOM_H);
+
+		for (int i = 0; i < BLOOM_BLUR_PASSES; i += 2) {
+			blurSource = bloomA;
+			blurDest = bloomB;
+			runPass(verticalBlurRows, BLOOM_H);
+			blurSource = bloomB;
+			blurDest = bloomA;
+			runPass(verticalBlurRows, BLOOM_H);
+		}
+	}
+
+	runPass(compositeRows, SCREEN_HEIGHT);
+}
+
+//the red flash goes on first, then the white one over it, same as when they're drawn as rectangles
+//shifting toward red by a, then toward white by b, is the same as shifting toward a mix of the two by 1 - (1 - a)(1 - b)
+static void setUpFlash(void) {
+	float red = MAX(0, MIN(flashRed, 1)) * RED_FLASH_STRENGTH;
+	float white = MAX(0, MIN(flashWhite, 1)) * WHITE_FLASH_STRENGTH;
+	float amount = 1 - (1 - red) * (1 - white);
+
+	flashAmount = (int)(amount * 128 + 0.5f);
+	if (flashAmount == 0)
+		return;
+
+	flashColor[0] = (Uint8)((PALETTE_RED.r * red * (1 - white) + PALETTE_WHITE.r * white) / amount + 0.5f);
+	flashColor[1] = (Uint8)((PALETTE_RED.g * red * (1 - white) + PALETTE_WHITE.g * white) / amount + 0.5f);
+	flashColor[2] = (Uint8)((PALETTE_RED.b * red * (1 - white) + PALETTE_WHITE.b * white) / amount + 0.5f);
+}
+
+//keeps a running average of how long post-processing takes, and drops or brings back effects to keep it under budget
+static void updateBudget(double ms) {
+	averageMs += (ms - averageMs) * POST_PROCESS_AVERAGE_WEIGHT;
+	if (++framesAtLevel < POST_PROCESS_SETTLE_FRAMES)
+		return;
+
+	if (averageMs > POST_PROCESS_BUDGET_MS && level > PPL_OFF) {
+		++dropCounts[level];
+		printf("WARNING - Post-processing is taking %.2f ms a frame, which is over budget. Dropping to %s.\n", averageMs, LEVEL_NAMES[level - 1]);
+		setLevel(level - 1);
+	}
+	else if (averageMs < POST_PROCESS_BUDGET_MS * POST_PROCESS_RECOVER_FRACTION && framesAtLevel >= POST_PROCESS_RECOVER_FRAMES
+		&& level + 1 < PPL_MAX && dropCounts[level + 1] < MAX_POST_PROCESS_RETRIES)
+		setLevel(level + 1);
+}
+
+//the running average starts over, since the old one was for different effects
+static void setLevel(PostProcessLevel newLevel) {
+	level = newLevel;
+	averageMs = 0;
+	framesAtLevel = 0;
+}
+
+//runs a pass over rows 0 to rows (not included), split into tiles that the main thread and the workers take one at a time until they run out
+//passes only ever write to their own rows, so what comes out doesn't depend on which thread got which tile
+static void runPass(PostProcessPass pass, int rows) {
+	currentPass = pass;
+	currentPassRows = rows;
+	SDL_AtomicSet(&nextTile, 0);
+
+	for (int i = 0; i < workerCount; ++i)
+		SDL_SemPost(workers[i].start);
+
+	runTiles();
+
+	for (int i = 0; i < workerCount; ++i)
+		SDL_SemWait(passDone);
+}
+
+//takes tiles of the current pass until there aren't any left
+static void runTiles(void) {
+	int tile;
+	while ((tile = SDL_AtomicAdd(&nextTile, 1)) * POST_PROCESS_TILE_ROWS < currentPassRows)
+		currentPass(tile * POST_PROCESS_TILE_ROWS, MIN(currentPassRows, (tile + 1) * POST_PROCESS_TILE_ROWS));
+}
+
+//waits for passes and takes tiles of each one
+static int postProcessWorker(void *data) {
+	PostProcessWorker *worker = data;
+
+	while (true) {
+		SDL_SemWait(worker->start);
+		if (workersQuit)
+			return 0;
+
+		runTiles();
+		SDL_SemPost(passDone);
+	}
+}
+
+//shrinks the bright parts of the frame down into bloomA, and blurs them sideways
+//everything a row's sideways blur needs is on that row, so this is all one pass
+static void bloomRows(int top, int bottom) {
+	Uint32 temp[BLOOM_STRIDE] = { 0 };	//the ends stay black, like the border of the bloom buffers
+
+	for (int y = top; y < bottom; ++y) {
+		Uint32 *row = bloomA + (y + 1) * BLOOM_STRIDE;
+		downsampleRow(row + 1, input + y * 2 * SCREEN_WIDTH, input + (y * 2 + 1) * SCREEN_WIDTH);
+
+		for (int i = 0; i < BLOOM_BLUR_PASSES; i += 2) {
+			blurRun(temp + 1, row, row + 1, row + 2, BLOOM_W);
+			blurRun(row + 1, temp, temp + 1, temp + 2, BLOOM_W);
+		}
+	}
+}
+
+//blurs blurSource into blurDest up and down
+static void verticalBlurRows(int top, int bottom) {
+	for (int y = top; y < bottom; ++y)
+		blurRun(blurDest + (y + 1) * BLOOM_STRIDE + 1, blurSource + y * BLOOM_STRIDE + 1, blurSource + (y + 1) * BLOOM_STRIDE + 1, blurSource + (y + 2) * BLOOM_STRIDE + 1, BLOOM_W);
+}
+
+//puts every effect together into the output
+static void compositeRows(int top, int bottom) {
+	for (int y = top; y < bottom; ++y) {
+		Uint32 *dst = (Uint32 *)(outputPixels + y * outputPitch);
+		int x = 0;
+
+#ifdef POST_PROCESS_USE_SSE2
+		x = compositeRowSSE2(dst, y);
+#endif
+
+		for (; x < SCREEN_WIDTH; ++x)
+			dst[x] = compositePixel(x, y);
+	}
+}
+
+//averages each 2x2 block of pixels from two rows of the frame, and keeps only how much brighter than BLOOM_THRESHOLD each channel is (doubled, so it's still bright enough to see once it's blurred)
+static void downsampleRow(Uint32 *dst, const Uint32 *row0, const Uint32 *row1) {
+	int x = 0;
+
+#ifdef POST_PROCESS_USE_SSE2
+	x = downsampleRowSSE2(dst, row0, row1);
+#endif
+
+	//stepped through by pointer rather than indexed with x * 2, which the compiler can't prove doesn't overflow
+	const Uint32 *pair0 = row0 + x * 2;
+	const Uint32 *pair1 = row1 + x * 2;
+
+	for (; x < BLOOM_W; ++x, pair0 += 2, pair1 += 2) {
+		Uint32 average = averagePixels(averagePixels(pair0[0], pair1[0]), averagePixels(pair0[1], pair1[1]));
+		Uint8 channels[4];
+		memcpy(channels, &average, 4);
+
+		for (int c = 0; c < 3; ++c)
+			channels[c] = MIN(255, MAX(0, channels[c] - BLOOM_THRESHOLD) * 2);
+		channels[3] = 0;
+
+		memcpy(&dst[x], channels, 4);
+	}
+}
+
+//a 1-2-1 blur: each pixel is averaged with the ones either side of it (prev and next are the pixels before and after center, in whichever direction)
+static void blurRun(Uint32 *dst, const Uint32 *prev, const Uint32 *center, const Uint32 *next, int count) {
+	int i = 0;
+
+#ifdef POST_PROCESS_USE_SSE2
+	i = blurRunSSE2(dst, prev, center, next, count);
+#endif
+
+	for (; i < count; ++i)
+		dst[i] = averagePixels(averagePixels(prev[i], next[i]), center[i]);
+}
+
+//one pixel of the output (the same as compositeRowSSE2 does 4 at a time)
+static Uint32 compositePixel(int x, int y) {
+	Uint32 src, bloom = 0;
+	int shade;
+
+	if (effectLevel >= PPL_CRT) {
+		Uint32 tap = curveTaps[y * SCREEN_WIDTH + x];
+		src = sampleTap(tap, &bloom);
+		shade = tap >> 24;
+	}
+	else {
+		src = input[y * SCREEN_WIDTH + x];
+		shade = getRowShade(y);
+	}
+
+	Uint8 in[4], glow[4], out[4];
+	memcpy(in, &src, 4);
+	memcpy(glow, &bloom, 4);
+
+	for (int c = 0; c < 3; ++c) {
+		int value = MIN(255, in[c] + glow[c]);
+		value += ((flashColor[c] - value) * flashAmount) >> 7;
+		out[c] = div255(value * shade);
+	}
+	out[3] = 255;
+
+	Uint32 pixel;
+	memcpy(&pixel, out, 4);
+	return pixel;
+}
+
+#ifdef POST_PROCESS_USE_SSE2
+//does downsampleRow 4 bloom pixels at a time
+//returns how far along the row it got (the rest is left for downsampleRow)
+static int downsampleRowSSE2(Uint32 *dst, const Uint32 *row0, const Uint32 *row1) {
+	const __m128i threshold = _mm_set1_epi32((int)(0xFF000000 | BLOOM_THRESHOLD * 0x010101));	//alpha never blooms
+	int x = 0;
+
+	for (; x + 3 < BLOOM_W; x += 4) {
+		__m128 columns0 = _mm_castsi128_ps(_mm_avg_epu8(_mm_loadu_si128((const __m128i *)(row0 + x * 2)), _mm_loadu_si128((const __m128i *)(row1 + x * 2))));
+		__m128 columns1 = _mm_castsi128_ps(_mm_avg_epu8(_mm_loadu_si128((const __m128i *)(row0 + x * 2 + 4)), _mm_loadu_si128((const __m128i *)(row1 + x * 2 + 4))));
+
+		//left and right pixel of each pair
+		__m128i left = _mm_castps_si128(_mm_shuffle_ps(columns0, columns1, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i right = _mm_castps_si128(_mm_shuffle_ps(columns0, columns1, _MM_SHUFFLE(3, 1, 3, 1)));
+
+		__m128i bright = _mm_subs_epu8(_mm_avg_epu8(left, right), threshold);
+		_mm_storeu_si128((__m128i *)(dst + x), _mm_adds_epu8(bright, bright));
+	}
+
+	return x;
+}
+
+//does blurRun 4 pixels at a time
+static int blurRunSSE2(Uint32 *dst, const Uint32 *prev, const Uint32 *center, const Uint32 *next, int count) {
+	int i = 0;
+
+	for (; i + 3 < count; i += 4) {
+		__m128i sides = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(prev + i)), _mm_loadu_si128((const __m128i *)(next + i)));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_avg_epu8(sides, _mm_loadu_si128((const __m128i *)(center + i))));
+	}
+
+	return i;
+}
+
+//does compositePixel 4 pixels at a time
+static int compositeRowSSE2(Uint32 *dst, int y) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i flash16 = _mm_set_epi16(0, flashColor[2], flashColor[1], flashColor[0], 0, flashColor[2], flashColor[1], flashColor[0]);
+	const __m128i amount16 = _mm_set1_epi16(flashAmount);
+	const __m128i opaque = _mm_set1_epi32((int)0xFF000000);
+	const __m128i rowShade16 = _mm_set1_epi16(getRowShade(y));
+	const Uint32 *taps = curveTaps + y * SCREEN_WIDTH;
+	int x = 0;
+
+	for (; x + 3 < SCREEN_WIDTH; x += 4) {
+		__m128i src, bloom, shadeLo, shadeHi;
+
+		if (effectLevel >= PPL_CRT) {
+			//where each pixel comes from on the curved screen (a gather, so this part is one pixel at a time)
+			Uint32 srcs[4], blooms[4] = { 0 };
+			for (int i = 0; i < 4; ++i)
+				srcs[i] = sampleTap(taps[x + i], &blooms[i]);
+
+			src = _mm_loadu_si128((const __m128i *)srcs);
+			bloom = _mm_loadu_si128((const __m128i *)blooms);
+
+			//each pixel's brightness copied into all of its lanes
+			int s0 = taps[x] >> 24, s1 = taps[x + 1] >> 24, s2 = taps[x + 2] >> 24, s3 = taps[x + 3] >> 24;
+			shadeLo = _mm_set_epi16(s1, s1, s1, s1, s0, s0, s0, s0);
+			shadeHi = _mm_set_epi16(s3, s3, s3, s3, s2, s2, s2, s2);
+		}
+		else {
+			src = _mm_loadu_si128((const __m128i *)(input + y * SCREEN_WIDTH + x));
+			bloom = zero;
+			shadeLo = rowShade16;
+			shadeHi = rowShade16;
+		}
+
+		src = _mm_adds_epu8(src, bloom);
+
+		//2 pixels per register, one channel per 16-bit lane
+		__m128i lo = _mm_unpacklo_epi8(src, zero);
+		__m128i hi = _mm_unpackhi_epi8(src, zero);
+
+		//shift toward the flash color ((255 * 128) still fits in a signed 16-bit lane)
+		lo = _mm_add_epi16(lo, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(flash16, lo), amount16), 7));
+		hi = _mm_add_epi16(hi, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(flash16, hi), amount16), 7));
+
+		lo = div255SSE2(_mm_mullo_epi16(lo, shadeLo));
+		hi = div255SSE2(_mm_mullo_epi16(hi, shadeHi));
+
+		_mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(_mm_packus_epi16(lo, hi), opaque));
+	}
+
+	return x;
+}
+
+//divides every unsigned 16-bit lane by 255, rounded (same as div255)
+static __m128i div255SSE2(__m128i x) {
+	x = _mm_add_epi16(x, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+#endif
+
+//the pixel of the frame a curve tap points at, and its bloom (only filled in when bloom is on)
+static Uint32 sampleTap(Uint32 tap, Uint32 *bloom) {
+	int x = tap & 0x3FF;
+	int y = (tap >> 10) & 0x1FF;
+
+	if (effectLevel >= PPL_FULL)
+		*bloom = bloomA[(y / 2 + 1) * BLOOM_STRIDE + x / 2 + 1];
+
+	return input[y * SCREEN_WIDTH + x];
+}
+
+//brightness of a row out of 255, for scanlines
+static int getRowShade(int y) {
+	return y % 2 == 1 ? SCANLINE_SHADE : 255;
+}
+
+//rounded-up average of each channel of two pixels (same as _mm_avg_epu8)
+static Uint32 averagePixels(Uint32 a, Uint32 b) {
+	return (a | b) - (((a ^ b) & 0xFEFEFEFE) >> 1);
+}
+
+//x / 255, rounded, for 0 <= x <= 255 * 255
+static int div255(int x) {
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+//stops the worker threads and frees everything post-processing made
+void deletePostProcess(void) {
+	workersQuit = true;
+	for (int i = 0; i < workerCount; ++i)
+		SDL_SemPost(workers[i].start);
+	for (int i = 0; i < workerCount; ++i) {
+		SDL_WaitThread(workers[i].thread, NULL);
+		SDL_DestroySemaphore(workers[i].start);
+	}
+	workerCount = 0;
+
+	if (passDone != NULL)
+		SDL_DestroySemaphore(passDone);
+	passDone = NULL;
+
+	if (output != NULL)
+		SDL_DestroyTexture(output);
+	output = NULL;
+
+	free(input);
+	free(curveTaps);
+	free(bloomA);
+	free(bloomB);
+	input = NULL;
+	curveTaps = NULL;
+	bloomA = NULL;
+	bloomB = NULL;
+
+	initialized = false;
+	failed = false;
+	active = false;
+}
\ No newline at end of file
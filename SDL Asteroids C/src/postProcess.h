@@ -0,0 +1,31 @@
+#ifndef POST_PROCESS_H
+#define POST_PROCESS_H
+
+/*
+* An optional CRT look, done on the CPU to the finished SCREEN_WIDTH x SCREEN_HEIGHT frame just before it's shown (see presentScene).
+* In order: bright pixels bloom, the screen curves like an old tube (with darker corners), the palette shifts toward red or white for the hit and powerup flashes,
+* and every other row is darkened for scanlines.
+* The frame is read back from the scene texture, split into tiles of rows that get worked through by a few threads, 4 pixels at a time with SSE2 (when it's available),
+* then uploaded to a streaming texture that gets drawn to the window in place of the scene texture.
+* Each frame's post-processing is timed, and if it keeps going over budget the most expensive effect is dropped (bloom, then the curvature, then everything).
+* Effects are tried again after a while of being well under budget.
+* When headless, the framebuffer is post-processed in place, always with every effect, so runs still come out the same on every machine.
+*/
+
+//PPL stands for post-process level
+//each level has every effect the level before it has
+typedef enum {
+	PPL_OFF,		//the scene is drawn to the window as-is
+	PPL_SCANLINES,	//scanlines and the palette flashes
+	PPL_CRT,		//screen curvature and darker corners
+	PPL_FULL,		//bloom
+
+	PPL_MAX
+} PostProcessLevel;
+
+bool isPostProcessActive(void);
+void setPostProcessFlash(float red, float white);
+SDL_Texture *applyPostProcess(void);
+void deletePostProcess(void);
+
+#endif
\ No newline at end of file
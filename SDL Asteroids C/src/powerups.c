@@ -1,6 +1,9 @@
 #include "common.h"
 
 #include "background.h"
+#include "colliders.h"
+#include "composites.h"
+#include "debugDraw.h"
 #include "draw.h"
 #include "fonts.h"
 #include "geometry.h"
@@ -20,35 +23,36 @@ extern int timeSincePowerupCollected;
 
 void initPowerup(int x, int y);
 
-static const float POWERUP_MOVE_DISTANCE_SQUARED = 100 * 100;	//how close to the player the powerup must be to start moving (squared)
+static const float POWERUP_MOVE_DISTANCE = 100;	//how close to the player the powerup must be to start moving
 static const float POWERUP_ACCEL = 0.5;
 static const float POWERUP_MAX_SPD = 5;
 static const int HORZ_EDGE_DIST = 16;	//screenwrap var
 static const int VERT_EDGE_DIST = 16;	//screenwrap var
-static const float POWERUP_COLLECT_DISTANCE_SQUARED = 25 * 25;	//distance at which a piece of scrap is collected by the player, squared for an optimized calculation
+static const float POWERUP_COLLECT_DISTANCE = 25;	//distance at which a powerup is collected by the player
 static const int POWERUP_TEXT_OFFSET = 50;	//how far offset the collection info text should be from the center of the powerup
 static const char * const POWERUP_INFO_TEXT_HP = "+HP!";
 static const char * const POWERUP_INFO_TEXT_SCRAP = "+SCRAP!";
 static char powerupInfoText[10];	//buffer that holds the text to be referred to by the powerup info text function
-static SpriteStatic *powerupCell = NULL;
-static SpriteStatic *powerupCellShine = NULL;
+static SpriteStatic *powerupCell = NULL;	//only used for its size; powerups are drawn from composites (see composites.h)
 
 static void powerupCollectShockwaveUpdate(Particle *particle) {
 	particle->x = player->x;
 	particle->y = player->y;
+
+	//delete particle when animation is over (using extra frame trick to tell when animation is done)
+	if (particle->sprite->currentFrame >= particle->sprite->frames - 1)
+		particle->ttl = 0;
 }
 
 static void powerupCollectShockwaveDraw(Particle *particle) {
-	//draw if the animation isn't over yet (using extra frame trick to tell when animation is done)
+	//draw if the animation isn't over yet
 	if (particle->sprite->currentFrame < particle->sprite->frames - 1) {
 		//complex draw event for a dumb over-optimized sprite
-		blitAndUpdateSpriteAnimatedEX(particle->sprite, particle->x, particle->y, particle->angle, NULL, SDL_FLIP_NONE);
-		blitAndUpdateSpriteAnimatedEX(particle->sprite, particle->x + particle->sprite->w, particle->y, particle->angle, NULL, SDL_FLIP_HORIZONTAL);
-		blitAndUpdateSpriteAnimatedEX(particle->sprite, particle->x, particle->y + particle->sprite->h, particle->angle, NULL, SDL_FLIP_VERTICAL);
-		blitAndUpdateSpriteAnimatedEX(particle->sprite, particle->x + particle->sprite->w, particle->y + particle->sprite->h, particle->angle, NULL, SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL);
+		blitSpriteAnimatedEX(particle->sprite, particle->x, particle->y, particle->angle, NULL, SDL_FLIP_NONE);
+		blitSpriteAnimatedEX(particle->sprite, particle->x + particle->sprite->w, particle->y, particle->angle, NULL, SDL_FLIP_HORIZONTAL);
+		blitSpriteAnimatedEX(particle->sprite, particle->x, particle->y + particle->sprite->h, particle->angle, NULL, SDL_FLIP_VERTICAL);
+		blitSpriteAnimatedEX(particle->sprite, particle->x + particle->sprite->w, particle->y + particle->sprite->h, particle->angle, NULL, SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL);
 	}
-	else
-		particle->ttl = 0; 	//delete particle when animation is over
 }
 
 static void powerupInfoTextUpdate(Particle *particle) {
@@ -67,13 +71,15 @@ static void powerupInfoTextDraw(Particle *particle) {
 
 //update function for powerups
 static void powerupUpdate(Particle *powerup) {
-	//accelerate towards the player if closeby & player isn't dead
-	if (distanceSquared(powerup->x, powerup->y, player->x, player->y) < POWERUP_MOVE_DISTANCE_SQUARED && player != PS_DESTROYED) {
-		if (player->x < powerup->x)
+	OBBCollider *target;
+
+	//accelerate towards the player if closeby & player isn't dead (dead players have their collider switched off)
+	if (queryRadius(LAYER_BIT(CL_PLAYER), (Vector2) { powerup->x, powerup->y }, POWERUP_MOVE_DISTANCE, false, &target, 1) > 0) {
+		if (target->origin.x < powerup->x)
 			powerup->deltaX = MAX(powerup->deltaX - POWERUP_ACCEL, -POWERUP_MAX_SPD);
 		else
 			powerup->deltaX = MIN(powerup->deltaX + POWERUP_ACCEL, POWERUP_MAX_SPD);
-		if (player->y < powerup->y)
+		if (target->origin.y < powerup->y)
 			powerup->deltaY = MAX(powerup->deltaY - POWERUP_ACCEL, -POWERUP_MAX_SPD);
 		else
 			powerup->deltaY = MIN(powerup->deltaY + POWERUP_ACCEL, POWERUP_MAX_SPD);
@@ -104,10 +110,14 @@ static void powerupUpdate(Particle *powerup) {
 	if (powerup->y > SCREEN_HEIGHT + VERT_EDGE_DIST)
 		powerup->y = -VERT_EDGE_DIST;
 
+	//the cell, its shine and the letter are baked into one sprite; pick the shine level closest to the blinking effect
+	float shine = sin((float)(stage.timer) / 5) * 127 + 127;
+	powerup->sprite->currentFrame = (int)(shine / 254 * (POWERUP_SHINE_LEVELS - 1) + 0.5);
+
 	//if close enough to the player & player isn't dead, increment score and delete this projectile
-	if (distanceSquared(powerup->x, powerup->y, player->x, player->y) < POWERUP_COLLECT_DISTANCE_SQUARED && player != PS_DESTROYED) {
+	if (queryRadius(LAYER_BIT(CL_PLAYER), (Vector2) { powerup->x, powerup->y }, POWERUP_COLLECT_DISTANCE, false, &target, 1) > 0) {
 		//collection particle
-		initParticle(initSpriteAnimated(app.gameplaySprites, 0, 16, 2, 2, SC_BOTTOM_RIGHT, 5, 0, 0.05, AL_ONESHOT), player->x, player->y, 0, 0, 0, 1, powerupCollectShockwaveUpdate, powerupCollectShockwaveDraw);
+		initParticle(initSpriteAnimatedFromTable(SPR_POWERUP_SHOCKWAVE, 0), player->x, player->y, 0, 0, 0, 1, powerupCollectShockwaveUpdate, powerupCollectShockwaveDraw);
 		playSound(SFX_POWER_UP, SC_ANY, false, powerup->x / SCREEN_HEIGHT * 255);
 
 		//set player to do powerup collection flash
@@ -117,19 +127,22 @@ static void powerupUpdate(Particle *powerup) {
 		background.backgroundFlashWhiteTimer = 0;
 
 		//change player weapon
-		switch (powerup->sprite->srcX) {
-		case(0):
+		switch (getCompositeSprite(powerup->sprite)) {
+		case(CS_POWERUP_NORMAL):
 			player->weaponType = BT_NORMAL;
 			break;
-		case(32):
+		case(CS_POWERUP_ERRATIC):
 			player->weaponType = BT_ERRATIC;
 			break;
-		case(64):
+		case(CS_POWERUP_BOUNCER):
 			player->weaponType = BT_BOUNCER;
 			break;
-		case(96):
+		case(CS_POWERUP_SHOTGUN):
 			player->weaponType = BT_SHOTGUN;
 			break;
+		default:
+			//not a powerup composite; leave the weapon alone
+			break;
 		}
 
 		//give player hp if they need it; otherwise, give a bunch of scrap.
@@ -155,11 +168,8 @@ static void powerupUpdate(Particle *powerup) {
 
 //draw function for a powerup
 static void powerupDraw(Particle *powerup) {
-	blitSpriteStatic(powerupCell, powerup->x, powerup->y);
-	setTextureRGBA(powerup->sprite->atlas->texture, 255, 255, 255, sin((float)(stage.timer) / 5) * 127 + 127);	//blinking effect
-	blitSpriteStatic(powerupCellShine, powerup->x, powerup->y);
-	setTextureRGBA(powerup->sprite->atlas->texture, 255, 255, 255, 255);
-	blitAndUpdateSpriteAnimatedEX(powerup->sprite, powerup->x, powerup->y, powerup->angle, NULL, SDL_FLIP_NONE);
+	//the shine level's picked in powerupUpdate
+	blitSpriteAnimatedEX(powerup->sprite, powerup->x, powerup->y, powerup->angle, NULL, SDL_FLIP_NONE);
 }
 
 //initializes a new powerup
@@ -196,35 +206,35 @@ void initPowerup(int x, int y) {
 	if (y > SCREEN_HEIGHT - powerupCell->h * 0.5)
 		y = SCREEN_HEIGHT - powerupCell->h * 0.5;
 
+	addDebugSpawnPoint(x, y, "POWERUP");
+
 	//initialize powerup
 	switch (type) {
 		case(BT_NORMAL):
-			initParticle(initSpriteAnimated(app.gameplaySprites, 0, 14, 2, 2, SC_CENTER, 1, 0, 0, AL_ONESHOT), x, y, 0, 0, 0, 1, powerupUpdate, powerupDraw);
+			initParticle(initCompositeSprite(CS_POWERUP_NORMAL), x, y, 0, 0, 0, 1, powerupUpdate, powerupDraw);
 			break;
 		case(BT_ERRATIC):
-			initParticle(initSpriteAnimated(app.gameplaySprites, 2, 14, 2, 2, SC_CENTER, 1, 0, 0, AL_ONESHOT), x, y, 0, 0, 0, 1, powerupUpdate, powerupDraw);
+			initParticle(initCompositeSprite(CS_POWERUP_ERRATIC), x, y, 0, 0, 0, 1, powerupUpdate, powerupDraw);
 			break;
 		case(BT_BOUNCER):
-			initParticle(initSpriteAnimated(app.gameplaySprites, 4, 14, 2, 2, SC_CENTER, 1, 0, 0, AL_ONESHOT), x, y, 0, 0, 0, 1, powerupUpdate, powerupDraw);
+			initParticle(initCompositeSprite(CS_POWERUP_BOUNCER), x, y, 0, 0, 0, 1, powerupUpdate, powerupDraw);
 			break;
 		case(BT_SHOTGUN):
-			initParticle(initSpriteAnimated(app.gameplaySprites, 6, 14, 2, 2, SC_CENTER, 1, 0, 0, AL_ONESHOT), x, y, 0, 0, 0, 1, powerupUpdate, powerupDraw);
+			initParticle(initCompositeSprite(CS_POWERUP_SHOTGUN), x, y, 0, 0, 0, 1, powerupUpdate, powerupDraw);
 			break;
 		default:
-			initParticle(initSpriteAnimated(app.gameplaySprites, 0, 14, 2, 2, SC_CENTER, 1, 0, 0, AL_ONESHOT), x, y, 0, 0, 0, 1, powerupUpdate, powerupDraw);
+			initParticle(initCompositeSprite(CS_POWERUP_NORMAL), x, y, 0, 0, 0, 1, powerupUpdate, powerupDraw);
 	}
 }
 
 //initialize common sprites
 void initPowerups(void) {
-	powerupCell = initSpriteStatic(app.gameplaySprites, 8, 14, 2, 2, SC_CENTER);
-	powerupCellShine = initSpriteStatic(app.gameplaySprites, 10, 14, 2, 2, SC_CENTER);
+	powerupCell = initSpriteStaticFromTable(SPR_POWERUP_CELL, 0);
 }
 
 //deletes common sprites
 void deletePowerups(void) {
 	free(powerupCell);
-	free(powerupCellShine);
 }
 
 //no destructor needed; since a powerup is a particle, when its ttl is set to 0, it gets deleted by updateParticles when called in the stage update function
\ No newline at end of file
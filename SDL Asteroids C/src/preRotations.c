@@ -0,0 +1,219 @@
+#include "common.h"
+
+#include "preRotations.h"
+
+extern App app;
+
+const PreRotatedSprite *getPreRotatedSprite(SDL_Texture *source, int srcX, int srcY, int w, int h, int frames);
+bool getPreRotatedFrame(const PreRotatedSprite *sprite, int frame, float angle, SDL_Texture **pageOut, SDL_Rect *cell);
+void updatePreRotations(void);
+static int getPreRotationSteps(void);
+static void bakePreRotations(void);
+static void bakePreRotatedSprite(const PreRotatedSprite *sprite);
+void invalidatePreRotations(void);
+void deletePreRotations(void);
+
+static const int PAGE_MAX_W = 2048;	//the page is this wide (or as wide as the renderer allows), and only as tall as it needs to be
+
+static PreRotatedSprite sprites[MAX_PRE_ROTATED_SPRITES];
+static int spriteCount = 0;
+
+static SDL_Texture *page = NULL;
+static int bakedSteps = 0;		//number of angles the page was baked with; 0 if nothing is baked
+static bool pageDirty = true;	//true if the page needs to be rebuilt before it's used again
+
+//gets the baked rotations for a sprite (srcX, srcY, w and h are in pixels, like in SpriteStatic and SpriteAnimated)
+//nothing is drawn here; the sprite just gets added to the page the next time it's rebuilt (see updatePreRotations)
+//every sprite should be added while loading, so the page only gets built once; after that, this just finds the sprite
+//returns NULL if there's no room, in which case the sprite should just be rotated exactly
+const PreRotatedSprite *getPreRotatedSprite(SDL_Texture *source, int srcX, int srcY, int w, int h, int frames) {
+	//check if this sprite is already on the page
+	for (int i = 0; i < spriteCount; ++i) {
+		if (sprites[i].source == source && sprites[i].srcX == srcX && sprites[i].srcY == srcY && sprites[i].w == w && sprites[i].h == h && sprites[i].frames == frames)
+			return &sprites[i];
+	}
+
+	if (spriteCount >= MAX_PRE_ROTATED_SPRITES) {
+		printf("WARNING - Out of room for pre-rotated sprites. Raise MAX_PRE_ROTATED_SPRITES.\n");
+		return NULL;
+	}
+
+	SDL_Point *cells = calloc(frames * MAX_PRE_ROTATION_STEPS, sizeof(SDL_Point));
+	if (cells == NULL)
+		return NULL;
+
+	PreRotatedSprite *sprite = &sprites[spriteCount++];
+	sprite->source = source;
+	sprite->srcX = srcX;
+	sprite->srcY = srcY;
+	sprite->w = w;
+	sprite->h = h;
+	sprite->frames = frames;
+	sprite->baked = false;
+	sprite->cells = cells;
+
+	//the frame's diagonal, rounded up to an even number so the frame can be centered on a whole pixel
+	sprite->cellSize = (int)ceil(sqrt(w * w + h * h));
+	sprite->cellSize += sprite->cellSize & 1;
+
+	pageDirty = true;
+
+	return sprite;
+}
+
+//finds the baked copy of a frame closest to angle (in degrees, clockwise, around the center of the frame)
+//returns false if the frame should be rotated exactly instead (e.g. on high quality, or if it didn't fit on the page)
+bool getPreRotatedFrame(const PreRotatedSprite *sprite, int frame, float angle, SDL_Texture **pageOut, SDL_Rect *cell) {
+	int steps = getPreRotationSteps();
+
+	if (steps == 0 || sprite == NULL)
+		return false;
+
+	//the page only gets rebuilt at the start of a frame, so until then anything on it is rotated exactly
+	if (pageDirty || steps != bakedSteps)
+		return false;
+
+	if (!sprite->baked || frame < 0 || frame >= sprite->frames)
+		return false;
+
+	int index = (int)floor(angle / 360 * steps + 0.5);
+	index = ((index % steps) + steps) % steps;
+
+	SDL_Point point = sprite->cells[frame * MAX_PRE_ROTATION_STEPS + index];
+	cell->x = point.x;
+	cell->y = point.y;
+	cell->w = sprite->cellSize;
+	cell->h = sprite->cellSize;
+	*pageOut = page;
+
+	return true;
+}
+
+//rebuilds the page if it's out of date (sprites were added, the quality preference changed, or the renderer lost its target textures)
+//this draws, so call it when nothing's been queued yet (while loading, or at the start of a frame)
+void updatePreRotations(void) {
+	if (pageDirty || getPreRotationSteps() != bakedSteps)
+		bakePreRotations();
+}
+
+//number of angles each frame is baked at for the current quality preference
+//0 means sprites are rotated exactly
+static int getPreRotationSteps(void) {
+	switch (app.preferences.quality) {
+	case(GQ_LOW):
+		return 32;
+	case(GQ_MEDIUM):
+		return MAX_PRE_ROTATION_STEPS;
+	default:
+		return 0;
+	}
+}
+
+//lays out every sprite on a new page and draws its rotations into it
+static void bakePreRotations(void) {
+	int steps = getPreRotationSteps();
+
+	pageDirty = false;
+	bakedSteps = steps;
+
+	if (page != NULL) {
+		SDL_DestroyTexture(page);
+		page = NULL;
+	}
+
+	SDL_RendererInfo info;
+	int pageW = PAGE_MAX_W, maxH = PAGE_MAX_W;
+	if (SDL_GetRendererInfo(app.renderer, &info) == 0 && info.max_texture_width > 0) {
+		pageW = MIN(pageW, info.max_texture_width);
+		maxH = info.max_texture_height;
+	}
+
+	//lay out cells in rows (each row is as tall as the biggest cell in it)
+	int x = 0, y = 0, rowH = 0;
+	for (int i = 0; i < spriteCount; ++i) {
+		PreRotatedSprite *sprite = &sprites[i];
+		sprite->baked = sprite->cellSize <= pageW;
+
+		for (int j = 0; j < sprite->frames * steps && sprite->baked; ++j) {
+			if (x + sprite->cellSize > pageW) {
+				x = 0;
+				y += rowH;
+				rowH = 0;
+			}
+			if (y + sprite->cellSize > maxH) {
+				printf("WARNING - Pre-rotated sprites don't fit on one page; the rest will be rotated exactly.\n");
+				sprite->baked = false;
+				break;
+			}
+
+			sprite->cells[(j / steps) * MAX_PRE_ROTATION_STEPS + j % steps] = (SDL_Point){ x, y };
+			x += sprite->cellSize;
+			rowH = MAX(rowH, sprite->cellSize);
+		}
+	}
+
+	if (y + rowH == 0)
+		return;
+
+	page = SDL_CreateTexture(app.renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, pageW, y + rowH);
+	if (page == NULL) {
+		printf("WARNING - Pre-rotated sprite page could not be created: %s\n", SDL_GetError());
+		for (int i = 0; i < spriteCount; ++i)
+			sprites[i].baked = false;
+		return;
+	}
+	SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+
+	//draw straight into the page (nothing's queued when this is called; see updatePreRotations)
+	SDL_Texture *target = SDL_GetRenderTarget(app.renderer);
+	SDL_SetRenderTarget(app.renderer, page);
+	SDL_SetRenderDrawColor(app.renderer, 0x0, 0x0, 0x0, 0x0);
+	SDL_RenderClear(app.renderer);
+
+	for (int i = 0; i < spriteCount; ++i) {
+		if (sprites[i].baked)
+			bakePreRotatedSprite(&sprites[i]);
+	}
+
+	SDL_SetRenderTarget(app.renderer, target);
+}
+
+//draws every baked angle of every frame of a sprite into the page
+static void bakePreRotatedSprite(const PreRotatedSprite *sprite) {
+	SDL_BlendMode blendMode;
+	SDL_GetTextureBlendMode(sprite->source, &blendMode);
+
+	//copy pixels as they are instead of blending them with the cleared page, so the page doesn't end up premultiplied
+	SDL_SetTextureBlendMode(sprite->source, SDL_BLENDMODE_NONE);
+
+	for (int frame = 0; frame < sprite->frames; ++frame) {
+		SDL_Rect src = { sprite->srcX + frame * sprite->w, sprite->srcY, sprite->w, sprite->h };
+
+		for (int i = 0; i < bakedSteps; ++i) {
+			SDL_Point cell = sprite->cells[frame * MAX_PRE_ROTATION_STEPS + i];
+			SDL_Rect dest = { cell.x + (sprite->cellSize - sprite->w) / 2, cell.y + (sprite->cellSize - sprite->h) / 2, sprite->w, sprite->h };
+			SDL_RenderCopyEx(app.renderer, sprite->source, &src, &dest, i * 360.0 / bakedSteps, NULL, SDL_FLIP_NONE);
+		}
+	}
+
+	SDL_SetTextureBlendMode(sprite->source, blendMode);
+}
+
+//makes the page get rebuilt at the start of the next frame (e.g. when the renderer loses the contents of its target textures)
+void invalidatePreRotations(void) {
+	pageDirty = true;
+}
+
+//frees the page and every sprite's cells
+void deletePreRotations(void) {
+	for (int i = 0; i < spriteCount; ++i)
+		free(sprites[i].cells);
+	spriteCount = 0;
+
+	if (page != NULL) {
+		SDL_DestroyTexture(page);
+		page = NULL;
+	}
+	bakedSteps = 0;
+	pageDirty = true;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef PRE_ROTATIONS_H
+#define PRE_ROTATIONS_H
+
+/*
+* Sprites that get drawn at arbitrary angles every frame (crates, enemies, bullets) can have copies of themselves baked at a fixed number of angles.
+* The copies go into a generated atlas page, so drawing one of these sprites rotated is just an axis-aligned copy from that page.
+* The number of angles depends on the graphics quality preference; on GQ_HIGH nothing is baked and sprites are rotated exactly.
+* Every sprite that gets baked is added while loading, and the page is built once then (see initPreRotatedSprites in draw.c).
+* After that it's only rebuilt if the quality preference changes or the renderer loses it, at the start of the next frame (see updatePreRotations).
+* Sprites are owned by this file; don't free them.
+*/
+
+#define MAX_PRE_ROTATED_SPRITES 32	//max number of different sprites (static or animated) that can be baked
+#define MAX_PRE_ROTATION_STEPS 64	//max number of baked angles per frame
+
+//every baked angle of every frame of a sprite
+typedef struct {
+	SDL_Texture *source;	//the sprite sheet this was baked from
+	int srcX;				//first frame of the sprite, in pixels
+	int srcY;
+	int w;
+	int h;
+	int frames;				//frames go left to right, like in SpriteAnimated
+	int cellSize;			//width and height of each baked copy; big enough to fit the frame at any angle
+	bool baked;				//false if the sprite didn't fit on the page
+	SDL_Point *cells;		//top left of each baked copy on the page (frames * MAX_PRE_ROTATION_STEPS; frame-major)
+} PreRotatedSprite;
+
+const PreRotatedSprite *getPreRotatedSprite(SDL_Texture *source, int srcX, int srcY, int w, int h, int frames);
+bool getPreRotatedFrame(const PreRotatedSprite *sprite, int frame, float angle, SDL_Texture **pageOut, SDL_Rect *cell);
+void updatePreRotations(void);
+void invalidatePreRotations(void);
+void deletePreRotations(void);
+
+#endif
\ No newline at end of file
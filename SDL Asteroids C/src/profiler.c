@@ -0,0 +1,67 @@
+#include "common.h"
+
+#include "debugDraw.h"
+#include "profiler.h"
+
+void addToProfilerCounter(ProfilerCounter counter, int amount);
+void updateProfiler(void);
+void drawProfiler(void);
+
+//labels for each counter, in the same order as the ProfilerCounter enum
+static const char *COUNTER_LABELS[PC_MAX] = {
+	"SAT TESTS",
+	"SAT CACHE HITS",
+	"PIXEL MASK TESTS",
+	"DRAW CALLS",
+	"QUADS",
+	"CULLED DRAWS",
+	"POST PROCESS US"
+};
+
+static const int PROFILER_PERIOD = FPS;	//number of frames counters are averaged over
+static const int PROFILER_MARGIN = 4;	//distance from the top left corner of the screen
+static const int PROFILER_LINE_HEIGHT = 14;
+
+static int counters[PC_MAX];		//running totals for the current period
+static float averages[PC_MAX];		//per-frame averages from the last full period (these are what get drawn)
+static int framesThisPeriod = 0;
+
+//adds amount to a counter
+//cheap enough to call from hot loops; counters are tallied whether or not debug is on
+void addToProfilerCounter(ProfilerCounter counter, int amount) {
+	counters[counter] += amount;
+}
+
+//call once per frame, after logic
+//once a full period has passed, averages the counters over it and starts a new period
+void updateProfiler(void) {
+	if (++framesThisPeriod < PROFILER_PERIOD)
+		return;
+
+	for (int i = 0; i < PC_MAX; ++i) {
+		averages[i] = (float)counters[i] / framesThisPeriod;
+		counters[i] = 0;
+	}
+
+	framesThisPeriod = 0;
+}
+
+//draws every counter's per-frame average, plus any rates derived from them
+//only happens if app.debug = true (see debugDraw.h)
+void drawProfiler(void) {
+	if (!isDebugDrawEnabled(DDC_PROFILER))
+		return;
+
+	char text[MAX_STRING_LENGTH];
+	int y = PROFILER_MARGIN;
+
+	for (int i = 0; i < PC_MAX; ++i) {
+		snprintf(text, MAX_STRING_LENGTH, "%s: %.1f", COUNTER_LABELS[i], averages[i]);
+		debugDrawText(DDC_PROFILER, text, PROFILER_MARGIN, y, COLOR_GREEN, TAH_LEFT);
+		y += PROFILER_LINE_HEIGHT;
+	}
+
+	//separating axis cache hit rate
+	snprintf(text, MAX_STRING_LENGTH, "SAT CACHE HIT RATE: %d%%", averages[PC_SAT_TESTS] > 0 ? (int)(100 * averages[PC_SAT_CACHE_HITS] / averages[PC_SAT_TESTS]) : 0);
+	debugDrawText(DDC_PROFILER, text, PROFILER_MARGIN, y, COLOR_GREEN, TAH_LEFT);
+}
\ No newline at end of file
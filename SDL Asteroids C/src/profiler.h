@@ -0,0 +1,27 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/*
+* Simple debug counters for seeing what the game's doing under the hood.
+* Counters are averaged over a second and drawn in the top left corner when app.debug is on (toggle with F3), through the debug draw buffer (see debugDraw.h).
+* To add a counter, add an entry to the enum below and a matching label in profiler.c.
+*/
+
+//PC stands for profiler counter
+typedef enum {
+	PC_SAT_TESTS,		//pairs of colliders that made it to the separating axis test
+	PC_SAT_CACHE_HITS,	//pairs that were thrown out by their cached separating axis alone
+	PC_PIXEL_MASK_TESTS,	//pairs whose boxes touched and went on to a per-pixel test
+	PC_DRAW_CALLS,		//batches sent off to the renderer
+	PC_QUADS,			//sprites and rectangles drawn through those batches
+	PC_CULLED_DRAWS,	//sprites and debug lines skipped for being offscreen
+	PC_POST_PROCESS_MICROSECONDS,	//time spent post-processing the frame (see postProcess.h)
+
+	PC_MAX
+} ProfilerCounter;
+
+void addToProfilerCounter(ProfilerCounter counter, int amount);
+void updateProfiler(void);
+void drawProfiler(void);
+
+#endif
\ No newline at end of file
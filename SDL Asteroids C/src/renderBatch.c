@@ -0,0 +1,221 @@
+#include "common.h"
+
+#include "geometry.h"
+#include "profiler.h"
+#include "renderBatch.h"
+
+extern App app;
+
+void batchQuad(SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dest, float angle, const SDL_Point *center, SDL_RendererFlip flip, SDL_Color color);
+void batchFilledRect(const SDL_Rect *rect, SDL_Color color);
+void batchVertices(SDL_Texture *texture, const SDL_Vertex *quadVertices, int quads);
+static bool reserveQuads(SDL_Texture *texture, int quads);
+void setRenderBatchBlendMode(SDL_BlendMode blendMode);
+void flushRenderBatch(void);
+static void sdlDrawQuads(SDL_Texture *texture, SDL_BlendMode blendMode, const SDL_Vertex *quadVertices, const int *quadIndices, int quads);
+void setRenderBackend(const RenderBackend *backend);
+const RenderBackend *getSDLRenderBackend(void);
+void deleteRenderBatch(void);
+
+static const int BATCH_START_QUADS = 256;	//starting capacity of the buffers, in quads (they double whenever they fill up)
+
+//the batch currently being built
+//the buffers are kept between frames so they only get allocated once things settle down
+static SDL_Texture *batchTexture = NULL;	//NULL for untextured (solid color) quads
+static SDL_BlendMode batchBlendMode = SDL_BLENDMODE_BLEND;
+static float batchTextureW = 1;				//size of batchTexture, for turning source rects into texture coordinates
+static float batchTextureH = 1;
+static SDL_Vertex *vertices = NULL;
+static int *indices = NULL;
+static int quadCount = 0;
+static int quadCapacity = 0;
+
+static const RenderBackend SDL_BACKEND = { sdlDrawQuads };
+static const RenderBackend *renderBackend = &SDL_BACKEND;
+
+//queues up a textured quad
+//works the same as SDL_RenderCopyEx: angle is in degrees, clockwise, around center (relative to dest; pass in NULL for the center of dest)
+void batchQuad(SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dest, float angle, const SDL_Point *center, SDL_RendererFlip flip, SDL_Color color) {
+	if (!reserveQuads(texture, 1))
+		return;
+
+	//texture coordinates
+	float u0 = src->x / batchTextureW, u1 = (src->x + src->w) / batchTextureW;
+	float v0 = src->y / batchTextureH, v1 = (src->y + src->h) / batchTextureH;
+	float swap;
+	if (flip & SDL_FLIP_HORIZONTAL) {
+		swap = u0; u0 = u1; u1 = swap;
+	}
+	if (flip & SDL_FLIP_VERTICAL) {
+		swap = v0; v0 = v1; v1 = swap;
+	}
+
+	//corners, starting at the top left and going clockwise
+	float cornersX[4] = { 0, dest->w, dest->w, 0 };
+	float cornersY[4] = { 0, 0, dest->h, dest->h };
+	float cornersU[4] = { u0, u1, u1, u0 };
+	float cornersV[4] = { v0, v0, v1, v1 };
+
+	//rotate corners around the center
+	if (angle != 0) {
+		float centerX = center != NULL ? center->x : dest->w * 0.5;
+		float centerY = center != NULL ? center->y : dest->h * 0.5;
+		float c = cos(angle * DEGREES_TO_RADIANS);
+		float s = sin(angle * DEGREES_TO_RADIANS);
+		float x, y;
+
+		for (int i = 0; i < 4; ++i) {
+			x = cornersX[i] - centerX;
+			y = cornersY[i] - centerY;
+			cornersX[i] = c * x - s * y + centerX;
+			cornersY[i] = s * x + c * y + centerY;
+		}
+	}
+
+	SDL_Vertex *vertex = &vertices[quadCount * 4];
+	for (int i = 0; i < 4; ++i) {
+		vertex[i].position.x = dest->x + cornersX[i];
+		vertex[i].position.y = dest->y + cornersY[i];
+		vertex[i].color = color;
+		vertex[i].tex_coord.x = cornersU[i];
+		vertex[i].tex_coord.y = cornersV[i];
+	}
+
+	++quadCount;
+}
+
+//queues up a solid color rectangle (blended using its alpha)
+void batchFilledRect(const SDL_Rect *rect, SDL_Color color) {
+	if (!reserveQuads(NULL, 1))
+		return;
+
+	float cornersX[4] = { rect->x, rect->x + rect->w, rect->x + rect->w, rect->x };
+	float cornersY[4] = { rect->y, rect->y, rect->y + rect->h, rect->y + rect->h };
+
+	SDL_Vertex *vertex = &vertices[quadCount * 4];
+	for (int i = 0; i < 4; ++i) {
+		vertex[i].position.x = cornersX[i];
+		vertex[i].position.y = cornersY[i];
+		vertex[i].color = color;
+		vertex[i].tex_coord.x = 0;
+		vertex[i].tex_coord.y = 0;
+	}
+
+	++quadCount;
+}
+
+//queues up quads that have already been built (4 vertices each, starting at the top left and going clockwise)
+//texture coordinates have to already be normalized
+void batchVertices(SDL_Texture *texture, const SDL_Vertex *quadVertices, int quads) {
+	if (quads <= 0 || !reserveQuads(texture, quads))
+		return;
+
+	memcpy(&vertices[quadCount * 4], quadVertices, quads * 4 * sizeof(SDL_Vertex));
+	quadCount += quads;
+}
+
+//makes room for more quads using texture
+//sends off the current batch first if it uses a different texture
+//returns false if there's no room and the quads should be skipped
+static bool reserveQuads(SDL_Texture *texture, int quads) {
+	if (quadCount > 0 && texture != batchTexture)
+		flushRenderBatch();
+
+	//start a new batch
+	if (quadCount == 0) {
+		batchTexture = texture;
+
+		int w = 1, h = 1;
+		if (texture != NULL)
+			SDL_QueryTexture(texture, NULL, NULL, &w, &h);
+		batchTextureW = w;
+		batchTextureH = h;
+	}
+
+	//grow the buffers if needed
+	if (quadCount + quads > quadCapacity) {
+		int newCapacity = quadCapacity > 0 ? quadCapacity * 2 : BATCH_START_QUADS;
+		while (newCapacity < quadCount + quads)
+			newCapacity *= 2;
+		SDL_Vertex *newVertices = realloc(vertices, newCapacity * 4 * sizeof(SDL_Vertex));
+		int *newIndices = realloc(indices, newCapacity * 6 * sizeof(int));
+
+		//keep whichever buffer did grow (it's still valid), but drop these quads
+		if (newVertices != NULL)
+			vertices = newVertices;
+		if (newIndices != NULL)
+			indices = newIndices;
+		if (newVertices == NULL || newIndices == NULL) {
+			printf("ERROR - Render batch could not grow to %d quads.\n", newCapacity);
+			return false;
+		}
+
+		//the index pattern never changes, so fill in the new part once here
+		for (int i = quadCapacity; i < newCapacity; ++i) {
+			indices[i * 6 + 0] = i * 4 + 0;
+			indices[i * 6 + 1] = i * 4 + 1;
+			indices[i * 6 + 2] = i * 4 + 2;
+			indices[i * 6 + 3] = i * 4 + 0;
+			indices[i * 6 + 4] = i * 4 + 2;
+			indices[i * 6 + 5] = i * 4 + 3;
+		}
+
+		quadCapacity = newCapacity;
+	}
+
+	return true;
+}
+
+//sets the blend mode for quads batched after this
+//sends off the current batch first if it's different
+void setRenderBatchBlendMode(SDL_BlendMode blendMode) {
+	if (blendMode == batchBlendMode)
+		return;
+
+	flushRenderBatch();
+	batchBlendMode = blendMode;
+}
+
+//draws everything in the current batch with one call to the render backend
+void flushRenderBatch(void) {
+	if (quadCount == 0)
+		return;
+
+	renderBackend->drawQuads(batchTexture, batchBlendMode, vertices, indices, quadCount);
+
+	addToProfilerCounter(PC_DRAW_CALLS, 1);
+	addToProfilerCounter(PC_QUADS, quadCount);
+
+	quadCount = 0;
+}
+
+//the default backend
+static void sdlDrawQuads(SDL_Texture *texture, SDL_BlendMode blendMode, const SDL_Vertex *quadVertices, const int *quadIndices, int quads) {
+	//untextured geometry uses the renderer's blend mode instead of a texture's
+	if (texture == NULL)
+		SDL_SetRenderDrawBlendMode(app.renderer, blendMode);
+	else
+		SDL_SetTextureBlendMode(texture, blendMode);
+
+	SDL_RenderGeometry(app.renderer, texture, quadVertices, quads * 4, quadIndices, quads * 6);
+}
+
+//switches where batches get drawn (NULL goes back to SDL_RenderGeometry)
+void setRenderBackend(const RenderBackend *backend) {
+	flushRenderBatch();
+	renderBackend = backend != NULL ? backend : &SDL_BACKEND;
+}
+
+//for backends that hand some batches back to SDL
+const RenderBackend *getSDLRenderBackend(void) {
+	return &SDL_BACKEND;
+}
+
+//frees the batch buffers
+void deleteRenderBatch(void) {
+	free(vertices);
+	free(indices);
+	vertices = NULL;
+	indices = NULL;
+	quadCount = quadCapacity = 0;
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef RENDER_BATCH_H
+#define RENDER_BATCH_H
+
+/*
+* Batches quads into as few SDL_RenderGeometry calls as possible.
+* Quads are queued in draw order; a batch is sent off whenever the texture changes, so draw order is always preserved.
+* Draw code doesn't use this directly; the render queue sorts its commands and feeds them in here when it's flushed.
+* Color and alpha are per-vertex, so there's no need to change texture state between quads.
+* Finished batches go to a render backend; normally that's SDL_RenderGeometry, but headless runs swap in the CPU rasterizer (see softRaster.h).
+*/
+
+//where finished batches get drawn
+//quads are 4 vertices each, starting at the top left and going clockwise, and indices split each one into 2 triangles
+typedef struct {
+	void (*drawQuads)(SDL_Texture *texture, SDL_BlendMode blendMode, const SDL_Vertex *vertices, const int *indices, int quads);
+} RenderBackend;
+
+void batchQuad(SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dest, float angle, const SDL_Point *center, SDL_RendererFlip flip, SDL_Color color);
+void batchFilledRect(const SDL_Rect *rect, SDL_Color color);
+void batchVertices(SDL_Texture *texture, const SDL_Vertex *quadVertices, int quads);
+void setRenderBatchBlendMode(SDL_BlendMode blendMode);
+void flushRenderBatch(void);
+void setRenderBackend(const RenderBackend *backend);
+const RenderBackend *getSDLRenderBackend(void);
+void deleteRenderBatch(void);
+
+#endif
\ No newline at end of file
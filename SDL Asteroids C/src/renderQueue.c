@@ -0,0 +1,248 @@
+#include "common.h"
+
+#include "glyphCache.h"
+#include "profiler.h"
+#include "renderBatch.h"
+#include "renderQueue.h"
+
+//RCT stands for render command type
+typedef enum {
+	RCT_QUAD,			//a textured quad, built when the queue is flushed
+	RCT_FILLED_RECT,	//a solid color rectangle
+	RCT_VERTICES		//quads that were already built by the draw code (e.g. a whole string of text)
+} RenderCommandType;
+
+//everything needed to draw one quad (or a run of prebuilt quads) later on
+typedef struct {
+	RenderCommandType type;
+
+	//sort keys
+	RenderLayer layer;
+	SDL_Texture *texture;		//NULL for a filled rectangle
+	SDL_BlendMode blendMode;
+	int order;					//position in the queue, so that commands with the same layer and state stay in the order they were queued in
+
+	//what to draw
+	SDL_Rect src;
+	SDL_Rect dest;
+	float angle;
+	SDL_Point center;
+	bool hasCenter;				//false to rotate around the center of dest
+	SDL_RendererFlip flip;
+	SDL_Color color;
+
+	//prebuilt quads (RCT_VERTICES only)
+	int firstVertex;			//where the quads start in the queue's vertex buffer
+	int quads;
+} RenderCommand;
+
+void queueQuad(RenderLayer layer, SDL_Texture *texture, SDL_BlendMode blendMode, const SDL_Rect *src, const SDL_Rect *dest, float angle, const SDL_Point *center, SDL_RendererFlip flip, SDL_Color color);
+void queueFilledRect(RenderLayer layer, SDL_BlendMode blendMode, const SDL_Rect *rect, SDL_Color color);
+SDL_Vertex *queueVertices(RenderLayer layer, SDL_Texture *texture, SDL_BlendMode blendMode, int quads);
+bool cullBounds(float left, float top, float right, float bottom);
+static RenderCommand *addRenderCommand(RenderCommandType type, RenderLayer layer, SDL_Texture *texture, SDL_BlendMode blendMode);
+static int compareRenderCommands(const void *a, const void *b);
+void flushRenderQueue(void);
+void deleteRenderQueue(void);
+
+static const int QUEUE_START_COMMANDS = 256;	//starting capacity of the queue (it doubles whenever it fills up)
+static const int CULL_MARGIN = 8;	//extra room around the screen before something counts as offscreen, in pixels
+
+//layers that are drawn in the order they were queued in, instead of being grouped by render state first
+//things on these overlap, and don't all come from the same texture (e.g. an enemy's muzzle flash is on the atlas, while its body and flame are baked rotations,
+//flashing crates come off the composites page, and text past ASCII comes off the glyph cache page), so grouping by texture would change what ends up on top
+static const bool KEEP_QUEUE_ORDER[RL_MAX] = {
+	[RL_CRATES] = true,
+	[RL_ENEMIES] = true,
+	[RL_BULLETS] = true,
+	[RL_PLAYER] = true,
+	[RL_UI] = true,
+	[RL_UI_DETAIL] = true
+};
+
+//the queue is kept between frames so it only gets allocated once things settle down
+static RenderCommand *commands = NULL;
+static int commandCount = 0;
+static int commandCapacity = 0;
+
+//prebuilt quads from queueVertices
+static SDL_Vertex *queuedVertices = NULL;
+static int queuedVertexCount = 0;
+static int queuedVertexCapacity = 0;
+
+//queues up a textured quad
+//arguments after blendMode work the same as in batchQuad
+//quads that are entirely offscreen get thrown out here, so nothing past this point has to deal with them
+void queueQuad(RenderLayer layer, SDL_Texture *texture, SDL_BlendMode blendMode, const SDL_Rect *src, const SDL_Rect *dest, float angle, const SDL_Point *center, SDL_RendererFlip flip, SDL_Color color) {
+	//find a box that's guaranteed to hold the quad
+	//for rotated quads, that's a square around the circle the corners sweep out around the center of rotation
+	if (angle == 0) {
+		if (cullBounds(dest->x, dest->y, dest->x + dest->w, dest->y + dest->h))
+			return;
+	} else {
+		float centerX = center != NULL ? center->x : dest->w * 0.5;
+		float centerY = center != NULL ? center->y : dest->h * 0.5;
+		float reachX = MAX(centerX, dest->w - centerX);
+		float reachY = MAX(centerY, dest->h - centerY);
+		float radius = sqrt(reachX * reachX + reachY * reachY);
+
+		if (cullBounds(dest->x + centerX - radius, dest->y + centerY - radius, dest->x + centerX + radius, dest->y + centerY + radius))
+			return;
+	}
+
+	RenderCommand *command = addRenderCommand(RCT_QUAD, layer, texture, blendMode);
+	if (command == NULL)
+		return;
+
+	command->src = *src;
+	command->dest = *dest;
+	command->angle = angle;
+	command->hasCenter = center != NULL;
+	if (center != NULL)
+		command->center = *center;
+	command->flip = flip;
+	command->color = color;
+}
+
+//queues up a solid color rectangle
+void queueFilledRect(RenderLayer layer, SDL_BlendMode blendMode, const SDL_Rect *rect, SDL_Color color) {
+	RenderCommand *command = addRenderCommand(RCT_FILLED_RECT, layer, NULL, blendMode);
+	if (command == NULL)
+		return;
+
+	command->dest = *rect;
+	command->color = color;
+}
+
+//queues up a run of quads as a single command, and returns the vertices for the caller to fill in
+//(4 per quad, starting at the top left and going clockwise, with normalized texture coordinates)
+//the pointer is only good until the next thing gets queued
+//returns NULL if there wasn't room, in which case nothing gets drawn
+SDL_Vertex *queueVertices(RenderLayer layer, SDL_Texture *texture, SDL_BlendMode blendMode, int quads) {
+	if (quads <= 0)
+		return NULL;
+
+	//grow the vertex buffer if needed
+	if (queuedVertexCount + quads * 4 > queuedVertexCapacity) {
+		int newCapacity = queuedVertexCapacity > 0 ? queuedVertexCapacity * 2 : QUEUE_START_COMMANDS * 4;
+		while (newCapacity < queuedVertexCount + quads * 4)
+			newCapacity *= 2;
+
+		SDL_Vertex *newVertices = realloc(queuedVertices, newCapacity * sizeof(SDL_Vertex));
+
+		if (newVertices == NULL) {
+			printf("ERROR - Render queue could not grow to %d vertices.\n", newCapacity);
+			return NULL;
+		}
+
+		queuedVertices = newVertices;
+		queuedVertexCapacity = newCapacity;
+	}
+
+	RenderCommand *command = addRenderCommand(RCT_VERTICES, layer, texture, blendMode);
+	if (command == NULL)
+		return NULL;
+
+	command->firstVertex = queuedVertexCount;
+	command->quads = quads;
+	queuedVertexCount += quads * 4;
+
+	return &queuedVertices[command->firstVertex];
+}
+
+//checks if a box (in screen coordinates) is entirely offscreen, give or take CULL_MARGIN
+//returns true if whatever's in it shouldn't be drawn, and counts it as culled
+bool cullBounds(float left, float top, float right, float bottom) {
+	if (right < -CULL_MARGIN || bottom < -CULL_MARGIN || left > SCREEN_WIDTH + CULL_MARGIN || top > SCREEN_HEIGHT + CULL_MARGIN) {
+		addToProfilerCounter(PC_CULLED_DRAWS, 1);
+		return true;
+	}
+
+	return false;
+}
+
+//gets a new command at the end of the queue with its sort keys filled in
+//returns NULL if the queue couldn't grow, in which case the command gets dropped
+static RenderCommand *addRenderCommand(RenderCommandType type, RenderLayer layer, SDL_Texture *texture, SDL_BlendMode blendMode) {
+	if (commandCount >= commandCapacity) {
+		int newCapacity = commandCapacity > 0 ? commandCapacity * 2 : QUEUE_START_COMMANDS;
+		RenderCommand *newCommands = realloc(commands, newCapacity * sizeof(RenderCommand));
+
+		if (newCommands == NULL) {
+			printf("ERROR - Render queue could not grow to %d commands.\n", newCapacity);
+			return NULL;
+		}
+
+		commands = newCommands;
+		commandCapacity = newCapacity;
+	}
+
+	RenderCommand *command = &commands[commandCount];
+	command->type = type;
+	command->layer = layer;
+	command->texture = texture;
+	command->blendMode = blendMode;
+	command->order = commandCount;
+	++commandCount;
+
+	return command;
+}
+
+//sorts by layer, then texture, then blend mode, then queue order (or straight from layer to queue order, for layers in KEEP_QUEUE_ORDER)
+static int compareRenderCommands(const void *a, const void *b) {
+	const RenderCommand *commandA = (const RenderCommand *)a;
+	const RenderCommand *commandB = (const RenderCommand *)b;
+
+	if (commandA->layer != commandB->layer)
+		return commandA->layer < commandB->layer ? -1 : 1;
+	if (KEEP_QUEUE_ORDER[commandA->layer])
+		return commandA->order - commandB->order;
+	if (commandA->texture != commandB->texture)
+		return (uintptr_t)commandA->texture < (uintptr_t)commandB->texture ? -1 : 1;
+	if (commandA->blendMode != commandB->blendMode)
+		return commandA->blendMode < commandB->blendMode ? -1 : 1;
+
+	return commandA->order - commandB->order;
+}
+
+//sorts the queue and draws everything in it
+//call before drawing anything straight to the renderer, and before presenting
+void flushRenderQueue(void) {
+	flushGlyphCache();	//glyphs added since the last flush have to be on the texture before anything's drawn with them
+
+	if (commandCount > 1)
+		qsort(commands, commandCount, sizeof(RenderCommand), compareRenderCommands);
+
+	for (int i = 0; i < commandCount; ++i) {
+		RenderCommand *command = &commands[i];
+
+		setRenderBatchBlendMode(command->blendMode);
+
+		switch (command->type) {
+		case(RCT_QUAD):
+			batchQuad(command->texture, &command->src, &command->dest, command->angle, command->hasCenter ? &command->center : NULL, command->flip, command->color);
+			break;
+		case(RCT_FILLED_RECT):
+			batchFilledRect(&command->dest, command->color);
+			break;
+		case(RCT_VERTICES):
+			batchVertices(command->texture, &queuedVertices[command->firstVertex], command->quads);
+			break;
+		}
+	}
+
+	commandCount = 0;
+	queuedVertexCount = 0;
+	flushRenderBatch();
+}
+
+//frees the queue
+void deleteRenderQueue(void) {
+	free(commands);
+	commands = NULL;
+	commandCount = commandCapacity = 0;
+
+	free(queuedVertices);
+	queuedVertices = NULL;
+	queuedVertexCount = queuedVertexCapacity = 0;
+}
@@ -0,0 +1,39 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+/*
+* Draw code queues up render commands here instead of drawing right away.
+* When the queue is flushed, commands get sorted by layer, then by render state (texture and blend mode), then by the order they were queued in,
+* and are sent off to the render batch. This keeps textures and blend modes from flipping back and forth during a frame.
+* On most layers, order is only guaranteed between commands with the same state, so things that need to be drawn over each other should go on different layers.
+* The gameplay and UI layers skip sorting by state and keep the order everything was queued in, since what's on them overlaps and comes from more than one texture
+* (see KEEP_QUEUE_ORDER in renderQueue.c). Neighbouring commands there still batch together when they share a texture.
+* Quads that are entirely offscreen are culled when they're queued.
+*/
+
+//RL stands for render layer
+//layers are drawn from first to last
+typedef enum {
+	RL_BACKGROUND,
+	RL_PARTICLES,
+	RL_CRATES,
+	RL_ENEMIES,
+	RL_BULLETS,
+	RL_PLAYER,
+	RL_OVERLAY,		//full screen effects that go between gameplay and the UI (e.g. darkening the screen when paused)
+	RL_UI,
+	RL_UI_DETAIL,	//things drawn on top of UI sprites (e.g. slider fill)
+	RL_DEBUG,
+	RL_CURSOR,
+
+	RL_MAX
+} RenderLayer;
+
+void queueQuad(RenderLayer layer, SDL_Texture *texture, SDL_BlendMode blendMode, const SDL_Rect *src, const SDL_Rect *dest, float angle, const SDL_Point *center, SDL_RendererFlip flip, SDL_Color color);
+void queueFilledRect(RenderLayer layer, SDL_BlendMode blendMode, const SDL_Rect *rect, SDL_Color color);
+SDL_Vertex *queueVertices(RenderLayer layer, SDL_Texture *texture, SDL_BlendMode blendMode, int quads);
+bool cullBounds(float left, float top, float right, float bottom);
+void flushRenderQueue(void);
+void deleteRenderQueue(void);
+
+#endif
\ No newline at end of file
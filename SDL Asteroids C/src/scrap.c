@@ -1,5 +1,6 @@
 #include "common.h"
 
+#include "colliders.h"
 #include "draw.h"
 #include "geometry.h"
 #include "particles.h"
@@ -18,7 +19,7 @@ static const float SCRAP_MAX_SPD = 5;
 static const int SCRAP_VALUE = 5;
 static const int HORZ_EDGE_DIST = 8;	//screenwrap var
 static const int VERT_EDGE_DIST = 8;	//screenwrap var
-static const float SCRAP_COLLECT_DISTANCE_SQUARED = 25 * 25;	//distance at which a piece of scrap is collected by the player, squared for an optimized calculation
+static const float SCRAP_COLLECT_DISTANCE = 25;	//distance at which a piece of scrap is collected by the player
 
 //scrap collection particle currently not being used b/c isn't just kind of visually noisy
 
@@ -29,7 +30,7 @@ static const float SCRAP_COLLECT_DISTANCE_SQUARED = 25 * 25;	//distance at which
 //	//draw if the animation isn't over yet (using extra frame trick to tell when animation is done)
 //	if (particle->sprite->currentFrame < particle->sprite->frames - 1) {
 //		setTextureRGBA(particle->sprite->atlas->texture, 255, 255, 255, 127);
-//		blitAndUpdateSpriteAnimatedEX(particle->sprite, particle->x, particle->y, particle->angle, NULL, SDL_FLIP_NONE);
+//		blitSpriteAnimatedEX(particle->sprite, particle->x, particle->y, particle->angle, NULL, SDL_FLIP_NONE);
 //		setTextureRGBA(particle->sprite->atlas->texture, 255, 255, 255, 255);
 //	}
 //	else
@@ -38,15 +39,19 @@ static const float SCRAP_COLLECT_DISTANCE_SQUARED = 25 * 25;	//distance at which
 
 //update function for scrap
 static void scrapUpdate(Particle *scrap) {
-	//accelerate towards the player
-	if (player->x < scrap->x)
-		scrap->deltaX = MAX(scrap->deltaX - SCRAP_ACCEL, -SCRAP_MAX_SPD);
-	else
-		scrap->deltaX = MIN(scrap->deltaX + SCRAP_ACCEL, SCRAP_MAX_SPD);
-	if (player->y < scrap->y)
-		scrap->deltaY = MAX(scrap->deltaY - SCRAP_ACCEL, -SCRAP_MAX_SPD);
-	else
-		scrap->deltaY = MIN(scrap->deltaY + SCRAP_ACCEL, SCRAP_MAX_SPD);
+	OBBCollider *target;
+
+	//accelerate towards the nearest (living) player
+	if (queryNearest(LAYER_BIT(CL_PLAYER), (Vector2) { scrap->x, scrap->y }, false, &target, 1) > 0) {
+		if (target->origin.x < scrap->x)
+			scrap->deltaX = MAX(scrap->deltaX - SCRAP_ACCEL, -SCRAP_MAX_SPD);
+		else
+			scrap->deltaX = MIN(scrap->deltaX + SCRAP_ACCEL, SCRAP_MAX_SPD);
+		if (target->origin.y < scrap->y)
+			scrap->deltaY = MAX(scrap->deltaY - SCRAP_ACCEL, -SCRAP_MAX_SPD);
+		else
+			scrap->deltaY = MIN(scrap->deltaY + SCRAP_ACCEL, SCRAP_MAX_SPD);
+	}
 
 	//move scrap
 	scrap->x += scrap->deltaX;
@@ -63,7 +68,8 @@ static void scrapUpdate(Particle *scrap) {
 		scrap->y = -VERT_EDGE_DIST;
 
 	//if close enough to the player, increment score and delete this projectile
-	if (distanceSquared(scrap->x, scrap->y, player->x, player->y) < SCRAP_COLLECT_DISTANCE_SQUARED && player->state != PS_DESTROYED) {
+	//(dead players have their collider switched off, so they won't show up here)
+	if (queryRadius(LAYER_BIT(CL_PLAYER), (Vector2) { scrap->x, scrap->y }, SCRAP_COLLECT_DISTANCE, false, &target, 1) > 0) {
 		stage.score += SCRAP_VALUE;
 
 		//initParticle(initSpriteAnimated(app.gameplaySprites, 16, 21, 1, 1, SC_CENTER, 5, 0, 0.15, AL_ONESHOT), scrap->x, scrap->y, 0, 0, 0, 1, NULL, scrapCollectFlashDraw);
@@ -74,13 +80,15 @@ static void scrapUpdate(Particle *scrap) {
 
 //draw function for scrap
 static void scrapDraw(Particle *scrap) {
-	blitAndUpdateSpriteAnimatedEX(scrap->sprite, scrap->x, scrap->y, scrap->angle, NULL, SDL_FLIP_NONE);
+	blitSpriteAnimatedEX(scrap->sprite, scrap->x, scrap->y, scrap->angle, NULL, SDL_FLIP_NONE);
 }
 
 //initializes a new piece of scrap
 void initScrap(int x, int y) {
-	//initialize particle with a random sprite out of the four
-	initParticle(initSpriteAnimated(app.gameplaySprites, 16, 17 + rand() % 4, 1, 1, SC_CENTER, 4, 0, randFloatRange(0.1, 0.5), AL_LOOP), x, y, 0, 0, randFloat(359.99999999999999), 1, scrapUpdate, scrapDraw);
+	//initialize particle with a random sprite out of the four, spinning at a random speed
+	SpriteAnimated *sprite = initSpriteAnimatedFromTable(SPR_SCRAP_1 + rand() % 4, 0);
+	sprite->spd = randFloatRange(0.1, 0.5);
+	initParticle(sprite, x, y, 0, 0, randFloat(359.99999999999999), 1, scrapUpdate, scrapDraw);
 }
 
 //no destructor needed; since a piece of scrap is a particle, when its ttl is set to 0, it gets deleted by updateParticles when called in the stage update function
\ No newline at end of file
@@ -0,0 +1,470 @@
+#include "common.h"
+
+//SSE2 is always there on x64, and on x86 when it's enabled in the compiler settings
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFT_RASTER_USE_SSE2
+#endif
+
+#include "softRaster.h"
+
+extern App app;
+
+//max number of textures that can have a copy of their pixels kept for the rasterizer
+#define MAX_SOFT_RASTER_TEXTURES 8
+//max number of threads the framebuffer gets split between
+#define MAX_SOFT_RASTER_THREADS 8
+
+//a CPU copy of a texture's pixels
+typedef struct {
+	SDL_Texture *texture;
+	SDL_Surface *pixels;	//always RGBA32
+} SoftRasterTexture;
+
+//a thread that draws one band of rows of the framebuffer
+typedef struct {
+	SDL_Thread *thread;
+	SDL_sem *start;		//posted when there's a batch to draw
+	int top;
+	int bottom;			//not included
+} SoftRasterWorker;
+
+//the batch currently being drawn
+typedef struct {
+	const SDL_Surface *texture;	//NULL for solid color quads
+	SDL_BlendMode blendMode;
+	const SDL_Vertex *vertices;
+	int quads;
+} SoftRasterJob;
+
+//everything about one quad that stays the same from pixel to pixel
+//(a, b) is where a pixel is inside the quad: (0, 0) at the top left corner, (1, 0) at the top right and (0, 1) at the bottom left
+typedef struct {
+	int left, right, top, bottom;		//bounding box in pixels, clipped (right and bottom not included)
+	float originX, originY;				//top left corner
+	float dadx, dady, dbdx, dbdy;
+	float texU, texUA, texUB;			//texture coordinates in texels are tex + texA * a + texB * b
+	float texV, texVA, texVB;
+	SDL_Color color;
+} QuadSetup;
+
+bool initSoftRaster(SDL_Surface *target);
+const RenderBackend *getSoftRasterBackend(void);
+void registerSoftRasterTexture(SDL_Texture *texture, SDL_Surface *surface);
+void unregisterSoftRasterTexture(SDL_Texture *texture);
+static const SDL_Surface *getSoftRasterTexture(SDL_Texture *texture);
+static void softRasterQuads(SDL_Texture *texture, SDL_BlendMode blendMode, const SDL_Vertex *vertices, const int *indices, int quads);
+static int softRasterWorker(void *data);
+static void rasterQuads(const SoftRasterJob *rasterJob, int top, int bottom);
+static bool setUpQuad(QuadSetup *quad, const SoftRasterJob *rasterJob, const SDL_Vertex *v, int top, int bottom);
+static void rasterRow(const SoftRasterJob *rasterJob, const QuadSetup *quad, int y);
+#ifdef SOFT_RASTER_USE_SSE2
+static int rasterRowBlendSSE2(const SoftRasterJob *rasterJob, const QuadSetup *quad, Uint8 *row, float a, float b);
+static __m128i div255SSE2(__m128i x);
+#endif
+static const Uint8 *getTexel(const SDL_Surface *texture, float u, float v);
+static void blendPixel(Uint8 *dst, const Uint8 *src, SDL_Color color, SDL_BlendMode blendMode);
+static int div255(int x);
+void deleteSoftRaster(void);
+
+static const int MIN_QUADS_PER_THREADED_BATCH = 16;	//smaller batches aren't worth waking the other threads up for
+static const Uint8 WHITE_TEXEL[4] = { 255, 255, 255, 255 };	//what solid color quads get "sampled" from
+
+static const RenderBackend SOFT_RASTER_BACKEND = { softRasterQuads };
+
+static SDL_Surface *framebuffer = NULL;
+
+static SoftRasterTexture textures[MAX_SOFT_RASTER_TEXTURES];
+static int textureCount = 0;
+
+static SoftRasterWorker workers[MAX_SOFT_RASTER_THREADS];
+static int workerCount = 0;		//0 if everything is drawn on the main thread
+static SDL_sem *jobDone = NULL;	//posted by each worker when it's done with its band
+static SoftRasterJob job;
+static bool workersQuit = false;
+
+//sets the rasterizer up to draw into target, which should be the surface a software renderer was made for
+//target has to be RGBA32
+bool initSoftRaster(SDL_Surface *target) {
+	if (target->format->format != SDL_PIXELFORMAT_RGBA32) {
+		printf("ERROR - Software rasterizer can only draw into RGBA32 surfaces.\n");
+		return false;
+	}
+
+	framebuffer = target;
+	workersQuit = false;
+
+	//one band per core
+	int threads = MIN(SDL_GetCPUCount(), MAX_SOFT_RASTER_THREADS);
+	if (threads <= 1)
+		return true;
+
+	jobDone = SDL_CreateSemaphore(0);
+	if (jobDone == NULL) {
+		printf("WARNING - Software rasterizer will only use one thread: %s\n", SDL_GetError());
+		return true;
+	}
+
+	for (int i = 0; i < threads; ++i) {
+		SoftRasterWorker *worker = &workers[workerCount];
+		worker->top = framebuffer->h * i / threads;
+		worker->bottom = framebuffer->h * (i + 1) / threads;
+		worker->start = SDL_CreateSemaphore(0);
+		worker->thread = worker->start != NULL ? SDL_CreateThread(softRasterWorker, "softRaster", worker) : NULL;
+
+		if (worker->thread == NULL) {
+			printf("WARNING - Software rasterizer thread could not be created: %s\n", SDL_GetError());
+			if (worker->start != NULL)
+				SDL_DestroySemaphore(worker->start);
+			break;
+		}
+
+		++workerCount;
+	}
+
+	//bands were worked out for every thread; if some didn't start, stretch the last one that did
+	if (workerCount > 0)
+		workers[workerCount - 1].bottom = framebuffer->h;
+
+	return true;
+}
+
+//pass this to setRenderBackend
+const RenderBackend *getSoftRasterBackend(void) {
+	return &SOFT_RASTER_BACKEND;
+}
+
+//keeps a copy of the pixels a texture was made from, so the rasterizer can draw it
+void registerSoftRasterTexture(SDL_Texture *texture, SDL_Surface *surface) {
+	if (textureCount >= MAX_SOFT_RASTER_TEXTURES) {
+		printf("WARNING - Out of room for software rasterizer textures. Raise MAX_SOFT_RASTER_TEXTURES.\n");
+		return;
+	}
+
+	SDL_Surface *pixels = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+	if (pixels == NULL) {
+		printf("WARNING - Texture could not be copied for the software rasterizer: %s\n", SDL_GetError());
+		return;
+	}
+
+	textures[textureCount].texture = texture;
+	textures[textureCount].pixels = pixels;
+	++textureCount;
+}
+
+//drops the copy of a texture's pixels; call before destroying the texture
+void unregisterSoftRasterTexture(SDL_Texture *texture) {
+	for (int i = 0; i < textureCount; ++i) {
+		if (textures[i].texture == texture) {
+			SDL_FreeSurface(textures[i].pixels);
+			textures[i] = textures[--textureCount];
+			return;
+		}
+	}
+}
+
+//returns NULL if the texture isn't registered
+static const SDL_Surface *getSoftRasterTexture(SDL_Texture *texture) {
+	for (int i = 0; i < textureCount; ++i) {
+		if (textures[i].texture == texture)
+			return textures[i].pixels;
+	}
+
+	return NULL;
+}
+
+//the backend's draw function
+//vertex colors are taken from each quad's first vertex, since the render queue never gives the corners of a quad different colors
+static void softRasterQuads(SDL_Texture *texture, SDL_BlendMode blendMode, const SDL_Vertex *vertices, const int *indices, int quads) {
+	const SDL_Surface *pixels = texture != NULL ? getSoftRasterTexture(texture) : NULL;
+
+	//anything that isn't going straight into the framebuffer, or comes from a texture without a copy of its pixels, is drawn by SDL instead
+	if (framebuffer == NULL || SDL_GetRenderTarget(app.renderer) != NULL || (texture != NULL && pixels == NULL)) {
+		getSDLRenderBackend()->drawQuads(texture, blendMode, vertices, indices, quads);
+		return;
+	}
+
+	//SDL might still be holding onto things drawn before this batch, and they have to land in the framebuffer first
+	SDL_RenderFlush(app.renderer);
+
+	if (SDL_MUSTLOCK(framebuffer))
+		SDL_LockSurface(framebuffer);
+
+	job.texture = pixels;
+	job.blendMode = blendMode;
+	job.vertices = vertices;
+	job.quads = quads;
+
+	if (workerCount > 0 && quads >= MIN_QUADS_PER_THREADED_BATCH) {
+		for (int i = 0; i < workerCount; ++i)
+			SDL_SemPost(workers[i].start);
+		for (int i = 0; i < workerCount; ++i)
+			SDL_SemWait(jobDone);
+	}
+	else
+		rasterQuads(&job, 0, framebuffer->h);
+
+	if (SDL_MUSTLOCK(framebuffer))
+		SDL_UnlockSurface(framebuffer);
+}
+
+//waits for batches and draws its band of each one
+//every pixel is only ever drawn by one thread, in the same order as on one thread, so output doesn't depend on the number of threads
+static int softRasterWorker(void *data) {
+	SoftRasterWorker *worker = data;
+
+	while (true) {
+		SDL_SemWait(worker->start);
+		if (workersQuit)
+			return 0;
+
+		rasterQuads(&job, worker->top, worker->bottom);
+		SDL_SemPost(jobDone);
+	}
+}
+
+//draws the rows of a batch between top and bottom (not included)
+static void rasterQuads(const SoftRasterJob *rasterJob, int top, int bottom) {
+	QuadSetup quad;
+
+	for (int i = 0; i < rasterJob->quads; ++i) {
+		if (!setUpQuad(&quad, rasterJob, &rasterJob->vertices[i * 4], top, bottom))
+			continue;
+
+		for (int y = quad.top; y < quad.bottom; ++y)
+			rasterRow(rasterJob, &quad, y);
+	}
+}
+
+//works out a quad's bounding box and how to find a pixel's spot inside it
+//every quad the render queue makes is a parallelogram (a rectangle, maybe rotated), so 2 of its edges are enough
+//returns false if there's nothing to draw between top and bottom
+static bool setUpQuad(QuadSetup *quad, const SoftRasterJob *rasterJob, const SDL_Vertex *v, int top, int bottom) {
+	float minX = MIN(MIN(v[0].position.x, v[1].position.x), MIN(v[2].position.x, v[3].position.x));
+	float maxX = MAX(MAX(v[0].position.x, v[1].position.x), MAX(v[2].position.x, v[3].position.x));
+	float minY = MIN(MIN(v[0].position.y, v[1].position.y), MIN(v[2].position.y, v[3].position.y));
+	float maxY = MAX(MAX(v[0].position.y, v[1].position.y), MAX(v[2].position.y, v[3].position.y));
+
+	quad->left = MAX(0, (int)floor(minX));
+	quad->right = MIN(framebuffer->w, (int)ceil(maxX));
+	quad->top = MAX(top, (int)floor(minY));
+	quad->bottom = MIN(bottom, (int)ceil(maxY));
+
+	if (quad->left >= quad->right || quad->top >= quad->bottom)
+		return false;
+
+	float edgeAX = v[1].position.x - v[0].position.x, edgeAY = v[1].position.y - v[0].position.y;	//top edge
+	float edgeBX = v[3].position.x - v[0].position.x, edgeBY = v[3].position.y - v[0].position.y;	//left edge
+	float det = edgeAX * edgeBY - edgeAY * edgeBX;
+
+	if (fabs(det) < 0.0001)
+		return false;
+
+	quad->originX = v[0].position.x;
+	quad->originY = v[0].position.y;
+	quad->dadx = edgeBY / det;
+	quad->dady = -edgeBX / det;
+	quad->dbdx = -edgeAY / det;
+	quad->dbdy = edgeAX / det;
+
+	if (rasterJob->texture != NULL) {
+		float w = rasterJob->texture->w, h = rasterJob->texture->h;
+		quad->texU = v[0].tex_coord.x * w;
+		quad->texUA = (v[1].tex_coord.x - v[0].tex_coord.x) * w;
+		quad->texUB = (v[3].tex_coord.x - v[0].tex_coord.x) * w;
+		quad->texV = v[0].tex_coord.y * h;
+		quad->texVA = (v[1].tex_coord.y - v[0].tex_coord.y) * h;
+		quad->texVB = (v[3].tex_coord.y - v[0].tex_coord.y) * h;
+	} else {
+		//never sampled, but zeroed so nothing reads garbage
+		quad->texU = quad->texUA = quad->texUB = 0;
+		quad->texV = quad->texVA = quad->texVB = 0;
+	}
+
+	quad->color = v[0].color;
+
+	return true;
+}
+
+//draws one row of a quad
+//pixels are sampled at their centers; a pixel is in the quad if 0 <= a < 1 and 0 <= b < 1, so quads that share an edge don't both draw it
+static void rasterRow(const SoftRasterJob *rasterJob, const QuadSetup *quad, int y) {
+	Uint8 *row = (Uint8 *)framebuffer->pixels + y * framebuffer->pitch;
+	float dx = quad->left + 0.5 - quad->originX;
+	float dy = y + 0.5 - quad->originY;
+	float a = dx * quad->dadx + dy * quad->dady;	//at the left edge of the bounding box
+	float b = dx * quad->dbdx + dy * quad->dbdy;
+	int x = quad->left;
+
+#ifdef SOFT_RASTER_USE_SSE2
+	//normal blending is what nearly everything uses, so that's the one that gets sped up
+	if (rasterJob->blendMode == SDL_BLENDMODE_BLEND)
+		x = rasterRowBlendSSE2(rasterJob, quad, row, a, b);
+#endif
+
+	for (; x < quad->right; ++x) {
+		float i = x - quad->left;
+		float pixelA = a + i * quad->dadx;
+		float pixelB = b + i * quad->dbdx;
+
+		if (pixelA < 0 || pixelA >= 1 || pixelB < 0 || pixelB >= 1)
+			continue;
+
+		const Uint8 *src = WHITE_TEXEL;
+		if (rasterJob->texture != NULL)
+			src = getTexel(rasterJob->texture, quad->texU + pixelA * quad->texUA + pixelB * quad->texUB, quad->texV + pixelA * quad->texVA + pixelB * quad->texVB);
+
+		blendPixel(row + x * 4, src, quad->color, rasterJob->blendMode);
+	}
+}
+
+#ifdef SOFT_RASTER_USE_SSE2
+//draws a row 4 pixels at a time with normal blending, doing the same math as blendPixel (so the results match exactly)
+//stops before it would go past the right edge of the framebuffer, and returns where it stopped so the rest can be done one pixel at a time
+static int rasterRowBlendSSE2(const SoftRasterJob *rasterJob, const QuadSetup *quad, Uint8 *row, float a, float b) {
+	const __m128 zero4 = _mm_setzero_ps();
+	const __m128 one4 = _mm_set1_ps(1);
+	const __m128 lanes4 = _mm_setr_ps(0, 1, 2, 3);
+	const __m128 right4 = _mm_set1_ps((float)(quad->right - quad->left));
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i max16 = _mm_set1_epi16(255);
+	const __m128i color16 = _mm_setr_epi16(quad->color.r, quad->color.g, quad->color.b, quad->color.a, quad->color.r, quad->color.g, quad->color.b, quad->color.a);
+	const __m128i rgbMask16 = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+	const __m128i alphaLane16 = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+	int x = quad->left;
+
+	for (; x + 3 < framebuffer->w && x < quad->right; x += 4) {
+		__m128 i4 = _mm_add_ps(_mm_set1_ps((float)(x - quad->left)), lanes4);
+		__m128 a4 = _mm_add_ps(_mm_set1_ps(a), _mm_mul_ps(i4, _mm_set1_ps(quad->dadx)));
+		__m128 b4 = _mm_add_ps(_mm_set1_ps(b), _mm_mul_ps(i4, _mm_set1_ps(quad->dbdx)));
+
+		__m128 inside = _mm_and_ps(_mm_cmpge_ps(a4, zero4), _mm_cmplt_ps(a4, one4));
+		inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmpge_ps(b4, zero4), _mm_cmplt_ps(b4, one4)));
+		inside = _mm_and_ps(inside, _mm_cmplt_ps(i4, right4));
+
+		int insideBits = _mm_movemask_ps(inside);
+		if (insideBits == 0)
+			continue;
+
+		//sample (a gather, so this part is one pixel at a time)
+		Uint32 texels[4];
+		float a1[4], b1[4];
+		_mm_storeu_ps(a1, a4);
+		_mm_storeu_ps(b1, b4);
+		for (int i = 0; i < 4; ++i) {
+			const Uint8 *src = WHITE_TEXEL;
+			if ((insideBits & (1 << i)) && rasterJob->texture != NULL)
+				src = getTexel(rasterJob->texture, quad->texU + a1[i] * quad->texUA + b1[i] * quad->texUB, quad->texV + a1[i] * quad->texVA + b1[i] * quad->texVB);
+			memcpy(&texels[i], src, 4);
+		}
+
+		__m128i src = _mm_loadu_si128((const __m128i *)texels);
+		__m128i dst = _mm_loadu_si128((const __m128i *)(row + x * 4));
+
+		//2 pixels per register, one channel per 16-bit lane
+		__m128i srcLo = div255SSE2(_mm_mullo_epi16(_mm_unpacklo_epi8(src, zero), color16));
+		__m128i srcHi = div255SSE2(_mm_mullo_epi16(_mm_unpackhi_epi8(src, zero), color16));
+		__m128i dstLo = _mm_unpacklo_epi8(dst, zero);
+		__m128i dstHi = _mm_unpackhi_epi8(dst, zero);
+
+		//each pixel's source alpha copied into all of its lanes
+		__m128i alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(srcLo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		__m128i alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(srcHi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+		//color = src * srcAlpha + dst * (1 - srcAlpha), alpha = srcAlpha + dstAlpha * (1 - srcAlpha)
+		//(these top out at 255 * 255, which still fits in an unsigned 16-bit lane)
+		__m128i factorLo = _mm_or_si128(_mm_and_si128(alphaLo, rgbMask16), alphaLane16);
+		__m128i factorHi = _mm_or_si128(_mm_and_si128(alphaHi, rgbMask16), alphaLane16);
+		__m128i outLo = div255SSE2(_mm_add_epi16(_mm_mullo_epi16(srcLo, factorLo), _mm_mullo_epi16(dstLo, _mm_sub_epi16(max16, alphaLo))));
+		__m128i outHi = div255SSE2(_mm_add_epi16(_mm_mullo_epi16(srcHi, factorHi), _mm_mullo_epi16(dstHi, _mm_sub_epi16(max16, alphaHi))));
+		__m128i out = _mm_packus_epi16(outLo, outHi);
+
+		//only write pixels that are inside the quad
+		__m128i mask = _mm_castps_si128(inside);
+		out = _mm_or_si128(_mm_and_si128(mask, out), _mm_andnot_si128(mask, dst));
+		_mm_storeu_si128((__m128i *)(row + x * 4), out);
+	}
+
+	return x;
+}
+
+//divides every unsigned 16-bit lane by 255, rounded (same as div255)
+static __m128i div255SSE2(__m128i x) {
+	x = _mm_add_epi16(x, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+#endif
+
+//nearest-neighbour sample at texel coordinates (u, v), clamped to the edges of the texture
+static const Uint8 *getTexel(const SDL_Surface *texture, float u, float v) {
+	int x = (int)floor(u);
+	int y = (int)floor(v);
+	x = MAX(0, MIN(x, texture->w - 1));
+	y = MAX(0, MIN(y, texture->h - 1));
+
+	return (const Uint8 *)texture->pixels + y * texture->pitch + x * 4;
+}
+
+//modulates a source pixel by color, then blends it into dst the same way SDL does for each blend mode
+//both pixels are RGBA32 (bytes in R, G, B, A order)
+static void blendPixel(Uint8 *dst, const Uint8 *src, SDL_Color color, SDL_BlendMode blendMode) {
+	int r = div255(src[0] * color.r);
+	int g = div255(src[1] * color.g);
+	int b = div255(src[2] * color.b);
+	int a = div255(src[3] * color.a);
+
+	switch (blendMode) {
+	case(SDL_BLENDMODE_NONE):
+		dst[0] = r;
+		dst[1] = g;
+		dst[2] = b;
+		dst[3] = a;
+		break;
+	case(SDL_BLENDMODE_ADD):
+		dst[0] = MIN(255, dst[0] + div255(r * a));
+		dst[1] = MIN(255, dst[1] + div255(g * a));
+		dst[2] = MIN(255, dst[2] + div255(b * a));
+		break;
+	case(SDL_BLENDMODE_MOD):
+		dst[0] = div255(r * dst[0]);
+		dst[1] = div255(g * dst[1]);
+		dst[2] = div255(b * dst[2]);
+		break;
+	default:
+		//SDL_BLENDMODE_BLEND (and anything that's only used with target textures, which never get here)
+		dst[0] = div255(r * a + dst[0] * (255 - a));
+		dst[1] = div255(g * a + dst[1] * (255 - a));
+		dst[2] = div255(b * a + dst[2] * (255 - a));
+		dst[3] = div255(a * 255 + dst[3] * (255 - a));
+		break;
+	}
+}
+
+//x / 255, rounded, for 0 <= x <= 255 * 255
+static int div255(int x) {
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+//stops the worker threads and frees every texture copy
+//the framebuffer belongs to whoever passed it in
+void deleteSoftRaster(void) {
+	workersQuit = true;
+	for (int i = 0; i < workerCount; ++i)
+		SDL_SemPost(workers[i].start);
+	for (int i = 0; i < workerCount; ++i) {
+		SDL_WaitThread(workers[i].thread, NULL);
+		SDL_DestroySemaphore(workers[i].start);
+	}
+	workerCount = 0;
+
+	if (jobDone != NULL)
+		SDL_DestroySemaphore(jobDone);
+	jobDone = NULL;
+
+	for (int i = 0; i < textureCount; ++i)
+		SDL_FreeSurface(textures[i].pixels);
+	textureCount = 0;
+
+	framebuffer = NULL;
+}
\ No newline at end of file
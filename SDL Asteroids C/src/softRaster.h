@@ -0,0 +1,20 @@
+#ifndef SOFT_RASTER_H
+#define SOFT_RASTER_H
+
+#include "renderBatch.h"
+
+/*
+* A CPU rasterizer for render batches, used when running headless (see main.c).
+* It draws straight into the surface that SDL's software renderer is drawing into, so no GPU is needed, and output is the same on every machine.
+* Quads are nearest-neighbour sampled, color modulated and blended 4 pixels at a time with SSE2 (when it's available),
+* and the framebuffer is split into bands of rows that get drawn on separate threads.
+* Only textures registered here can be drawn by it; anything else (e.g. target textures) is handed back to SDL's software renderer.
+*/
+
+bool initSoftRaster(SDL_Surface *target);
+const RenderBackend *getSoftRasterBackend(void);
+void registerSoftRasterTexture(SDL_Texture *texture, SDL_Surface *surface);
+void unregisterSoftRasterTexture(SDL_Texture *texture);
+void deleteSoftRaster(void);
+
+#endif
\ No newline at end of file
@@ -6,7 +6,7 @@
 
 extern App app;
 
-static void loadSounds(void);
+void loadSound(Sound id);
 
 //constants for adjusting the volumes and music and sound relative to each other
 //a very primitive form of mixing
@@ -19,40 +19,43 @@ static const float MUSIC_VOL_ADJUST = 0.4;
 static Mix_Chunk *sounds[SFX_MAX];
 static Mix_Music *music;			//pointer to the currently loaded music track
 
-//initializes and loads sounds
+//sound files, in the same order as the Sound enum
+static const char *SOUND_FILES[SFX_MAX] = {
+	//gameplay sounds
+	"sound/gameplay/AC_SFX_Enemy_Hit.ogg",
+	"sound/gameplay/AC_SFX_Kill_Enemy.ogg",
+	"sound/gameplay/AC_SFX_Player_Hit.ogg",
+	"sound/gameplay/AC_SFX_Kill_Player.ogg",
+	"sound/gameplay/AC_SFX_Power_Up.ogg",
+	"sound/gameplay/AC_SFX_Shot_Fire_1.ogg",
+	"sound/gameplay/AC_SFX_Shot_Fire_2.ogg",
+	"sound/gameplay/AC_SFX_Shot_Fire_3.ogg",
+	"sound/gameplay/AC_SFX_Shot_Fire_4.ogg",
+	"sound/gameplay/AC_SFX_Shot_Fire_5.ogg",
+	//ui sounds
+	"sound/ui/AC_SFX_Accept.ogg",
+	"sound/ui/AC_SFX_Big_Accept.ogg",
+	"sound/ui/AC_SFX_Click.ogg",
+	"sound/ui/AC_SFX_Decline.ogg"
+};
+
+//initializes sounds
+//the sounds themselves are loaded separately with loadSound (see loading.c), so call setSoundVolume once they're all in
 void initSounds(void) {
 	//NULL the sound pointers
 	memset(sounds, 0, sizeof(Mix_Chunk*) * SFX_MAX);
 
 	//NULL the music pointer
 	music = NULL;
-
-	//load sounds into the array
-	loadSounds();
-
-	//set volume of sounds according to user preferences
-	setSoundVolume(app.preferences.soundVolume);
 }
 
-//put all this tedious code in a function so i don't have to look at it
-//NOTE: make a wrapper for Mix_LoadWav() that outputs a warning message when an audio file isn't found
-static void loadSounds(void) {
-	//gameplay sounds
-	sounds[SFX_ENEMY_HIT] = Mix_LoadWAV("sound/gameplay/AC_SFX_Enemy_Hit.ogg");
-	sounds[SFX_ENEMY_KILL] = Mix_LoadWAV("sound/gameplay/AC_SFX_Kill_Enemy.ogg");
-	sounds[SFX_PLAYER_HIT] = Mix_LoadWAV("sound/gameplay/AC_SFX_Player_Hit.ogg");
-	sounds[SFX_PLAYER_KILL] = Mix_LoadWAV("sound/gameplay/AC_SFX_Kill_Player.ogg");
-	sounds[SFX_POWER_UP] = Mix_LoadWAV("sound/gameplay/AC_SFX_Power_Up.ogg");
-	sounds[SFX_SHOT_FIRE_1] = Mix_LoadWAV("sound/gameplay/AC_SFX_Shot_Fire_1.ogg");
-	sounds[SFX_SHOT_FIRE_2] = Mix_LoadWAV("sound/gameplay/AC_SFX_Shot_Fire_2.ogg");
-	sounds[SFX_SHOT_FIRE_3] = Mix_LoadWAV("sound/gameplay/AC_SFX_Shot_Fire_3.ogg");
-	sounds[SFX_SHOT_FIRE_4] = Mix_LoadWAV("sound/gameplay/AC_SFX_Shot_Fire_4.ogg");
-	sounds[SFX_SHOT_FIRE_5] = Mix_LoadWAV("sound/gameplay/AC_SFX_Shot_Fire_5.ogg");
-	//ui sounds
-	sounds[SFX_ACCEPT] = Mix_LoadWAV("sound/ui/AC_SFX_Accept.ogg");
-	sounds[SFX_BIG_ACCEPT] = Mix_LoadWAV("sound/ui/AC_SFX_Big_Accept.ogg");
-	sounds[SFX_CLICK] = Mix_LoadWAV("sound/ui/AC_SFX_Click.ogg");
-	sounds[SFX_DECLINE] = Mix_LoadWAV("sound/ui/AC_SFX_Decline.ogg");
+//decodes one sound into the array
+//safe to call from another thread, as long as nothing plays that sound until this returns
+void loadSound(Sound id) {
+	sounds[id] = Mix_LoadWAV(SOUND_FILES[id]);
+
+	if (sounds[id] == NULL)
+		printf("WARNING - Sound '%s' could not be loaded: %s\n", SOUND_FILES[id], Mix_GetError());
 }
 
 //loads the music file referred to with "filename".
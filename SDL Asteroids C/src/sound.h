@@ -43,6 +43,7 @@ typedef enum {
 } Sound;
 
 void initSounds(void);
+void loadSound(Sound id);
 void loadMusic(char *filename);
 void playMusic(bool loop);
 void setMusicVolume(int volume);
@@ -0,0 +1,109 @@
+//generated by tools/atlasPacker.c from tools/atlasSprites.json
+//don't edit this by hand; change the sprite list or the source sheet and rerun the packer instead
+
+#ifndef SPRITE_TABLE_H
+#define SPRITE_TABLE_H
+
+#define SPRITE_TABLE_ATLAS "gfx/gameplayAtlas.png"	//every sprite in the table is on this atlas
+
+//SPR stands for sprite
+typedef enum {
+	SPR_CRATE_LARGE,
+	SPR_CRATE_LARGE_HITFLASH,
+	SPR_CRATE_MEDIUM,
+	SPR_CRATE_MEDIUM_HITFLASH,
+	SPR_CRATE_SMALL,
+	SPR_CRATE_SMALL_HITFLASH,
+	SPR_ENEMY,
+	SPR_ENEMY_HITFLASH,
+	SPR_PLANET,
+	SPR_PLAYER_SHIP,
+	SPR_POWERUP_FLASH,
+	SPR_POWERUP_LETTER_N,
+	SPR_POWERUP_LETTER_E,
+	SPR_POWERUP_LETTER_B,
+	SPR_POWERUP_LETTER_S,
+	SPR_POWERUP_CELL,
+	SPR_POWERUP_SHINE,
+	SPR_POWERUP_SHOCKWAVE,
+	SPR_EXPLOSION,
+	SPR_BULLET_NORMAL,
+	SPR_IMPACT_NORMAL,
+	SPR_MUZZLE_FLASH_NORMAL,
+	SPR_BULLET_ERRATIC,
+	SPR_IMPACT_ERRATIC,
+	SPR_MUZZLE_FLASH_ERRATIC,
+	SPR_BULLET_BOUNCER,
+	SPR_IMPACT_BOUNCER,
+	SPR_MUZZLE_FLASH_BOUNCER,
+	SPR_BULLET_SHOTGUN,
+	SPR_IMPACT_SHOTGUN,
+	SPR_MUZZLE_FLASH_SHOTGUN,
+	SPR_BULLET_ENEMY,
+	SPR_IMPACT_ENEMY,
+	SPR_MUZZLE_FLASH_ENEMY,
+	SPR_FLAME,
+	SPR_SCRAP_1,
+	SPR_SCRAP_2,
+	SPR_SCRAP_3,
+	SPR_SCRAP_4,
+	SPR_STAR_1,
+	SPR_STAR_2,
+	SPR_STAR_3,
+	SPR_STAR_4,
+	SPR_STAR_5,
+	SPR_STAR_6,
+
+	SPR_MAX
+} SpriteId;
+
+//x, y, w, h, pivotX, pivotY, frames, spd, loopBehavior
+static const SpriteDef SPRITE_TABLE[SPR_MAX] = {
+	[SPR_CRATE_LARGE] = { 403, 1, 60, 60, 30, 30, 1, 0, AL_ONESHOT },
+	[SPR_CRATE_LARGE_HITFLASH] = { 1, 82, 60, 60, 30, 30, 1, 0, AL_ONESHOT },
+	[SPR_CRATE_MEDIUM] = { 262, 82, 46, 46, 23, 23, 1, 0, AL_ONESHOT },
+	[SPR_CRATE_MEDIUM_HITFLASH] = { 309, 82, 46, 46, 23, 23, 1, 0, AL_ONESHOT },
+	[SPR_CRATE_SMALL] = { 323, 143, 30, 30, 15, 15, 1, 0, AL_ONESHOT },
+	[SPR_CRATE_SMALL_HITFLASH] = { 354, 143, 30, 30, 15, 15, 1, 0, AL_ONESHOT },
+	[SPR_ENEMY] = { 62, 82, 50, 48, 25, 24, 1, 0, AL_ONESHOT },
+	[SPR_ENEMY_HITFLASH] = { 113, 82, 50, 48, 25, 24, 1, 0, AL_ONESHOT },
+	[SPR_PLANET] = { 1, 1, 80, 80, 40, 40, 1, 0, AL_ONESHOT },
+	[SPR_PLAYER_SHIP] = { 164, 82, 48, 48, 24, 24, 1, 0, AL_ONESHOT },
+	[SPR_POWERUP_FLASH] = { 213, 82, 48, 48, 24, 24, 1, 0, AL_ONESHOT },
+	[SPR_POWERUP_LETTER_N] = { 385, 143, 30, 28, 15, 14, 1, 0, AL_ONESHOT },
+	[SPR_POWERUP_LETTER_E] = { 416, 143, 30, 28, 15, 14, 1, 0, AL_ONESHOT },
+	[SPR_POWERUP_LETTER_B] = { 447, 143, 30, 28, 15, 14, 1, 0, AL_ONESHOT },
+	[SPR_POWERUP_LETTER_S] = { 478, 143, 30, 28, 15, 14, 1, 0, AL_ONESHOT },
+	[SPR_POWERUP_CELL] = { 1, 176, 30, 28, 15, 14, 1, 0, AL_ONESHOT },
+	[SPR_POWERUP_SHINE] = { 32, 176, 30, 28, 15, 14, 1, 0, AL_ONESHOT },
+	[SPR_POWERUP_SHOCKWAVE] = { 1, 143, 32, 32, 32, 32, 5, 0.2, AL_ONESHOT },
+	[SPR_EXPLOSION] = { 82, 1, 64, 64, 32, 32, 5, 0.3, AL_ONESHOT },
+	[SPR_BULLET_NORMAL] = { 1, 239, 32, 12, 16, 6, 4, 0.25, AL_LOOP },
+	[SPR_IMPACT_NORMAL] = { 130, 239, 16, 12, 8, 6, 4, 0.25, AL_ONESHOT },
+	[SPR_MUZZLE_FLASH_NORMAL] = { 321, 176, 16, 16, 8, 8, 5, 0.5, AL_ONESHOT },
+	[SPR_BULLET_ERRATIC] = { 391, 222, 14, 14, 7, 7, 4, 0.5, AL_LOOP },
+	[SPR_IMPACT_ERRATIC] = { 402, 176, 16, 16, 8, 8, 5, 0.25, AL_ONESHOT },
+	[SPR_MUZZLE_FLASH_ERRATIC] = { 1, 205, 16, 16, 8, 8, 5, 0.5, AL_ONESHOT },
+	[SPR_BULLET_BOUNCER] = { 63, 176, 32, 16, 16, 8, 4, 0.25, AL_LOOP },
+	[SPR_IMPACT_BOUNCER] = { 244, 205, 16, 16, 8, 8, 4, 0.25, AL_ONESHOT },
+	[SPR_MUZZLE_FLASH_BOUNCER] = { 82, 205, 16, 16, 8, 8, 5, 0.5, AL_ONESHOT },
+	[SPR_BULLET_SHOTGUN] = { 195, 239, 16, 12, 8, 6, 4, 0.25, AL_LOOP },
+	[SPR_IMPACT_SHOTGUN] = { 309, 205, 16, 16, 8, 8, 4, 0.25, AL_ONESHOT },
+	[SPR_MUZZLE_FLASH_SHOTGUN] = { 163, 205, 16, 16, 8, 8, 5, 0.5, AL_ONESHOT },
+	[SPR_BULLET_ENEMY] = { 192, 176, 32, 16, 16, 8, 4, 0.25, AL_LOOP },
+	[SPR_IMPACT_ENEMY] = { 374, 205, 16, 16, 8, 8, 4, 0.25, AL_ONESHOT },
+	[SPR_MUZZLE_FLASH_ENEMY] = { 162, 143, 32, 32, 16, 16, 5, 0.2, AL_ONESHOT },
+	[SPR_FLAME] = { 309, 239, 16, 10, 8, 5, 4, 0.25, AL_LOOP },
+	[SPR_SCRAP_1] = { 448, 222, 14, 14, 7, 7, 4, 0.25, AL_LOOP },
+	[SPR_SCRAP_2] = { 374, 239, 10, 10, 5, 5, 4, 0.25, AL_LOOP },
+	[SPR_SCRAP_3] = { 439, 205, 16, 16, 8, 8, 4, 0.25, AL_LOOP },
+	[SPR_SCRAP_4] = { 260, 239, 12, 12, 6, 6, 4, 0.25, AL_LOOP },
+	[SPR_STAR_1] = { 1, 222, 16, 16, 8, 8, 4, 0, AL_ONESHOT },
+	[SPR_STAR_2] = { 66, 222, 16, 16, 8, 8, 4, 0, AL_ONESHOT },
+	[SPR_STAR_3] = { 131, 222, 16, 16, 8, 8, 4, 0, AL_ONESHOT },
+	[SPR_STAR_4] = { 196, 222, 16, 16, 8, 8, 4, 0, AL_ONESHOT },
+	[SPR_STAR_5] = { 261, 222, 16, 16, 8, 8, 4, 0, AL_ONESHOT },
+	[SPR_STAR_6] = { 326, 222, 16, 16, 8, 8, 4, 0, AL_ONESHOT },
+};
+
+#endif
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "common.h"
 
 #include "background.h"
+#include "bullets.h"
 #include "./json/cJSON.h"
+#include "colliders.h"
+#include "composites.h"
 #include "enemies.h"
 #include "highscores.h"
 #include "input.h"
@@ -40,6 +43,7 @@ static const int GO_TO_HIGHSCORES = FPS * 3;	//start stage after brief period of
 static int stageStartTimer = 0;		//timer that gives a pause before the stage begins
 static int highscoreTimer = 0;		//timer that gives a pause between game over and going to the highscore screens
 static bool drawQuitPromptText = false;	//bool for a hack to get prompt text for when the user wants to quit when on the pause menu
+static RenderCache pauseBackdrop;	//the gameplay scene as it was when the game got paused (the background isn't included, since its stars keep twinkling)
 
 void initStage(void) {
 	//initialize/reset stage
@@ -66,6 +70,8 @@ void initStage(void) {
 
 	initPlayer(SCREEN_WIDTH * 0.5, SCREEN_HEIGHT * 0.5);
 
+	initBullets();
+
 	initCrates(1 + stage.level * 2);
 
 	initPowerups();
@@ -94,15 +100,16 @@ static void resetStage() {
 	Particle *particle = stage.particleHead;
 
 	while (particle != NULL) {
-		//using the location of the power and scrap particles' sprites on their sprite sheet to identify them
-		//this is a bit hacky but oh well, i'm making a real sprite atlas after this project anyway
+		//scrap and powerups are identified by which sprites their particles were made from
 		if (particle->sprite != NULL) {
 			//delete scrap
-			if (particle->sprite->srcY >= 17 * SPRITE_ATLAS_CELL_H && particle->sprite->srcY <= 20 * SPRITE_ATLAS_CELL_H) {
-				particle->ttl = 0;
+			for (SpriteId id = SPR_SCRAP_1; id <= SPR_SCRAP_4; ++id) {
+				if (isSpriteFromTable(particle->sprite, id))
+					particle->ttl = 0;
 			}
 			//delete powerups
-			if (particle->sprite->srcX >= 0 * SPRITE_ATLAS_CELL_W && particle->sprite->srcX <= 7 * SPRITE_ATLAS_CELL_W && particle->sprite->srcY == 14 * SPRITE_ATLAS_CELL_H) {
+			CompositeSprite composite = getCompositeSprite(particle->sprite);
+			if (composite >= CS_POWERUP_NORMAL && composite <= CS_POWERUP_SHOTGUN) {
 				particle->ttl = 0;
 			}
 		}
@@ -165,6 +172,9 @@ static void ssGameplayUpdate(void) {
 
 	updateEnemies();
 
+	//resolve collisions once everything has moved
+	checkCollisions();
+
 	spawnEnemies();
 
 	//increment timer
@@ -244,6 +254,9 @@ static void ssGameplayUpdate(void) {
 
 		initPauseMenu();
 
+		//nothing in the gameplay scene changes while paused, so it only needs to be drawn once
+		invalidateRenderCache(&pauseBackdrop);
+
 		stage.state = SS_PAUSED;
 	}
 }
@@ -256,6 +269,8 @@ static void ssEndUpdate(void) {
 
 	updateBullets();
 
+	checkCollisions();
+
 	//state change
 
 	//when player presses fire, move on to the next stage
@@ -279,6 +294,8 @@ static void ssGameOverUpdate(void) {
 
 	updateEnemies();
 
+	checkCollisions();
+
 	//state change
 	++highscoreTimer;
 
@@ -402,6 +419,8 @@ static void ssGameplayDraw() {
 
 	drawPlayer();
 
+	displayContacts();	//only happens if app.debug = true
+
 	drawGameplayUI();
 }
 
@@ -439,6 +458,7 @@ static void ssGameOverDraw() {
 
 static void ssInputHighscoreDraw() {
 	drawBackground();
+	setRenderLayer(RL_UI);
 
 	//draw prompt text
 	drawTextDropShadow("Congratulations! You just got a top score.", SCREEN_WIDTH * 0.5, SCREEN_HEIGHT * 0.5 - 30, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
@@ -450,6 +470,7 @@ static void ssInputHighscoreDraw() {
 
 static void ssHighscoreTableDraw() {
 	drawBackground();
+	setRenderLayer(RL_UI);
 
 	drawHighscores(true);
 
@@ -462,15 +483,22 @@ static void ssPausedDraw() {
 	if (player != NULL) {
 		drawBackground();
 
-		drawParticles();
+		if (beginRenderCache(&pauseBackdrop)) {
+			drawParticles();
+
+			drawCrates();
 
-		drawCrates();
+			drawEnemies();
 
-		drawEnemies();
+			drawBullets();
 
-		drawBullets();
+			drawPlayer();
+
+			endRenderCache(&pauseBackdrop);
+		}
 
-		drawPlayer();
+		setRenderLayer(RL_PLAYER);
+		drawRenderCache(&pauseBackdrop);
 
 		//don't draw gameplay UI; it's a bit confusing to look at with the menu on screen
 
@@ -526,6 +554,8 @@ void deleteStage(void) {
 	deletePowerups();
 
 	deleteWidgets();
+
+	deleteRenderCache(&pauseBackdrop);
 }
 
 
@@ -609,7 +639,7 @@ static void waQuitToDesktop(void) {
 
 //options menu functions
 
-//fullscreenToggle, SFXSlider and MusicSlider aren't static so that mainMenu.c can use them & so I don't have to duplicate them for the main menu options menu
+//the options menu actions aren't static so that mainMenu.c can use them & so I don't have to duplicate them for the main menu options menu
 void waFullscreenToggle(void) {
 	if (app.preferences.fullscreen) {
 		SDL_SetWindowFullscreen(app.window, 0);	//go windowed
@@ -623,6 +653,16 @@ void waFullscreenToggle(void) {
 	//the "back" widget saves these preferences
 }
 
+void waScalingSelect(void) {
+	SelectWidget *selectWidget = (SelectWidget *)getWidget("scaling", "options")->data;
+
+	//put value in app struct and rescale the screen to match
+	app.preferences.integerScaling = (bool)selectWidget->value;
+	updateWindowScale();
+
+	//the "back" widget saves these preferences
+}
+
 void waSFXSlider(void) {
 	//get a pointer to the sfx slider widget
 	//seems a bit inefficient to have to get a pointer to this widget when the widget we want is the same widget that's calling this function
@@ -651,6 +691,25 @@ void waMusicSlider(void) {
 	//the "back" widget saves these preferences
 }
 
+void waQualitySelect(void) {
+	SelectWidget *selectWidget = (SelectWidget *)getWidget("quality", "options")->data;
+
+	//put value in app struct
+	//anything that depends on it (e.g. baked sprite rotations) picks up the change the next time it's drawn
+	app.preferences.quality = (GraphicsQuality)selectWidget->value;
+
+	//the "back" widget saves these preferences
+}
+
+void waPostProcessSelect(void) {
+	SelectWidget *selectWidget = (SelectWidget *)getWidget("postProcess", "options")->data;
+
+	//put value in app struct; presentScene picks it up at the end of this frame
+	app.preferences.postProcess = (bool)selectWidget->value;
+
+	//the "back" widget saves these preferences
+}
+
 //goes from the options menu back to the pause menu
 static void waBack(void) {
 	//unload options menu widgets
@@ -739,6 +798,14 @@ static void initOptionsMenu(void) {
 	selectWidget->y = widget->y;
 	selectWidget->value = (int)app.preferences.fullscreen;	//check the app struct for the current fullscreen state
 
+	widget = getWidget("scaling", "options");
+	widget->action = waScalingSelect;
+	widget->x = SCREEN_WIDTH * 0.5;
+	selectWidget = (SelectWidget *)widget->data;
+	selectWidget->x = SCREEN_WIDTH * 0.5;
+	selectWidget->y = widget->y;
+	selectWidget->value = (int)app.preferences.integerScaling;
+
 	widget = getWidget("sfxSlider", "options");
 	widget->action = waSFXSlider;
 	widget->x = SCREEN_WIDTH * 0.5;
@@ -755,6 +822,22 @@ static void initOptionsMenu(void) {
 	sliderWidget->y = widget->y;
 	sliderWidget->value = app.preferences.musicVolume;
 
+	widget = getWidget("quality", "options");
+	widget->action = waQualitySelect;
+	widget->x = SCREEN_WIDTH * 0.5;
+	selectWidget = (SelectWidget *)widget->data;
+	selectWidget->x = SCREEN_WIDTH * 0.5;
+	selectWidget->y = widget->y;
+	selectWidget->value = (int)app.preferences.quality;
+
+	widget = getWidget("postProcess", "options");
+	widget->action = waPostProcessSelect;
+	widget->x = SCREEN_WIDTH * 0.5;
+	selectWidget = (SelectWidget *)widget->data;
+	selectWidget->x = SCREEN_WIDTH * 0.5;
+	selectWidget->y = widget->y;
+	selectWidget->value = (int)app.preferences.postProcess;
+
 	widget = getWidget("back", "options");
 	widget->action = waBack;
 	widget->x = SCREEN_WIDTH * 0.5;
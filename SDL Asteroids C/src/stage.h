@@ -46,7 +46,10 @@ void deleteStage(void);
 //options menu widget actions
 //these could probably use their own file
 void waFullscreenToggle(void);
+void waScalingSelect(void);
 void waSFXSlider(void);
 void waMusicSlider(void);
+void waQualitySelect(void);
+void waPostProcessSelect(void);
 
 #endif
\ No newline at end of file
@@ -15,12 +15,23 @@ typedef struct {
 	void (*draw)(void);
 } Delegate;
 
+//graphics quality presets, from cheapest to best looking
+//GQ stands for graphics quality
+typedef enum {
+	GQ_LOW,		//crates, enemies and bullets are drawn from 32 baked rotations
+	GQ_MEDIUM,	//crates, enemies and bullets are drawn from 64 baked rotations
+	GQ_HIGH		//everything is rotated exactly
+} GraphicsQuality;
+
 //stores user preferences (aka things you can change via the options menu) for runtime reference 
 typedef struct {
 	//a bool for fullscreen isn't here because SDL_GetWindowDisplayMode exists
 	bool fullscreen;	//stores if the app is in fullscreen or not
 	int soundVolume;	//between 0 and 10
 	int musicVolume;	//between 0 and 10
+	GraphicsQuality quality;
+	bool integerScaling;	//if true, the screen is only ever scaled up by whole numbers (unless the window is too small for that)
+	bool postProcess;	//if true, the CRT effects in postProcess.h are on
 } Preferences;
 
 //Stores various important things related to running the application
@@ -40,6 +51,12 @@ typedef struct {
 	Widget			*activeWidget;			//pointer to the widget that is currently active, if any
 	int				latestHighscoreIndex;	//holds the index of the player's latest highscore for aesthetic purposes
 	CursorState		cursorState;			//the state of the cursor (whether or not it will be drawn, what it should be drawn as)
+	bool			headless;				//if true, there's no visible window or sound, and frames are drawn on the CPU (see main.c)
+	int				headlessFrames;			//number of frames to run for when headless
+	char			*headlessOutput;		//where to save the last frame when headless (NULL to not save it)
+	SDL_Surface		*headlessSurface;		//what frames get drawn into when headless
+	bool			noTextureCache;			//if true, images are always decoded from their PNGs (see textureCache.h)
+	char			*captureOutput;			//where every frame gets captured to (see capture.h), or NULL to not capture
 } App;
 
 //Stores mouse info
@@ -0,0 +1,274 @@
+#include "common.h"
+
+#include "SDL_image.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "textureCache.h"
+
+extern App app;
+
+//a read-only view of a whole file
+typedef struct {
+	const Uint8 *data;
+	size_t size;
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE mapping;
+#endif
+} MappedFile;
+
+//what a cache file starts with; the pixels come right after it, row by row
+typedef struct {
+	char magic[4];		//always TEXTURE_CACHE_MAGIC
+	Uint32 version;		//TEXTURE_CACHE_VERSION when the file was written
+	Uint64 sourceHash;	//hash of the PNG the pixels were decoded from
+	Uint32 format;		//always TEXTURE_CACHE_FORMAT
+	Sint32 w;
+	Sint32 h;
+	Sint32 pitch;		//bytes per row
+} TextureCacheHeader;
+
+SDL_Surface *loadCachedImage(const char *filename);
+static char *getCachePath(const char *filename);
+static Uint64 hashBytes(const Uint8 *bytes, size_t size);
+static SDL_Surface *readCacheFile(const char *path, Uint64 sourceHash);
+static void writeCacheFile(const char *path, Uint64 sourceHash, const SDL_Surface *image);
+static bool mapFile(const char *path, MappedFile *mapped);
+static void unmapFile(MappedFile *mapped);
+void freeCachedImage(SDL_Surface *image);
+
+static const char TEXTURE_CACHE_MAGIC[4] = { 'C', 'B', 'T', 'C' };
+static const Uint32 TEXTURE_CACHE_VERSION = 1;	//bump whenever the layout of cache files changes
+static const Uint32 TEXTURE_CACHE_FORMAT = SDL_PIXELFORMAT_ARGB8888;	//what renderers take natively, so uploads don't need converting
+
+//loads an image as TEXTURE_CACHE_FORMAT pixels, from its cache file if it has a good one, otherwise from the PNG itself (and caches it)
+//returns NULL if the image can't be loaded; free what this returns with freeCachedImage, not SDL_FreeSurface
+SDL_Surface *loadCachedImage(const char *filename) {
+	//the PNG has to be read either way to check the cache against it, but reading it is cheap; decoding it is what the cache skips
+	size_t pngSize;
+	Uint8 *png = SDL_LoadFile(filename, &pngSize);
+	if (png == NULL) {
+		printf("ERROR - File '%s' could not be read: %s\n", filename, SDL_GetError());
+		return NULL;
+	}
+
+	Uint64 hash = hashBytes(png, pngSize);
+	char *cachePath = app.noTextureCache ? NULL : getCachePath(filename);
+	SDL_Surface *image = cachePath != NULL ? readCacheFile(cachePath, hash) : NULL;
+
+	if (image == NULL) {
+		SDL_Surface *decoded = IMG_Load_RW(SDL_RWFromConstMem(png, (int)pngSize), 1);
+
+		if (decoded != NULL) {
+			image = SDL_ConvertSurfaceFormat(decoded, TEXTURE_CACHE_FORMAT, 0);
+			SDL_FreeSurface(decoded);
+		}
+
+		if (image == NULL)
+			printf("ERROR - File '%s' could not be decoded: %s\n", filename, IMG_GetError());
+		else if (cachePath != NULL)
+			writeCacheFile(cachePath, hash, image);
+	}
+
+	SDL_free(cachePath);
+	SDL_free(png);
+
+	return image;
+}
+
+//cache files go in their own folder in SDL's pref path, named after the image's path
+//returns NULL if there's nowhere to put them
+static char *getCachePath(const char *filename) {
+	char *prefPath = SDL_GetPrefPath("Crate Buster", "textureCache");
+	if (prefPath == NULL)
+		return NULL;
+
+	size_t length = strlen(prefPath) + strlen(filename) + sizeof(".texcache");
+	char *path = SDL_malloc(length);
+
+	if (path != NULL) {
+		SDL_snprintf(path, length, "%s%s.texcache", prefPath, filename);
+
+		//flatten the image's path into one file name
+		for (char *c = path + strlen(prefPath); *c != '\0'; ++c) {
+			if (*c == '/' || *c == '\\' || *c == ':')
+				*c = '_';
+		}
+	}
+
+	SDL_free(prefPath);
+
+	return path;
+}
+
+//64-bit FNV-1a hash
+static Uint64 hashBytes(const Uint8 *bytes, size_t size) {
+	Uint64 hash = 14695981039346656037ULL;
+
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+//maps a cache file and makes a surface that uses its pixels where they are
+//returns NULL if the file is missing or doesn't match the PNG it's supposed to be a copy of
+static SDL_Surface *readCacheFile(const char *path, Uint64 sourceHash) {
+	MappedFile mapped;
+	if (!mapFile(path, &mapped))
+		return NULL;
+
+	const TextureCacheHeader *header = (const TextureCacheHeader *)mapped.data;
+	bool valid = mapped.size >= sizeof(TextureCacheHeader)
+		&& memcmp(header->magic, TEXTURE_CACHE_MAGIC, sizeof(TEXTURE_CACHE_MAGIC)) == 0
+		&& header->version == TEXTURE_CACHE_VERSION
+		&& header->sourceHash == sourceHash
+		&& header->format == TEXTURE_CACHE_FORMAT
+		&& header->w > 0 && header->h > 0 && header->pitch >= header->w * 4
+		&& mapped.size == sizeof(TextureCacheHeader) + (size_t)header->pitch * header->h;
+
+	SDL_Surface *image = NULL;
+	MappedFile *owner = NULL;
+
+	if (valid) {
+		owner = malloc(sizeof(MappedFile));
+		//the surface only reads its pixels, so pointing it at read-only memory is fine
+		image = SDL_CreateRGBSurfaceWithFormatFrom((void *)(mapped.data + sizeof(TextureCacheHeader)), header->w, header->h, 32, header->pitch, header->format);
+	}
+
+	if (image == NULL || owner == NULL) {
+		if (image != NULL)
+			SDL_FreeSurface(image);
+		free(owner);
+		unmapFile(&mapped);
+		return NULL;
+	}
+
+	//the mapping has to stay open for as long as the surface is around
+	*owner = mapped;
+	image->userdata = owner;
+
+	return image;
+}
+
+//writes an image's pixels to a cache file
+//failing isn't a problem; the PNG just gets decoded again next time
+static void writeCacheFile(const char *path, Uint64 sourceHash, const SDL_Surface *image) {
+	TextureCacheHeader header;
+	memcpy(header.magic, TEXTURE_CACHE_MAGIC, sizeof(TEXTURE_CACHE_MAGIC));
+	header.version = TEXTURE_CACHE_VERSION;
+	header.sourceHash = sourceHash;
+	header.format = TEXTURE_CACHE_FORMAT;
+	header.w = image->w;
+	header.h = image->h;
+	header.pitch = image->w * 4;
+
+	SDL_RWops *file = SDL_RWFromFile(path, "wb");
+	if (file == NULL) {
+		printf("WARNING - Texture cache '%s' could not be written: %s\n", path, SDL_GetError());
+		return;
+	}
+
+	bool success = SDL_RWwrite(file, &header, sizeof(header), 1) == 1;
+	for (int y = 0; y < image->h && success; ++y)
+		success = SDL_RWwrite(file, (const Uint8 *)image->pixels + y * image->pitch, header.pitch, 1) == 1;
+
+	SDL_RWclose(file);
+
+	//a half-written file would just fail its size check next time, but there's no point leaving it around
+	if (!success) {
+		printf("WARNING - Texture cache '%s' could not be written: %s\n", path, SDL_GetError());
+		remove(path);
+	}
+}
+
+//maps a whole file into memory, read-only
+static bool mapFile(const char *path, MappedFile *mapped) {
+	memset(mapped, 0, sizeof(MappedFile));
+
+#ifdef _WIN32
+	//SDL's paths are UTF-8
+	wchar_t widePath[MAX_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, path, -1, widePath, MAX_PATH) == 0)
+		return false;
+
+	mapped->file = CreateFileW(widePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (mapped->file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(mapped->file, &size) || size.QuadPart == 0) {
+		CloseHandle(mapped->file);
+		return false;
+	}
+
+	mapped->mapping = CreateFileMappingW(mapped->file, NULL, PAGE_READONLY, 0, 0, NULL);
+	mapped->data = mapped->mapping != NULL ? MapViewOfFile(mapped->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+	if (mapped->data == NULL) {
+		if (mapped->mapping != NULL)
+			CloseHandle(mapped->mapping);
+		CloseHandle(mapped->file);
+		return false;
+	}
+
+	mapped->size = (size_t)size.QuadPart;
+#else
+	int file = open(path, O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size == 0) {
+		close(file);
+		return false;
+	}
+
+	//the mapping stays valid after the file is closed
+	void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (data == MAP_FAILED)
+		return false;
+
+	mapped->data = data;
+	mapped->size = info.st_size;
+#endif
+
+	return true;
+}
+
+//undoes mapFile
+static void unmapFile(MappedFile *mapped) {
+#ifdef _WIN32
+	UnmapViewOfFile(mapped->data);
+	CloseHandle(mapped->mapping);
+	CloseHandle(mapped->file);
+#else
+	munmap((void *)mapped->data, mapped->size);
+#endif
+	mapped->data = NULL;
+	mapped->size = 0;
+}
+
+//frees an image from loadCachedImage (unmapping its cache file, if it came from one)
+void freeCachedImage(SDL_Surface *image) {
+	MappedFile *mapped = image->userdata;
+
+	SDL_FreeSurface(image);
+
+	if (mapped != NULL) {
+		unmapFile(mapped);
+		free(mapped);
+	}
+}
\ No newline at end of file
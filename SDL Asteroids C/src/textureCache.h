@@ -0,0 +1,14 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+/*
+* Keeps decoded copies of images on disk (in SDL's pref path), so that later launches can skip inflating PNGs.
+* Each cache file holds the image's pixels exactly as they get uploaded, plus a hash of the PNG they came from.
+* Cache files are memory mapped, so loading one is just the OS paging it in; if the PNG has changed since
+* (or the cache file is missing, from an older version, or broken), the PNG is decoded like normal and the cache file is rewritten.
+*/
+
+SDL_Surface *loadCachedImage(const char *filename);
+void freeCachedImage(SDL_Surface *image);
+
+#endif
\ No newline at end of file
@@ -17,8 +17,9 @@ extern PLAYER_HP_MAX;
 //vars for drawing beginning and end UI
 static const int startTextVertMargin = 45;
 
-//text buffer for drawStageEndUI
-char scoreTextEnd[40];
+//score text for drawStageEndUI and drawStageGameOverUI
+static TextObject *scoreTextEnd;
+static TextObject *scoreTextGameOver;
 
 //margins for drawing gameplay UI
 static const int horzMargin = 8;
@@ -26,9 +27,11 @@ static const int bottomVertMargin = 20;
 static const int topVertMargin = 8;
 static const int heartHorzMargin = 28;
 
-//text buffers for drawGameplayUI
-char scoreText[40];
-char stageText[40];
+//text for drawGameplayUI
+//these only get rebuilt when the values they show change
+static TextObject *scoreText;
+static TextObject *weaponText;
+static TextObject *stageText;
 
 //sprites for gameplay UI
 static SpriteStatic *heartFull;
@@ -62,6 +65,11 @@ static SpriteStatic *powerupLetterEGraphic;
 static SpriteStatic *powerupLetterBGraphic;
 static SpriteStatic *powerupLetterSGraphic;
 
+//the how to play and credits screens never change, so they're drawn into these once and then just copied to the screen
+//(widgets are still drawn every frame, since the selection arrow is animated)
+static RenderCache howToPlayCache;
+static RenderCache creditsCache;
+
 //positional variables for how to play UI
 static const int LEFT_X = SCREEN_WIDTH * 0.25;
 static const int RIGHT_X = SCREEN_WIDTH * 0.75;
@@ -69,14 +77,24 @@ static const int RIGHT_X = SCREEN_WIDTH * 0.75;
 void initGameplayUI(void) {
 	heartFull = initSpriteStatic(app.fontsAndUI, 12, 19, 2, 2, SC_TOP_LEFT);
 	heartEmpty = initSpriteStatic(app.fontsAndUI, 14, 19, 2, 2, SC_TOP_LEFT);
+
+	scoreText = initTextObject(SCREEN_WIDTH - horzMargin, topVertMargin, TAH_RIGHT, 0, PALETTE_WHITE, PALETTE_BLACK, 1);
+	weaponText = initTextObject(horzMargin, SCREEN_HEIGHT - bottomVertMargin, TAH_LEFT, 0, PALETTE_WHITE, PALETTE_BLACK, 1);
+	stageText = initTextObject(SCREEN_WIDTH - horzMargin, SCREEN_HEIGHT - bottomVertMargin, TAH_RIGHT, 0, PALETTE_WHITE, PALETTE_BLACK, 1);
+	scoreTextEnd = initTextObject(SCREEN_WIDTH * 0.5, SCREEN_HEIGHT * 0.5, TAH_CENTER, 0, PALETTE_WHITE, PALETTE_BLACK, 1);
+	scoreTextGameOver = initTextObject(SCREEN_WIDTH * 0.5, SCREEN_HEIGHT * 0.5 + 15, TAH_CENTER, 0, PALETTE_WHITE, PALETTE_BLACK, 1);
 }
 
 void drawStageStartUI(void) {
+	setRenderLayer(RL_UI);
+
 	//draw ready text in center of screen
 	drawTextDropShadow("GET READY...", SCREEN_WIDTH * 0.5, SCREEN_HEIGHT * 0.5 - startTextVertMargin, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
 }
 
 void drawGameplayUI(void) {
+	setRenderLayer(RL_UI);
+
 	//draw player health in top left
 	for (int i = 0; i < PLAYER_HP_MAX; ++i) {
 		if(i < player->hp)
@@ -86,52 +104,56 @@ void drawGameplayUI(void) {
 	}
 
 	//draw player score in top right
-	snprintf(scoreText, 40, "Score: %d", stage.score);
-	drawTextDropShadow(scoreText, SCREEN_WIDTH - horzMargin, topVertMargin, PALETTE_WHITE, TAH_RIGHT, NULL, PALETTE_BLACK, 1);
+	setTextObjectInt(scoreText, "Score: %d", stage.score);
+	drawTextObject(scoreText);
 
 	//draw current weapon's name in bottom left
 	switch (player->weaponType) {
 	case(BT_NORMAL):
-		drawTextDropShadow( "WEAPON: NORMAL", horzMargin, SCREEN_HEIGHT - bottomVertMargin, PALETTE_WHITE, TAH_LEFT, NULL, PALETTE_BLACK, 1);
+		setTextObjectText(weaponText, "WEAPON: NORMAL");
 		break;
 	case(BT_ERRATIC):
-		drawTextDropShadow("WEAPON: ERRATIC", horzMargin, SCREEN_HEIGHT - bottomVertMargin, PALETTE_WHITE, TAH_LEFT, NULL, PALETTE_BLACK, 1);
+		setTextObjectText(weaponText, "WEAPON: ERRATIC");
 		break;
 	case(BT_BOUNCER):
-		drawTextDropShadow("WEAPON: BOUNCER", horzMargin, SCREEN_HEIGHT - bottomVertMargin, PALETTE_WHITE, TAH_LEFT, NULL, PALETTE_BLACK, 1);
+		setTextObjectText(weaponText, "WEAPON: BOUNCER");
 		break;
 	case(BT_SHOTGUN):
-		drawTextDropShadow("WEAPON: SHOTGUN", horzMargin, SCREEN_HEIGHT - bottomVertMargin, PALETTE_WHITE, TAH_LEFT, NULL, PALETTE_BLACK, 1);
+		setTextObjectText(weaponText, "WEAPON: SHOTGUN");
 		break;
 	}
+	drawTextObject(weaponText);
 
 	//draw stage number in bottom right
-	snprintf(stageText, 40, "STAGE: %d", stage.level);
-	drawTextDropShadow(stageText, SCREEN_WIDTH - horzMargin, SCREEN_HEIGHT - bottomVertMargin, PALETTE_WHITE, TAH_RIGHT, NULL, PALETTE_BLACK, 1);
+	setTextObjectInt(stageText, "STAGE: %d", stage.level);
+	drawTextObject(stageText);
 }
 
 void drawStageEndUI(void) {
+	setRenderLayer(RL_UI);
+
 	drawTextDropShadow("WELL DONE!", SCREEN_WIDTH * 0.5, SCREEN_HEIGHT * 0.5 - startTextVertMargin, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	sprintf(scoreTextEnd, "YOUR SCORE: %d", stage.score);
-	drawTextDropShadow(scoreTextEnd, SCREEN_WIDTH * 0.5, SCREEN_HEIGHT * 0.5, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+	setTextObjectInt(scoreTextEnd, "YOUR SCORE: %d", stage.score);
+	drawTextObject(scoreTextEnd);
 	drawTextDropShadow("PRESS FIRE TO PLAY NEXT STAGE", SCREEN_WIDTH * 0.5, SCREEN_HEIGHT * 0.5 + startTextVertMargin, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
 }
 
 void drawStageGameOverUI(void) {
+	setRenderLayer(RL_UI);
+
 	drawTextDropShadow("GAME OVER", SCREEN_WIDTH * 0.5, SCREEN_HEIGHT * 0.5 - 15, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	sprintf(scoreTextEnd, "YOUR SCORE: %d", stage.score);
-	drawTextDropShadow(scoreTextEnd, SCREEN_WIDTH * 0.5, SCREEN_HEIGHT * 0.5 + 15, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+	setTextObjectInt(scoreTextGameOver, "YOUR SCORE: %d", stage.score);
+	drawTextObject(scoreTextGameOver);
 
 	drawWidgets(NULL);
 }
 
 void drawPausedUI(void) {
 	//draw a semitransparent black rectangle over the screen
-	//stuff like this is why I need a rectangle drawing function
 	SDL_Rect screenDarken = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-	SDL_SetRenderDrawBlendMode(app.renderer, SDL_BLENDMODE_BLEND);
-	SDL_SetRenderDrawColor(app.renderer, PALETTE_BLACK.r, PALETTE_BLACK.g, PALETTE_BLACK.b, 191);
-	SDL_RenderFillRect(app.renderer, &screenDarken);
+	SDL_Color darken = {PALETTE_BLACK.r, PALETTE_BLACK.g, PALETTE_BLACK.b, 191};
+	setRenderLayer(RL_OVERLAY);
+	drawFilledRect(&screenDarken, darken);
 
 	drawWidgets(NULL);
 }
@@ -139,6 +161,12 @@ void drawPausedUI(void) {
 void deleteGameplayUI(void) {
 	free(heartFull);
 	free(heartEmpty);
+
+	free(scoreText);
+	free(weaponText);
+	free(stageText);
+	free(scoreTextEnd);
+	free(scoreTextGameOver);
 }
 
 //initializes stuff for main menu and its submenus/options
@@ -154,26 +182,27 @@ void initMainMenuUI(void) {
 	rightShoulderButtonGraphic = initSpriteStatic(app.fontsAndUI, 11, 20, 1, 1, SC_CENTER);
 	bottomFaceButtonGraphic = initSpriteStatic(app.fontsAndUI, 8, 19, 1, 1, SC_CENTER);
 
-	crateGraphic = initSpriteStatic(app.gameplaySprites, 0, 4, 3, 3, SC_CENTER);
-	enemyShipGraphic = initSpriteStatic(app.gameplaySprites, 6, 7, 4, 4, SC_CENTER);
-	enemyBulletGraphic = initSpriteStatic(app.gameplaySprites, 16, 12, 2, 1, SC_CENTER);
-	playerShipGraphic = initSpriteStatic(app.gameplaySprites, 0, 11, 3, 3, SC_CENTER);
-	playerBulletGraphic = initSpriteStatic(app.gameplaySprites, 20, 0, 2, 1, SC_CENTER);
-	scrapGraphic1 = initSpriteStatic(app.gameplaySprites, 16, 17, 1, 1, SC_CENTER);
-	scrapGraphic2 = initSpriteStatic(app.gameplaySprites, 16, 18, 1, 1, SC_CENTER);
-	scrapGraphic3 = initSpriteStatic(app.gameplaySprites, 16, 19, 1, 1, SC_CENTER);
-	scrapGraphic4 = initSpriteStatic(app.gameplaySprites, 16, 20, 1, 1, SC_CENTER);
-	powerupBaseGraphic = initSpriteStatic(app.gameplaySprites, 8, 14, 2, 2, SC_CENTER);
-	powerupLetterNGraphic = initSpriteStatic(app.gameplaySprites, 0, 14, 2, 2, SC_CENTER);
-	powerupLetterEGraphic = initSpriteStatic(app.gameplaySprites, 2, 14, 2, 2, SC_CENTER);
-	powerupLetterBGraphic = initSpriteStatic(app.gameplaySprites, 4, 14, 2, 2, SC_CENTER);
-	powerupLetterSGraphic = initSpriteStatic(app.gameplaySprites, 6, 14, 2, 2, SC_CENTER);
+	crateGraphic = initSpriteStaticFromTable(SPR_CRATE_MEDIUM, 0);
+	enemyShipGraphic = initSpriteStaticFromTable(SPR_ENEMY, 0);
+	enemyBulletGraphic = initSpriteStaticFromTable(SPR_BULLET_ENEMY, 0);
+	playerShipGraphic = initSpriteStaticFromTable(SPR_PLAYER_SHIP, 0);
+	playerBulletGraphic = initSpriteStaticFromTable(SPR_BULLET_NORMAL, 2);
+	scrapGraphic1 = initSpriteStaticFromTable(SPR_SCRAP_1, 0);
+	scrapGraphic2 = initSpriteStaticFromTable(SPR_SCRAP_2, 0);
+	scrapGraphic3 = initSpriteStaticFromTable(SPR_SCRAP_3, 0);
+	scrapGraphic4 = initSpriteStaticFromTable(SPR_SCRAP_4, 0);
+	powerupBaseGraphic = initSpriteStaticFromTable(SPR_POWERUP_CELL, 0);
+	powerupLetterNGraphic = initSpriteStaticFromTable(SPR_POWERUP_LETTER_N, 0);
+	powerupLetterEGraphic = initSpriteStaticFromTable(SPR_POWERUP_LETTER_E, 0);
+	powerupLetterBGraphic = initSpriteStaticFromTable(SPR_POWERUP_LETTER_B, 0);
+	powerupLetterSGraphic = initSpriteStaticFromTable(SPR_POWERUP_LETTER_S, 0);
 }
 
 void drawMainMenuUI(void) {
 	//use title as a check to make sure the necessary sprites haven't been deleted by going into the game or exiting the app
 	if (title) {
 		drawBackground();
+		setRenderLayer(RL_UI);
 
 		blitSpriteStatic(title, SCREEN_WIDTH * 0.5, 30);
 
@@ -183,48 +212,54 @@ void drawMainMenuUI(void) {
 
 void drawHowToPlayUI(void) {
 	drawBackground();
-
-	drawTextDropShadow("Move:", LEFT_X, 40, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	blitSpriteStatic(leftStickGraphic, LEFT_X - 60, 70);
-	blitSpriteStatic(dpadGraphic, LEFT_X - 40, 70);
-	for(int i = -20; i < 60; i += 20)
-		blitSpriteStatic(keyBackgroundGraphic, LEFT_X + i + 4, 70);
-	drawTextDropShadow("W A S D", LEFT_X - 20, 70 - 6, PALETTE_WHITE, TAH_LEFT, NULL, PALETTE_BLACK, 1);
-
-	drawTextDropShadow("Aim:", RIGHT_X, 40, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	blitSpriteStatic(rightStickGraphic, RIGHT_X - 10, 70);
-	blitSpriteStatic(mouseGraphic, RIGHT_X + 10, 70);
-
-	drawTextDropShadow("Fire bullets:", LEFT_X, 100, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	blitSpriteStatic(rightShoulderButtonGraphic, LEFT_X - 20, 130);
-	blitSpriteStatic(bottomFaceButtonGraphic, LEFT_X, 130);
-	blitSpriteStatic(leftMouseButtonGraphic, LEFT_X + 20, 130);
-	blitSpriteStatic(playerShipGraphic, LEFT_X - 30, 170);
-	blitSpriteStatic(playerBulletGraphic, LEFT_X + 30, 170);
-
-	drawTextDropShadow("Avoid crates, enemies,", RIGHT_X, 100, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	drawTextDropShadow("and enemy bullets.", RIGHT_X, 120, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	blitSpriteStatic(crateGraphic, RIGHT_X - 60, 170);
-	blitSpriteStatic(enemyShipGraphic, RIGHT_X, 170);
-	blitSpriteStatic(enemyBulletGraphic, RIGHT_X + 60, 170);
-
-	drawTextDropShadow("Collect scrap", LEFT_X, 210, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	drawTextDropShadow("for high score.", LEFT_X, 230, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	blitSpriteStatic(scrapGraphic1, LEFT_X - 30, 260);
-	blitSpriteStatic(scrapGraphic2, LEFT_X - 10, 260);
-	blitSpriteStatic(scrapGraphic3, LEFT_X + 10, 260);
-	blitSpriteStatic(scrapGraphic4, LEFT_X + 30, 260);
-
-	drawTextDropShadow("Collect powerups for a", RIGHT_X, 210, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	drawTextDropShadow("new weapon and a bonus.", RIGHT_X, 230, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	blitSpriteStatic(powerupBaseGraphic, RIGHT_X - 60, 265);
-	blitSpriteStatic(powerupLetterNGraphic, RIGHT_X - 60, 265);
-	blitSpriteStatic(powerupBaseGraphic, RIGHT_X - 20, 265);
-	blitSpriteStatic(powerupLetterEGraphic, RIGHT_X - 20, 265);
-	blitSpriteStatic(powerupBaseGraphic, RIGHT_X + 20, 265);
-	blitSpriteStatic(powerupLetterBGraphic, RIGHT_X + 20, 265);
-	blitSpriteStatic(powerupBaseGraphic, RIGHT_X + 60, 265);
-	blitSpriteStatic(powerupLetterSGraphic, RIGHT_X + 60, 265);
+	setRenderLayer(RL_UI);
+
+	if (beginRenderCache(&howToPlayCache)) {
+		drawTextDropShadow("Move:", LEFT_X, 40, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		blitSpriteStatic(leftStickGraphic, LEFT_X - 60, 70);
+		blitSpriteStatic(dpadGraphic, LEFT_X - 40, 70);
+		for(int i = -20; i < 60; i += 20)
+			blitSpriteStatic(keyBackgroundGraphic, LEFT_X + i + 4, 70);
+		drawTextDropShadow("W A S D", LEFT_X - 20, 70 - 6, PALETTE_WHITE, TAH_LEFT, NULL, PALETTE_BLACK, 1);
+
+		drawTextDropShadow("Aim:", RIGHT_X, 40, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		blitSpriteStatic(rightStickGraphic, RIGHT_X - 10, 70);
+		blitSpriteStatic(mouseGraphic, RIGHT_X + 10, 70);
+
+		drawTextDropShadow("Fire bullets:", LEFT_X, 100, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		blitSpriteStatic(rightShoulderButtonGraphic, LEFT_X - 20, 130);
+		blitSpriteStatic(bottomFaceButtonGraphic, LEFT_X, 130);
+		blitSpriteStatic(leftMouseButtonGraphic, LEFT_X + 20, 130);
+		blitSpriteStatic(playerShipGraphic, LEFT_X - 30, 170);
+		blitSpriteStatic(playerBulletGraphic, LEFT_X + 30, 170);
+
+		drawTextDropShadow("Avoid crates, enemies,", RIGHT_X, 100, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		drawTextDropShadow("and enemy bullets.", RIGHT_X, 120, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		blitSpriteStatic(crateGraphic, RIGHT_X - 60, 170);
+		blitSpriteStatic(enemyShipGraphic, RIGHT_X, 170);
+		blitSpriteStatic(enemyBulletGraphic, RIGHT_X + 60, 170);
+
+		drawTextDropShadow("Collect scrap", LEFT_X, 210, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		drawTextDropShadow("for high score.", LEFT_X, 230, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		blitSpriteStatic(scrapGraphic1, LEFT_X - 30, 260);
+		blitSpriteStatic(scrapGraphic2, LEFT_X - 10, 260);
+		blitSpriteStatic(scrapGraphic3, LEFT_X + 10, 260);
+		blitSpriteStatic(scrapGraphic4, LEFT_X + 30, 260);
+
+		drawTextDropShadow("Collect powerups for a", RIGHT_X, 210, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		drawTextDropShadow("new weapon and a bonus.", RIGHT_X, 230, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		blitSpriteStatic(powerupBaseGraphic, RIGHT_X - 60, 265);
+		blitSpriteStatic(powerupLetterNGraphic, RIGHT_X - 60, 265);
+		blitSpriteStatic(powerupBaseGraphic, RIGHT_X - 20, 265);
+		blitSpriteStatic(powerupLetterEGraphic, RIGHT_X - 20, 265);
+		blitSpriteStatic(powerupBaseGraphic, RIGHT_X + 20, 265);
+		blitSpriteStatic(powerupLetterBGraphic, RIGHT_X + 20, 265);
+		blitSpriteStatic(powerupBaseGraphic, RIGHT_X + 60, 265);
+		blitSpriteStatic(powerupLetterSGraphic, RIGHT_X + 60, 265);
+
+		endRenderCache(&howToPlayCache);
+	}
+	drawRenderCache(&howToPlayCache);
 
 	//draw back button
 	drawWidgets("back");
@@ -232,6 +267,7 @@ void drawHowToPlayUI(void) {
 
 void drawHighscoresUI(void) {
 	drawBackground();
+	setRenderLayer(RL_UI);
 
 	//draw highscores without displaying the user's latest score
 	drawHighscores(false);
@@ -242,6 +278,7 @@ void drawHighscoresUI(void) {
 
 void drawOptionsUI(void) {
 	drawBackground();
+	setRenderLayer(RL_UI);
 
 	//draw widgets
 	drawWidgets("options");
@@ -249,13 +286,19 @@ void drawOptionsUI(void) {
 
 void drawCreditsUI(void) {
 	drawBackground();
+	setRenderLayer(RL_UI);
 
-	//draw credits text
-	drawTextDropShadow("Programming, graphics, sound, and music by:", SCREEN_WIDTH * 0.5, 120, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	drawTextDropShadow("Evan Evers", SCREEN_WIDTH * 0.5, 150, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	drawTextDropShadow("Special thanks to:", SCREEN_WIDTH * 0.5, 180, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	drawTextDropShadow("The SDL development team", SCREEN_WIDTH * 0.5, 210, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
-	drawTextDropShadow("Dave Gamble", SCREEN_WIDTH * 0.5, 240, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+	if (beginRenderCache(&creditsCache)) {
+		//draw credits text
+		drawTextDropShadow("Programming, graphics, sound, and music by:", SCREEN_WIDTH * 0.5, 120, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		drawTextDropShadow("Evan Evers", SCREEN_WIDTH * 0.5, 150, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		drawTextDropShadow("Special thanks to:", SCREEN_WIDTH * 0.5, 180, PALETTE_LIGHT_BLUE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		drawTextDropShadow("The SDL development team", SCREEN_WIDTH * 0.5, 210, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+		drawTextDropShadow("Dave Gamble", SCREEN_WIDTH * 0.5, 240, PALETTE_WHITE, TAH_CENTER, NULL, PALETTE_BLACK, 1);
+
+		endRenderCache(&creditsCache);
+	}
+	drawRenderCache(&creditsCache);
 
 	//draw back button
 	drawWidgets("back");
@@ -267,6 +310,9 @@ void deleteMainMenuUI(void) {
 	free(title);
 	title = NULL;
 
+	deleteRenderCache(&howToPlayCache);
+	deleteRenderCache(&creditsCache);
+
 	free(leftStickGraphic);
 	leftStickGraphic = NULL;
 	free(dpadGraphic);
@@ -46,4 +46,70 @@ void approach(float *val, float target, float increment) {
 				*val = target;
 		}
 	}
+}
+
+//reads the codepoint at the start of text and moves text past it
+//invalid bytes (stray continuation bytes, overlong or truncated sequences, surrogates) come out as UTF8_REPLACEMENT_CHARACTER one byte at a time,
+//so nothing is skipped and the null terminator is never read past
+Uint32 decodeUTF8(const char **text) {
+	const unsigned char *bytes = (const unsigned char *)*text;
+	Uint32 codepoint;
+	int length;
+
+	if (bytes[0] < 0x80) {
+		*text += 1;
+		return bytes[0];
+	} else if (bytes[0] >= 0xC2 && bytes[0] <= 0xDF) {
+		codepoint = bytes[0] & 0x1F;
+		length = 2;
+	} else if (bytes[0] >= 0xE0 && bytes[0] <= 0xEF) {
+		codepoint = bytes[0] & 0x0F;
+		length = 3;
+	} else if (bytes[0] >= 0xF0 && bytes[0] <= 0xF4) {
+		codepoint = bytes[0] & 0x07;
+		length = 4;
+	} else {
+		*text += 1;
+		return UTF8_REPLACEMENT_CHARACTER;
+	}
+
+	for (int i = 1; i < length; ++i) {
+		//a null terminator isn't a continuation byte, so this stops at the end of the string
+		if ((bytes[i] & 0xC0) != 0x80) {
+			*text += 1;
+			return UTF8_REPLACEMENT_CHARACTER;
+		}
+		codepoint = (codepoint << 6) | (bytes[i] & 0x3F);
+	}
+
+	//reject overlong encodings, surrogates and anything past the end of unicode
+	if ((length == 3 && codepoint < 0x800) || (length == 4 && (codepoint < 0x10000 || codepoint > 0x10FFFF)) || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+		*text += 1;
+		return UTF8_REPLACEMENT_CHARACTER;
+	}
+
+	*text += length;
+	return codepoint;
+}
+
+//counts the codepoints in a string (each invalid byte counts as one, like in decodeUTF8)
+int countUTF8(const char *text) {
+	int count = 0;
+
+	while (*text != '\0') {
+		decodeUTF8(&text);
+		++count;
+	}
+
+	return count;
+}
+
+//finds the longest prefix of text that's at most length bytes and doesn't end partway through a codepoint
+//use this before cutting a string short, so the cut doesn't leave half a character behind
+int findUTF8Boundary(const char *text, int length) {
+	//continuation bytes all look like 10xxxxxx
+	while (length > 0 && ((unsigned char)text[length] & 0xC0) == 0x80)
+		--length;
+
+	return length;
 }
\ No newline at end of file
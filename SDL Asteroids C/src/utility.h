@@ -8,4 +8,11 @@
 char *readFile(char *filename);
 void approach(float *val, float target, float increment);
 
+//UTF-8
+#define UTF8_REPLACEMENT_CHARACTER 0xFFFD	//what decodeUTF8 returns for bytes that aren't valid UTF-8
+
+Uint32 decodeUTF8(const char **text);
+int countUTF8(const char *text);
+int findUTF8Boundary(const char *text, int length);
+
 #endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <float.h>	//for the float max
 
 #include "./json/cJSON.h"
+#include "animations.h"
 #include "fonts.h"
 #include "input.h"
 #include "sound.h"
@@ -16,6 +17,8 @@ extern InputManager input;
 static Widget *widgetHead;
 static Widget *widgetTail;
 
+cJSON *parseWidgetFile(char *filename);
+void addParsedWidgetFile(char *filename, cJSON *root);
 static void createWidget(cJSON *root);
 static WidgetType getWidgetType(char *type);
 static void createButtonWidget(Widget *w, cJSON *root);
@@ -38,6 +41,18 @@ static void changeSliderValueMouse();
 *	-Implement control binding widget (for a future project)
 */
 
+//max number of widget files that can be parsed ahead of time
+#define MAX_PARSED_WIDGET_FILES 8
+
+//a widget file that was parsed ahead of time (see loading.c), so loadWidgets doesn't have to go to the disk for it
+typedef struct {
+	char filename[MAX_STRING_LENGTH];
+	cJSON *root;
+} ParsedWidgetFile;
+
+static ParsedWidgetFile parsedWidgetFiles[MAX_PARSED_WIDGET_FILES];
+static int parsedWidgetFileCount = 0;
+
 static const int SELECTION_ARROW_OFFSET = 20;
 static const int CURSOR_BLINK_OFFSET = 0;
 
@@ -199,6 +214,8 @@ void updateWidgets(char *groupName) {
 //draws all widgets currently in the list
 //pass in NULL as the groupName to draw every widget
 void drawWidgets(char *groupName) {
+	setRenderLayer(RL_UI);
+
 	for (Widget *widget = widgetHead; widget != NULL; widget = widget->next) {
 		//only draw widgets in the current group
 		if (groupName == NULL || strcmp(groupName, widget->groupName) == 0) {
@@ -231,13 +248,13 @@ void drawWidgets(char *groupName) {
 			if (widget == app.activeWidget) {
 				switch (widget->textAlignHorz) {
 				case(TAH_LEFT):
-					blitAndUpdateSpriteAnimated(selectionArrow, widget->x - SELECTION_ARROW_OFFSET, widget->y - 2);
+					blitSpriteAnimated(selectionArrow, widget->x - SELECTION_ARROW_OFFSET, widget->y - 2);
 					break;
 				case(TAH_CENTER):
-					blitAndUpdateSpriteAnimated(selectionArrow, widget->x - widget->w * 0.5 - SELECTION_ARROW_OFFSET, widget->y - 2);
+					blitSpriteAnimated(selectionArrow, widget->x - widget->w * 0.5 - SELECTION_ARROW_OFFSET, widget->y - 2);
 					break;
 				case(TAH_RIGHT):
-					blitAndUpdateSpriteAnimated(selectionArrow, widget->x - widget->w - SELECTION_ARROW_OFFSET, widget->y - 2);
+					blitSpriteAnimated(selectionArrow, widget->x - widget->w - SELECTION_ARROW_OFFSET, widget->y - 2);
 					break;
 				}
 			}
@@ -323,9 +340,48 @@ void closeWidgets(void) {
 	deleteWidgets();
 
 	//free sprites
-	free(selectionArrow);
+	deleteSpriteAnimated(selectionArrow);
 	free(sliderBarWhite);
 	free(sliderBarBlue);
+
+	//free widget files that were parsed ahead of time
+	for (int i = 0; i < parsedWidgetFileCount; ++i)
+		cJSON_Delete(parsedWidgetFiles[i].root);
+	parsedWidgetFileCount = 0;
+}
+
+//reads and parses a widget file without creating any widgets from it
+//doesn't touch any widget state, so it's safe to call from another thread; hand the result to addParsedWidgetFile on the main thread
+//returns NULL if the file couldn't be read or parsed
+cJSON *parseWidgetFile(char *filename) {
+	char *text = readFile(filename);
+	if (text == NULL)
+		return NULL;
+
+	cJSON *root = cJSON_Parse(text);
+	free(text);
+
+	if (root == NULL)
+		printf("WARNING - Widget file '%s' could not be parsed.\n", filename);
+
+	return root;
+}
+
+//keeps a parsed widget file around so that loadWidgets can use it instead of reading the file again
+//the widget system takes ownership of "root" (it's freed in closeWidgets)
+void addParsedWidgetFile(char *filename, cJSON *root) {
+	if (root == NULL)
+		return;
+
+	if (parsedWidgetFileCount >= MAX_PARSED_WIDGET_FILES) {
+		printf("WARNING - Out of room for parsed widget files. Raise MAX_PARSED_WIDGET_FILES.\n");
+		cJSON_Delete(root);
+		return;
+	}
+
+	STRNCPY(parsedWidgetFiles[parsedWidgetFileCount].filename, filename, MAX_STRING_LENGTH);
+	parsedWidgetFiles[parsedWidgetFileCount].root = root;
+	++parsedWidgetFileCount;
 }
 
 //loads a set of widgets from a JSON file
@@ -334,14 +390,22 @@ void closeWidgets(void) {
 //also you have no access to important positional variables like camera position or screen width and height from within a JSON file
 //TODO: look into initializing widgets purely programmatically from a function, instead of this half-JSON half-programmatic weirdness
 void loadWidgets(char *filename) {
-	cJSON *root, *node;
-	char *text;
+	cJSON *root = NULL, *node;
+	char *text = NULL;
 
-	//get JSON as text
-	text = readFile(filename);
+	//use the file's parsed copy if it was loaded ahead of time
+	for (int i = 0; i < parsedWidgetFileCount; ++i) {
+		if (strcmp(parsedWidgetFiles[i].filename, filename) == 0)
+			root = parsedWidgetFiles[i].root;
+	}
 
-	//translate JSON text into a cJSON object
-	root = cJSON_Parse(text);
+	if (root == NULL) {
+		//get JSON as text
+		text = readFile(filename);
+
+		//translate JSON text into a cJSON object
+		root = cJSON_Parse(text);
+	}
 
 	//widgets are stored as a cJSON array; iterate through that array
 	//"root" is a cJSON array of cJSON objects (the widgets themselves)
@@ -350,9 +414,11 @@ void loadWidgets(char *filename) {
 		createWidget(node);
 	}
 
-	//clean up cJSON object and text buffer
-	cJSON_Delete(root);
-	free(text);
+	//clean up cJSON object and text buffer (parsed copies are kept until closeWidgets)
+	if (text != NULL) {
+		cJSON_Delete(root);
+		free(text);
+	}
 
 	//avoid a click sound when widgets load in
 	lastActiveWidget = app.activeWidget;
@@ -539,14 +605,15 @@ static void focusTextInputWidget(void) {
 	if (currentTextLength > 0 && input.backspacePressed > 0) {
 		input.backspacePressed = 0;	//reset backspace to make sure it doesn't activate on the next frame
 
-		--currentTextLength;	//decrement current text length, as we're removing a character
+		//text is UTF-8, so the last character might be more than one byte
+		currentTextLength = findUTF8Boundary(textInputWidget->text, currentTextLength - 1);
 		textInputWidget->text[currentTextLength] = '\0';	//remove a character from the end of the string
 	}
 
 	//clamp length of text the user has entered this frame to ensure the user can't enter more characters than the text input widget allows for
-	//the - 1 is to account for the null terminator
+	//maxLength is in bytes, and anything that doesn't fit gets cut off between characters
 	if (inputTextLength + currentTextLength > textInputWidget->maxLength)
-		inputTextLength = textInputWidget->maxLength - currentTextLength;
+		inputTextLength = findUTF8Boundary(input.inputText, textInputWidget->maxLength - currentTextLength);
 	
 	//append input.inputText onto textInputWidget->text
 	if (inputTextLength > 0) {
@@ -729,18 +796,18 @@ static void drawSliderWidget(Widget *widget) {
 
 		//draw slider bar
 		blitSpriteStatic(sliderBarWhite, sliderWidget->x, sliderWidget->y);
-		SDL_SetRenderDrawBlendMode(app.renderer, SDL_BLENDMODE_NONE);
-		SDL_SetRenderDrawColor(app.renderer, PALETTE_WHITE.r, PALETTE_WHITE.g, PALETTE_WHITE.b, 255);
-		SDL_RenderFillRect(app.renderer, &sliderBarFiller);
+		setRenderLayer(RL_UI_DETAIL);
+		drawFilledRect(&sliderBarFiller, (SDL_Color){PALETTE_WHITE.r, PALETTE_WHITE.g, PALETTE_WHITE.b, 255});
+		setRenderLayer(RL_UI);
 	} else {
 		//draw all other widgets in blue
 		drawTextDropShadow(widget->text, widget->x, widget->y, PALETTE_LIGHT_BLUE, widget->textAlignHorz, 0, PALETTE_BLACK, 1);
 	
 		//draw slider bar
 		blitSpriteStatic(sliderBarBlue, sliderWidget->x, sliderWidget->y);
-		SDL_SetRenderDrawBlendMode(app.renderer, SDL_BLENDMODE_NONE);
-		SDL_SetRenderDrawColor(app.renderer, PALETTE_LIGHT_BLUE.r, PALETTE_LIGHT_BLUE.g, PALETTE_LIGHT_BLUE.b, 255);
-		SDL_RenderFillRect(app.renderer, &sliderBarFiller);
+		setRenderLayer(RL_UI_DETAIL);
+		drawFilledRect(&sliderBarFiller, (SDL_Color){PALETTE_LIGHT_BLUE.r, PALETTE_LIGHT_BLUE.g, PALETTE_LIGHT_BLUE.b, 255});
+		setRenderLayer(RL_UI);
 	}
 }
 
@@ -788,6 +855,9 @@ void loadPreferences(void) {
 		app.preferences.fullscreen = true;
 		app.preferences.soundVolume = 5;
 		app.preferences.musicVolume = 5;
+		app.preferences.quality = GQ_HIGH;
+		app.preferences.integerScaling = true;
+		app.preferences.postProcess = false;
 		return;
 	}
 
@@ -799,6 +869,14 @@ void loadPreferences(void) {
 		app.preferences.fullscreen = cJSON_GetObjectItem(root, "fullscreen")->valueint;
 		app.preferences.soundVolume = cJSON_GetObjectItem(root, "soundVolume")->valueint;
 		app.preferences.musicVolume = cJSON_GetObjectItem(root, "musicVolume")->valueint;
+
+		//older preference files don't have these
+		cJSON *quality = cJSON_GetObjectItem(root, "quality");
+		app.preferences.quality = quality != NULL ? quality->valueint : GQ_HIGH;
+		cJSON *integerScaling = cJSON_GetObjectItem(root, "integerScaling");
+		app.preferences.integerScaling = integerScaling != NULL ? integerScaling->valueint : true;
+		cJSON *postProcess = cJSON_GetObjectItem(root, "postProcess");
+		app.preferences.postProcess = postProcess != NULL ? postProcess->valueint : false;
 	}
 
 	//clean up cJSON object and text buffer
@@ -824,6 +902,9 @@ void savePreferences(void) {
 		cJSON_AddNumberToObject(obj, "fullscreen", app.preferences.fullscreen);
 		cJSON_AddNumberToObject(obj, "soundVolume", app.preferences.soundVolume);
 		cJSON_AddNumberToObject(obj, "musicVolume", app.preferences.musicVolume);
+		cJSON_AddNumberToObject(obj, "quality", app.preferences.quality);
+		cJSON_AddNumberToObject(obj, "integerScaling", app.preferences.integerScaling);
+		cJSON_AddNumberToObject(obj, "postProcess", app.preferences.postProcess);
 		
 		char *text = cJSON_Print(obj);
 		fprintf(save, text);
@@ -81,6 +81,8 @@ Widget *getWidget(char *name, char *groupName);
 void deleteWidgets(void);
 void closeWidgets(void);
 void loadWidgets(char *filename);
+struct cJSON *parseWidgetFile(char *filename);
+void addParsedWidgetFile(char *filename, struct cJSON *root);
 
 void loadPreferences(void);
 void savePreferences(void);
@@ -0,0 +1,438 @@
+/*
+* Offline sprite atlas packer.
+* Reads a sprite list (tools/atlasSprites.json) that points at cells on a source sprite sheet, trims the empty space around each sprite,
+* packs them into a smaller atlas, and writes a C header with each sprite's rectangle, pivot, frame count and animation settings,
+* so the game never has to look sprites up or work out their pivots at runtime.
+*
+* Trimming never moves a sprite's pivot relative to its art: axes the pivot is centered on get trimmed equally from both sides,
+* and axes the pivot is on an edge of only get trimmed from the far side. Sprites in the same group (e.g. a crate and its hitflash)
+* all get trimmed the same, so they still line up when drawn on top of each other.
+*
+* Build it against the same SDL2 and SDL2_image the game uses, plus src/json/cJSON.c, e.g.
+*     cl tools\atlasPacker.c src\json\cJSON.c /I<SDL2 include> /I<SDL2_image include> SDL2.lib SDL2_image.lib
+* then run it from the project folder (the one gfx/ is in):
+*     atlasPacker tools/atlasSprites.json
+* Rerun it whenever the source sheet or the sprite list changes, and commit the atlas and header it makes along with them.
+*/
+
+#define SDL_MAIN_HANDLED
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+#include "SDL_image.h"
+
+#include "../src/json/cJSON.h"
+
+//max number of sprites in a sprite list
+#define MAX_SPRITES 128
+//max length of a sprite's name or group
+#define MAX_NAME_LENGTH 64
+
+//a sprite from the sprite list, and where it ends up
+typedef struct {
+	char name[MAX_NAME_LENGTH];
+	char group[MAX_NAME_LENGTH];	//empty if the sprite isn't in a group
+	char pivot[MAX_NAME_LENGTH];	//a SpriteCenter
+	char loop[MAX_NAME_LENGTH];		//an AnimationLoop
+	int srcX;		//first frame on the source sheet, in pixels
+	int srcY;
+	int srcW;		//one frame on the source sheet, in pixels
+	int srcH;
+	int frames;
+	float spd;
+	bool trim;
+	SDL_Rect opaque;	//the smallest rectangle that holds every non-transparent pixel of every frame, relative to the top left of a frame
+	SDL_Rect trimmed;	//what's kept of each frame after trimming, relative to the top left of a frame
+	int pivotX;			//relative to the top left of the trimmed frame
+	int pivotY;
+	int x;				//where the first trimmed frame goes in the atlas
+	int y;
+} PackedSprite;
+
+static char *readTextFile(char *filename);
+static bool loadSpriteList(char *filename);
+static bool findOpaqueRect(PackedSprite *sprite);
+static bool trimSprites(void);
+static void trimAxis(int pivot, int size, int opaqueStart, int opaqueSize, int *start, int *trimmedSize, int *pivotOut);
+static int getPivotAlignment(const char *pivot, bool horizontal);
+static int compareSpriteHeights(const void *a, const void *b);
+static int packSprites(int atlasW);
+static bool writeAtlas(void);
+static bool writeHeader(void);
+
+static const int PADDING = 1;		//empty pixels between sprites, and along the atlas's right and bottom edges
+static const int MIN_ATLAS_W = 64;
+static const int MAX_ATLAS_W = 4096;
+
+static PackedSprite sprites[MAX_SPRITES];
+static PackedSprite *order[MAX_SPRITES];	//sprites from tallest to shortest, which is the order they get packed in
+static int spriteCount = 0;
+
+static SDL_Surface *source = NULL;
+static int cellW = 16;
+static int cellH = 16;
+static char atlasFilename[FILENAME_MAX];
+static char headerFilename[FILENAME_MAX];
+static char listFilename[FILENAME_MAX];
+static int atlasW = 0;
+static int atlasH = 0;
+
+int main(int argc, char *argv[]) {
+	if (argc < 2) {
+		printf("Usage: atlasPacker <sprite list .json>\n");
+		return 1;
+	}
+
+	if (IMG_Init(IMG_INIT_PNG) == 0) {
+		printf("ERROR - Couldn't initialize SDL_image: %s\n", IMG_GetError());
+		return 1;
+	}
+
+	bool success = loadSpriteList(argv[1]) && trimSprites();
+
+	//try every power of 2 width and keep whichever wastes the least space
+	if (success) {
+		int bestArea = 0;
+
+		for (int w = MIN_ATLAS_W; w <= MAX_ATLAS_W; w *= 2) {
+			int h = packSprites(w);
+			if (h > 0 && (bestArea == 0 || w * h < bestArea)) {
+				bestArea = w * h;
+				atlasW = w;
+			}
+		}
+
+		if (atlasW == 0) {
+			printf("ERROR - Sprites don't fit in a %d pixel wide atlas.\n", MAX_ATLAS_W);
+			success = false;
+		}
+		else
+			atlasH = packSprites(atlasW);
+	}
+
+	success = success && writeAtlas() && writeHeader();
+
+	if (success)
+		printf("Packed %d sprites from a %dx%d sheet into a %dx%d atlas.\n", spriteCount, source->w, source->h, atlasW, atlasH);
+
+	if (source != NULL)
+		SDL_FreeSurface(source);
+	IMG_Quit();
+
+	return success ? 0 : 1;
+}
+
+//reads a whole file into a null-terminated string (free it when done)
+static char *readTextFile(char *filename) {
+	FILE *file = fopen(filename, "rb");
+	if (file == NULL)
+		return NULL;
+
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	char *text = calloc(length + 1, 1);
+	if (text != NULL)
+		fread(text, 1, length, file);
+	fclose(file);
+
+	return text;
+}
+
+//reads the sprite list and loads the sheet it points at
+static bool loadSpriteList(char *filename) {
+	char *text = readTextFile(filename);
+	if (text == NULL) {
+		printf("ERROR - Sprite list '%s' could not be read.\n", filename);
+		return false;
+	}
+
+	cJSON *root = cJSON_Parse(text);
+	free(text);
+	if (root == NULL) {
+		printf("ERROR - Sprite list '%s' isn't valid JSON.\n", filename);
+		return false;
+	}
+
+	strncpy(listFilename, filename, FILENAME_MAX - 1);
+	strncpy(atlasFilename, cJSON_GetObjectItem(root, "atlas")->valuestring, FILENAME_MAX - 1);
+	strncpy(headerFilename, cJSON_GetObjectItem(root, "header")->valuestring, FILENAME_MAX - 1);
+	cellW = cJSON_GetObjectItem(root, "cellW")->valueint;
+	cellH = cJSON_GetObjectItem(root, "cellH")->valueint;
+
+	//convert the sheet to a known format so alpha is always the 4th byte of a pixel
+	char *sourceFilename = cJSON_GetObjectItem(root, "source")->valuestring;
+	SDL_Surface *loaded = IMG_Load(sourceFilename);
+	if (loaded != NULL) {
+		source = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+		SDL_FreeSurface(loaded);
+	}
+
+	if (source == NULL) {
+		printf("ERROR - Sheet '%s' could not be loaded: %s\n", sourceFilename, IMG_GetError());
+		cJSON_Delete(root);
+		return false;
+	}
+
+	//optional members fall back to a single frame with no animation, no group, a centered pivot and trimming on
+	for (cJSON *node = cJSON_GetObjectItem(root, "sprites")->child; node != NULL; node = node->next) {
+		if (spriteCount >= MAX_SPRITES) {
+			printf("ERROR - Too many sprites in the sprite list. Raise MAX_SPRITES.\n");
+			cJSON_Delete(root);
+			return false;
+		}
+
+		PackedSprite *sprite = &sprites[spriteCount];
+		cJSON *item;
+		memset(sprite, 0, sizeof(PackedSprite));
+
+		strncpy(sprite->name, cJSON_GetObjectItem(node, "name")->valuestring, MAX_NAME_LENGTH - 1);
+		sprite->srcX = cJSON_GetObjectItem(node, "x")->valueint * cellW;
+		sprite->srcY = cJSON_GetObjectItem(node, "y")->valueint * cellH;
+		sprite->srcW = cJSON_GetObjectItem(node, "w")->valueint * cellW;
+		sprite->srcH = cJSON_GetObjectItem(node, "h")->valueint * cellH;
+
+		item = cJSON_GetObjectItem(node, "pivot");
+		strncpy(sprite->pivot, item != NULL ? item->valuestring : "SC_CENTER", MAX_NAME_LENGTH - 1);
+		item = cJSON_GetObjectItem(node, "loop");
+		strncpy(sprite->loop, item != NULL ? item->valuestring : "AL_ONESHOT", MAX_NAME_LENGTH - 1);
+		item = cJSON_GetObjectItem(node, "group");
+		if (item != NULL)
+			strncpy(sprite->group, item->valuestring, MAX_NAME_LENGTH - 1);
+		item = cJSON_GetObjectItem(node, "frames");
+		sprite->frames = item != NULL ? item->valueint : 1;
+		item = cJSON_GetObjectItem(node, "spd");
+		sprite->spd = item != NULL ? (float)item->valuedouble : 0;
+		item = cJSON_GetObjectItem(node, "trim");
+		sprite->trim = item == NULL || item->type == cJSON_True;
+
+		if (getPivotAlignment(sprite->pivot, true) < 0) {
+			printf("ERROR - Sprite '%s' has an unknown pivot '%s'.\n", sprite->name, sprite->pivot);
+			cJSON_Delete(root);
+			return false;
+		}
+		if (sprite->srcX + sprite->srcW * sprite->frames > source->w || sprite->srcY + sprite->srcH > source->h) {
+			printf("ERROR - Sprite '%s' goes past the edge of the sheet.\n", sprite->name);
+			cJSON_Delete(root);
+			return false;
+		}
+
+		order[spriteCount] = sprite;
+		++spriteCount;
+	}
+
+	cJSON_Delete(root);
+
+	return true;
+}
+
+//finds the part of a sprite that isn't transparent in any of its frames
+//returns false if every frame is completely transparent
+static bool findOpaqueRect(PackedSprite *sprite) {
+	int left = sprite->srcW, top = sprite->srcH, right = -1, bottom = -1;
+
+	for (int frame = 0; frame < sprite->frames; ++frame) {
+		for (int y = 0; y < sprite->srcH; ++y) {
+			const Uint8 *row = (const Uint8 *)source->pixels + (sprite->srcY + y) * source->pitch + (sprite->srcX + frame * sprite->srcW) * 4;
+
+			for (int x = 0; x < sprite->srcW; ++x) {
+				if (row[x * 4 + 3] == 0)
+					continue;
+
+				left = SDL_min(left, x);
+				right = SDL_max(right, x);
+				top = SDL_min(top, y);
+				bottom = SDL_max(bottom, y);
+			}
+		}
+	}
+
+	if (right < 0)
+		return false;
+
+	sprite->opaque = (SDL_Rect){ left, top, right - left + 1, bottom - top + 1 };
+
+	return true;
+}
+
+//works out how much of each sprite to keep, and where its pivot ends up
+static bool trimSprites(void) {
+	for (int i = 0; i < spriteCount; ++i) {
+		PackedSprite *sprite = &sprites[i];
+
+		//fully transparent or untrimmed sprites keep every pixel
+		if (!sprite->trim || !findOpaqueRect(sprite))
+			sprite->opaque = (SDL_Rect){ 0, 0, sprite->srcW, sprite->srcH };
+	}
+
+	for (int i = 0; i < spriteCount; ++i) {
+		PackedSprite *sprite = &sprites[i];
+		SDL_Rect opaque = sprite->opaque;
+
+		//a group is trimmed down to what all of its sprites need
+		for (int j = 0; j < spriteCount && sprite->group[0] != '\0'; ++j) {
+			if (strcmp(sprites[j].group, sprite->group) != 0)
+				continue;
+
+			if (sprites[j].srcW != sprite->srcW || sprites[j].srcH != sprite->srcH || strcmp(sprites[j].pivot, sprite->pivot) != 0) {
+				printf("ERROR - Sprites '%s' and '%s' are in the same group, but aren't the same size or don't have the same pivot.\n", sprite->name, sprites[j].name);
+				return false;
+			}
+
+			SDL_UnionRect(&opaque, &sprites[j].opaque, &opaque);
+		}
+
+		trimAxis(getPivotAlignment(sprite->pivot, true), sprite->srcW, opaque.x, opaque.w, &sprite->trimmed.x, &sprite->trimmed.w, &sprite->pivotX);
+		trimAxis(getPivotAlignment(sprite->pivot, false), sprite->srcH, opaque.y, opaque.h, &sprite->trimmed.y, &sprite->trimmed.h, &sprite->pivotY);
+	}
+
+	return true;
+}
+
+//trims one axis of a sprite without moving its pivot relative to its art
+//pivot is 0 for the start of the axis, 1 for the middle and 2 for the end
+static void trimAxis(int pivot, int size, int opaqueStart, int opaqueSize, int *start, int *trimmedSize, int *pivotOut) {
+	int emptyStart = opaqueStart;
+	int emptyEnd = size - opaqueStart - opaqueSize;
+
+	switch (pivot) {
+	case(0):
+		emptyStart = 0;
+		break;
+	case(1):
+		emptyStart = emptyEnd = SDL_min(emptyStart, emptyEnd);
+		break;
+	default:
+		emptyEnd = 0;
+		break;
+	}
+
+	*start = emptyStart;
+	*trimmedSize = size - emptyStart - emptyEnd;
+	*pivotOut = *trimmedSize * pivot / 2;
+}
+
+//returns 0, 1 or 2 for a SpriteCenter's left/center/right (or top/center/bottom) alignment, or -1 if it isn't a SpriteCenter
+static int getPivotAlignment(const char *pivot, bool horizontal) {
+	static const char *PIVOTS[] = {
+		"SC_TOP_LEFT", "SC_TOP_CENTER", "SC_TOP_RIGHT",
+		"SC_CENTER_LEFT", "SC_CENTER", "SC_CENTER_RIGHT",
+		"SC_BOTTOM_LEFT", "SC_BOTTOM_CENTER", "SC_BOTTOM_RIGHT"
+	};
+
+	for (int i = 0; i < 9; ++i) {
+		if (strcmp(pivot, PIVOTS[i]) == 0)
+			return horizontal ? i % 3 : i / 3;
+	}
+
+	return -1;
+}
+
+//for sorting sprites from tallest to shortest, then widest to narrowest
+static int compareSpriteHeights(const void *a, const void *b) {
+	const PackedSprite *spriteA = *(const PackedSprite **)a;
+	const PackedSprite *spriteB = *(const PackedSprite **)b;
+
+	if (spriteA->trimmed.h != spriteB->trimmed.h)
+		return spriteB->trimmed.h - spriteA->trimmed.h;
+
+	return spriteB->trimmed.w * spriteB->frames - spriteA->trimmed.w * spriteA->frames;
+}
+
+//lays sprites out in rows (each row is as tall as the first sprite in it), with every frame of a sprite next to each other
+//returns how tall the atlas needs to be, or 0 if a sprite is wider than the atlas
+static int packSprites(int w) {
+	int x = PADDING, y = PADDING, rowH = 0;
+
+	qsort(order, spriteCount, sizeof(PackedSprite *), compareSpriteHeights);
+
+	for (int i = 0; i < spriteCount; ++i) {
+		PackedSprite *sprite = order[i];
+		int spriteW = sprite->trimmed.w * sprite->frames;
+
+		if (PADDING + spriteW + PADDING > w)
+			return 0;
+
+		if (x + spriteW + PADDING > w) {
+			x = PADDING;
+			y += rowH + PADDING;
+			rowH = 0;
+		}
+
+		sprite->x = x;
+		sprite->y = y;
+		x += spriteW + PADDING;
+		rowH = SDL_max(rowH, sprite->trimmed.h);
+	}
+
+	return y + rowH + PADDING;
+}
+
+//copies the trimmed frames into a new image and saves it
+static bool writeAtlas(void) {
+	SDL_Surface *atlas = SDL_CreateRGBSurfaceWithFormat(0, atlasW, atlasH, 32, SDL_PIXELFORMAT_RGBA32);
+	if (atlas == NULL) {
+		printf("ERROR - Atlas surface could not be created: %s\n", SDL_GetError());
+		return false;
+	}
+
+	SDL_FillRect(atlas, NULL, 0);
+
+	for (int i = 0; i < spriteCount; ++i) {
+		const PackedSprite *sprite = &sprites[i];
+
+		for (int frame = 0; frame < sprite->frames; ++frame) {
+			for (int y = 0; y < sprite->trimmed.h; ++y) {
+				const Uint8 *src = (const Uint8 *)source->pixels + (sprite->srcY + sprite->trimmed.y + y) * source->pitch + (sprite->srcX + frame * sprite->srcW + sprite->trimmed.x) * 4;
+				Uint8 *dest = (Uint8 *)atlas->pixels + (sprite->y + y) * atlas->pitch + (sprite->x + frame * sprite->trimmed.w) * 4;
+				memcpy(dest, src, sprite->trimmed.w * 4);
+			}
+		}
+	}
+
+	bool success = IMG_SavePNG(atlas, atlasFilename) == 0;
+	if (!success)
+		printf("ERROR - Atlas could not be saved to '%s': %s\n", atlasFilename, IMG_GetError());
+
+	SDL_FreeSurface(atlas);
+
+	return success;
+}
+
+//writes the sprite table header
+//sprites are listed in the same order as in the sprite list, so ids don't move around when the packing does
+static bool writeHeader(void) {
+	FILE *file = fopen(headerFilename, "w");
+	if (file == NULL) {
+		printf("ERROR - Header could not be written to '%s'.\n", headerFilename);
+		return false;
+	}
+
+	fprintf(file, "//generated by tools/atlasPacker.c from %s\n", listFilename);
+	fprintf(file, "//don't edit this by hand; change the sprite list or the source sheet and rerun the packer instead\n\n");
+	fprintf(file, "#ifndef SPRITE_TABLE_H\n#define SPRITE_TABLE_H\n\n");
+	fprintf(file, "#define SPRITE_TABLE_ATLAS \"%s\"\t//every sprite in the table is on this atlas\n\n", atlasFilename);
+
+	fprintf(file, "//SPR stands for sprite\ntypedef enum {\n");
+	for (int i = 0; i < spriteCount; ++i)
+		fprintf(file, "\tSPR_%s,\n", sprites[i].name);
+	fprintf(file, "\n\tSPR_MAX\n} SpriteId;\n\n");
+
+	fprintf(file, "//x, y, w, h, pivotX, pivotY, frames, spd, loopBehavior\n");
+	fprintf(file, "static const SpriteDef SPRITE_TABLE[SPR_MAX] = {\n");
+	for (int i = 0; i < spriteCount; ++i) {
+		const PackedSprite *sprite = &sprites[i];
+		fprintf(file, "\t[SPR_%s] = { %d, %d, %d, %d, %d, %d, %d, %g, %s },\n", sprite->name, sprite->x, sprite->y, sprite->trimmed.w, sprite->trimmed.h,
+			sprite->pivotX, sprite->pivotY, sprite->frames, sprite->spd, sprite->loop);
+	}
+	fprintf(file, "};\n\n#endif");
+
+	fclose(file);
+
+	return true;
+}
\ No newline at end of file